@@ -62,7 +62,7 @@ Target Device: cc23xx
 //gapBondOOBData_t localOobData;
 //gapBondOOBData_t remoteOobData;
 
-static void SimpleGatt_changeCB( uint8_t paramId );
+static void SimpleGatt_changeCB( uint16_t connHandle, uint8_t paramId );
 void SimpleGatt_notifyChar4();
 
 // Simple GATT Profile Callbacks
@@ -81,11 +81,12 @@ static SimpleGattProfile_CBs_t simpleGatt_profileCBs =
  * @brief   Callback from Simple Profile indicating a characteristic
  *          value change.
  *
+ * @param   connHandle - connection the value was written on.
  * @param   paramId - parameter Id of the value that was changed.
  *
  * @return  None.
  */
-static void SimpleGatt_changeCB( uint8_t paramId )
+static void SimpleGatt_changeCB( uint16_t connHandle, uint8_t paramId )
 {
 //  uint8_t newValue = 0;
     uint8_t newValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
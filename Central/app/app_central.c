@@ -73,6 +73,58 @@ Target Device: cc23xx
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
 #include <ti/bleapp/profiles/simple_gatt/simple_gatt_profile.h>
+#include <ti/drivers/dpl/ClockP.h>
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define CENTRAL_NUM_PEERS           ((uint8)(sizeof(centralPeerAddrs) / B_ADDR_LEN))
+#define CENTRAL_PEER_NONE           0xFF
+
+// Connection state of a peer of the set
+#define CENTRAL_PEER_IDLE           0
+#define CENTRAL_PEER_CONNECTING     1
+#define CENTRAL_PEER_CONNECTED      2
+#define CENTRAL_PEER_AUTHENTICATED  3
+
+// Time allowed to the connection attempt of one peer, in ms
+#define CENTRAL_CONNECT_TIMEOUT     3000
+
+// Upper bounds (ms) of the time-to-connect histogram bins, the last bin
+// takes the longer connections
+#define CENTRAL_CONN_TIME_BINS      { 50, 100, 200, 500, 1000, 2000 }
+#define CENTRAL_NUM_CONN_TIME_BINS  7
+
+// Scan filter the host wakeups are counted for
+#define CENTRAL_SCAN_FLT_NONE       0
+#define CENTRAL_SCAN_FLT_AL         1
+#define CENTRAL_NUM_SCAN_FLT        2
+
+#if APP_OOB_IN_ADV_DATA
+// OOB values found so far in the advertising/scan response data of a peer
+#define CENTRAL_OOB_CONFIRM_FOUND   BV(0)
+#define CENTRAL_OOB_RANDOM_FOUND    BV(1)
+#define CENTRAL_OOB_ALL_FOUND       (CENTRAL_OOB_CONFIRM_FOUND | CENTRAL_OOB_RANDOM_FOUND)
+#if APP_CONNECT_ACCEPT_LIST
+// The initiator passes no report to the host, a scan this long (10ms)
+// collects the OOB data of the peers before it starts
+#define CENTRAL_OOB_SCAN_DURATION   100
+#endif
+#endif
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Peer of the set, in the order of APP_PEER_ADDR_LIST
+typedef struct
+{
+    uint16_t connHandle;
+    uint8_t  state;             // CENTRAL_PEER_xxx
+    uint32_t searchStartTick;   // Since when the peer is looked for
+#if APP_OOB_IN_ADV_DATA
+    uint8_t  oobFound;          // CENTRAL_OOB_xxx_FOUND
+    uint8_t  oobNumReports;     // Reports received while waiting for the OOB data
+    gapBondOOBData_t oob;
+#endif
+}Central_peer_t;
 //*****************************************************************************
 //! Prototypes
 //*****************************************************************************
@@ -80,6 +132,24 @@ Target Device: cc23xx
 void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Central_addScanRes(GapScan_Evt_AdvRpt_t *pScanRpt);
 void Central_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+static uint8 Central_findPeer(uint8_t *pAddr);
+static uint8 Central_findPeerByHandle(uint16_t connHandle);
+#if !APP_CONNECT_ACCEPT_LIST
+static void Central_connectPeer(uint8 peerIdx, bleStk_GapScan_Evt_AdvRpt_t *pScanRpt);
+#endif
+static void Central_startSet(void);
+static void Central_resume(void);
+static void Central_recordConnectTime(uint8 peerIdx);
+static void Central_printWakeups(void);
+#if APP_SCAN_FILTER_ACCEPT_LIST || APP_CONNECT_ACCEPT_LIST
+static bStatus_t Central_loadAcceptList(void);
+#endif
+#if APP_OOB_IN_ADV_DATA
+static uint8 Central_captureOobFromAdv(Central_peer_t *pPeer, bleStk_GapScan_Evt_AdvRpt_t *pScanRpt);
+#if APP_CONNECT_ACCEPT_LIST
+static uint8 Central_isOobMissing(void);
+#endif
+#endif
 
 //*****************************************************************************
 //! Globals
@@ -88,7 +158,8 @@ BLEAppUtil_EventHandler_t centralConnHandler =
 {
     .handlerType    = BLEAPPUTIL_GAP_CONN_TYPE,
     .pEventHandler  = Central_GAPConnEventHandler,
-    .eventMask      = BLEAPPUTIL_LINK_ESTABLISHED_EVENT,
+    .eventMask      = BLEAPPUTIL_LINK_ESTABLISHED_EVENT |
+                      BLEAPPUTIL_LINK_TERMINATED_EVENT,
 };
 // Events handlers struct, contains the handlers and event masks
 // of the application central role module
@@ -130,13 +201,22 @@ const BLEAppUtil_ScanInit_t centralScanInitParams =
 
     /*! Opt SCAN_FLT_POLICY_ALL | SCAN_FLT_POLICY_AL |   */
     /*! SCAN_FLT_POLICY_ALL_RPA | SCAN_FLT_POLICY_AL_RPA */
+    // Central_toggleScanFilter switches to the other policy
+#if APP_SCAN_FILTER_ACCEPT_LIST
+    .fltPolicy                  = SCAN_FLT_POLICY_AL,
+#else
     .fltPolicy                  = SCANNER_FILTER_POLICY,
+#endif
 
     /*! For more filter PDU @ref Gap_scanner.h */
     .fltPduType                 = SCANNER_FILTER_PDU_TYPE,
 
     /*! Opt SCAN_FLT_RSSI_ALL | SCAN_FLT_RSSI_NONE */
+#if APP_SCAN_FILTER_ACCEPT_LIST
+    .fltMinRssi                 = APP_SCAN_MIN_RSSI,
+#else
     .fltMinRssi                 = SCANNER_FILTER_MIN_RSSI,
+#endif
 
     /*! Opt SCAN_FLT_DISC_NONE | SCAN_FLT_DISC_GENERAL | SCAN_FLT_DISC_LIMITED
      *  | SCAN_FLT_DISC_ALL | SCAN_FLT_DISC_DISABLE */
@@ -153,9 +233,10 @@ const BLEAppUtil_ConnParams_t centralConnInitParams =
 
     .scanInterval          = INIT_PHYPARAM_SCAN_INT,      /* Units of 0.625ms */
     .scanWindow            = INIT_PHYPARAM_SCAN_WIN,      /* Units of 0.625ms */
-    .minConnInterval       = INIT_PHYPARAM_MIN_CONN_INT,  /* Units of 1.25ms  */
-    .maxConnInterval       = INIT_PHYPARAM_MAX_CONN_INT,  /* Units of 1.25ms  */
-    .connLatency           = INIT_PHYPARAM_CONN_LAT,
+    // Connect with the handshake profile, see Connection_setParamProfile
+    .minConnInterval       = APP_HANDSHAKE_CONN_INT,      /* Units of 1.25ms  */
+    .maxConnInterval       = APP_HANDSHAKE_CONN_INT,      /* Units of 1.25ms  */
+    .connLatency           = APP_HANDSHAKE_CONN_LAT,
     .supTimeout            = INIT_PHYPARAM_SUP_TO         /* Units of 10ms */
 };
 
@@ -173,9 +254,55 @@ const BLEAppUtil_ScanStart_t centralScanStartParams =
     .maxNumReport   = APP_MAX_NUM_OF_ADV_REPORTS
 };
 
+#if APP_OOB_IN_ADV_DATA && APP_CONNECT_ACCEPT_LIST
+// Single scan before the accept list initiator starts
+const BLEAppUtil_ScanStart_t centralOobScanStartParams =
+{
+    .scanPeriod     = 0,
+    .scanDuration   = CENTRAL_OOB_SCAN_DURATION, /* Units of 10ms */
+    .maxNumReport   = APP_MAX_NUM_OF_ADV_REPORTS
+};
+#endif
+
 static App_scanResults centralScanRes[APP_MAX_NUM_OF_ADV_REPORTS];
 static uint8 centralScanIndex = 0;
 gapBondOOBData_t localOobData;
+
+// Peers to connect and authenticate
+static const uint8_t centralPeerAddrs[][B_ADDR_LEN] = APP_PEER_ADDR_LIST;
+static Central_peer_t centralPeers[CENTRAL_NUM_PEERS];
+// Authenticated links stay up, a peer beyond the connection limit would
+// never be served. MAX_NUM_BLE_CONNS is 1 in the provided project.
+_Static_assert(CENTRAL_NUM_PEERS <= MAX_NUM_BLE_CONNS,
+               "APP_PEER_ADDR_LIST has more peers than connections, raise the number of connections in basic_ble.syscfg");
+// Peer with a connection attempt in progress, the controller
+// initiates one connection at a time
+static uint8 centralConnectingPeer = CENTRAL_PEER_NONE;
+// The initiator runs with the accept list filter policy
+static uint8 centralInitiating = FALSE;
+#if APP_OOB_IN_ADV_DATA && APP_CONNECT_ACCEPT_LIST
+// The OOB scan runs, or ran since the last link change
+static uint8 centralOobScanning = FALSE;
+static uint8 centralOobScanDone = FALSE;
+#endif
+// Set from the first scan until the whole set is authenticated
+static uint8 centralSetTiming = FALSE;
+static uint32_t centralSetStartTick = 0;
+// Host wakeups for advertising reports and scan time since boot, per
+// scan filter, so the filtered and unfiltered rates can be compared
+static uint8 centralScanFilter = APP_SCAN_FILTER_ACCEPT_LIST ? CENTRAL_SCAN_FLT_AL : CENTRAL_SCAN_FLT_NONE;
+static uint8 centralScanning = FALSE;
+static uint32_t centralScanStartTick = 0;
+static uint32_t centralNumReports[CENTRAL_NUM_SCAN_FLT];
+static uint32_t centralNumPeerReports[CENTRAL_NUM_SCAN_FLT];
+static uint32_t centralScanMs[CENTRAL_NUM_SCAN_FLT];
+// Time-to-connect distribution of the peers of the set
+static const uint16_t centralConnTimeBins[] = CENTRAL_CONN_TIME_BINS;
+static uint16_t centralConnTimeHist[CENTRAL_NUM_CONN_TIME_BINS];
+static uint16_t centralNumConnTimes = 0;
+static uint32_t centralConnTimeSumMs = 0;
+static uint32_t centralConnTimeMinMs = 0xFFFFFFFF;
+static uint32_t centralConnTimeMaxMs = 0;
 //*****************************************************************************
 //! Functions
 //*****************************************************************************
@@ -201,6 +328,16 @@ void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         case BLEAPPUTIL_SCAN_ENABLED:
         {
             centralScanIndex = 0;
+            centralScanning = TRUE;
+            centralScanStartTick = ClockP_getSystemTicks();
+
+#if !APP_CONNECT_ACCEPT_LIST
+            // The set timing starts with the first scan
+            if (!centralSetTiming)
+            {
+                Central_startSet();
+            }
+#endif
             MenuModule_printf(APP_MENU_SCAN_EVENT, 0, "Scan status: Scan started...");
 
             break;
@@ -209,23 +346,45 @@ void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         case BLEAPPUTIL_ADV_REPORT:
         {
             bleStk_GapScan_Evt_AdvRpt_t *pScanRpt = &scanMsg->pBuf->pAdvReport;
+
+            centralNumReports[centralScanFilter]++;
             if (pScanRpt->pData != NULL)
             {
-                if(pScanRpt->addr[0] == 0x96 && // 96
-                   pScanRpt->addr[1] == 0x5D && // 5D
-                   pScanRpt->addr[2] == 0x3C && // 3C
-                   pScanRpt->addr[3] == 0x93 &&
-                   pScanRpt->addr[4] == 0x72 &&
-                   pScanRpt->addr[5] == 0x84)
+                uint8 peerIdx = Central_findPeer(pScanRpt->addr);
+
+                if (peerIdx != CENTRAL_PEER_NONE)
+                {
+                    centralNumPeerReports[centralScanFilter]++;
+                }
+
+                if (peerIdx != CENTRAL_PEER_NONE &&
+                    centralPeers[peerIdx].state == CENTRAL_PEER_IDLE &&
+                    centralConnectingPeer == CENTRAL_PEER_NONE)
                 {
-                    BLEAppUtil_ConnectParams_t connParams =
+#if APP_OOB_IN_ADV_DATA
+                    Central_peer_t *pPeer = &centralPeers[peerIdx];
+
+#if APP_CONNECT_ACCEPT_LIST
+                    Central_captureOobFromAdv(pPeer, pScanRpt);
+                    // The initiator takes over once every missing peer sent its data
+                    if (centralOobScanning && !Central_isOobMissing())
+                    {
+                        BLEAppUtil_scanStop();
+                    }
+#else
+                    // Wait for the scan response carrying the random value, but
+                    // do not wait forever for a peer that does not advertise it
+                    if (Central_captureOobFromAdv(pPeer, pScanRpt) != CENTRAL_OOB_ALL_FOUND &&
+                        !(pScanRpt->evtType & ADV_RPT_EVT_TYPE_SCAN_RSP) &&
+                        ++pPeer->oobNumReports < 2)
                     {
-                      .peerAddrType = pScanRpt->addrType,
-                      .phys = INIT_PHY_1M,
-                      .timeout = 3000
-                    };
-                    memcpy(connParams.pPeerAddress, pScanRpt->addr, B_ADDR_LEN);
-                    bStatus_t status = BLEAppUtil_connect(&connParams);
+                        break;
+                    }
+#endif
+#endif
+#if !APP_CONNECT_ACCEPT_LIST
+                    Central_connectPeer(peerIdx, pScanRpt);
+#endif
                 }
             }
 
@@ -236,6 +395,10 @@ void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         {
             uint8 i;
 
+            centralScanMs[centralScanFilter] += (ClockP_getSystemTicks() - centralScanStartTick) *
+                                                ClockP_getSystemTickPeriod() / 1000;
+            centralScanning = FALSE;
+
             for(i = 0; i < APP_MAX_NUM_OF_ADV_REPORTS; i++)
             {
                 memset(&centralScanRes[i], 0, sizeof(App_scanResults));
@@ -256,6 +419,23 @@ void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                               "Num results: " MENU_MODULE_COLOR_YELLOW "%d " MENU_MODULE_COLOR_RESET,
                               scanMsg->pBuf->pScanDis.reason,
                               scanMsg->pBuf->pScanDis.numReport);
+            Central_printWakeups();
+
+#if !APP_CONNECT_ACCEPT_LIST
+            // Keep looking for the peers of the set that are still missing
+            if (centralSetTiming)
+            {
+                Central_resume();
+            }
+#elif APP_OOB_IN_ADV_DATA
+            // Connect with the OOB data collected so far
+            if (centralOobScanning)
+            {
+                centralOobScanning = FALSE;
+                centralOobScanDone = TRUE;
+                Central_resume();
+            }
+#endif
             break;
         }
 
@@ -267,6 +447,17 @@ void Central_ScanEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     }
 }
 
+/*********************************************************************
+ * @fn      Central_GAPConnEventHandler
+ *
+ * @brief   Track the connections of the peers of the set and start
+ *          the configuration of every new link
+ *
+ * @param   event - message event.
+ * @param   pMsgData - pointer to message data.
+ *
+ * @return  none
+ */
 void Central_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 {
     switch(event)
@@ -274,17 +465,76 @@ void Central_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         case BLEAPPUTIL_LINK_ESTABLISHED_EVENT:
         {
             gapEstLinkReqEvent_t *gapEstMsg = (gapEstLinkReqEvent_t *)pMsgData;
-            HCI_LE_SetDataLenCmd(0, 251, 2120);
+            uint8 peerIdx = Central_findPeer(gapEstMsg->devAddr);
 
-            bStatus_t status = GAPBondMgr_SCGetLocalOOBParameters(&localOobData);
+            if (centralConnectingPeer != CENTRAL_PEER_NONE)
+            {
+                // A failed attempt leaves the peer free for the next report
+                centralPeers[centralConnectingPeer].state = CENTRAL_PEER_IDLE;
+                centralConnectingPeer = CENTRAL_PEER_NONE;
+            }
+            centralInitiating = FALSE;
+#if APP_OOB_IN_ADV_DATA && APP_CONNECT_ACCEPT_LIST
+            centralOobScanDone = FALSE;
+#endif
+
+            if (gapEstMsg->hdr.status != SUCCESS)
+            {
+                Central_resume();
+                break;
+            }
+
+            if (peerIdx != CENTRAL_PEER_NONE)
+            {
+                centralPeers[peerIdx].state = CENTRAL_PEER_CONNECTED;
+                centralPeers[peerIdx].connHandle = gapEstMsg->connectionHandle;
+                Central_recordConnectTime(peerIdx);
+                Central_printWakeups();
+            }
+
+            HCI_LE_SetDataLenCmd(gapEstMsg->connectionHandle, 251, 2120);
+
+            // The bond manager keeps a single local OOB value. The links
+            // still pairing read the current one from Characteristic 1,
+            // so it is only renewed when no other link is up.
+            if (linkDB_NumActive() == 1)
+            {
+                bStatus_t status = CryptoProf_getLocalOob(&localOobData);
+
+                uint8_t charValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
+                memcpy(charValue1, localOobData.confirm, KEYLEN);
+                memcpy(charValue1 + KEYLEN, localOobData.rand, KEYLEN);
+                SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR1, SIMPLEGATTPROFILE_CHAR1_LEN,
+                                              charValue1 );
+            }
+
+            doAttMtuExchange(gapEstMsg->connectionHandle, 251);
+
+            // Go on with the other peers while this link runs its handshake
+            Central_resume();
+        }
+        break;
 
-            uint8_t charValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
-            memcpy(charValue1, localOobData.confirm, KEYLEN);
-            memcpy(charValue1 + KEYLEN, localOobData.rand, KEYLEN);
-            SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR1, SIMPLEGATTPROFILE_CHAR1_LEN,
-                                          charValue1 );
+        case BLEAPPUTIL_LINK_TERMINATED_EVENT:
+        {
+            gapTerminateLinkEvent_t *gapTermMsg = (gapTerminateLinkEvent_t *)pMsgData;
+            uint8 peerIdx = Central_findPeerByHandle(gapTermMsg->connectionHandle);
 
-            doAttMtuExchange(251);
+            if (peerIdx != CENTRAL_PEER_NONE)
+            {
+                centralPeers[peerIdx].state = CENTRAL_PEER_IDLE;
+                centralPeers[peerIdx].connHandle = LINKDB_CONNHANDLE_INVALID;
+                centralPeers[peerIdx].searchStartTick = ClockP_getSystemTicks();
+#if APP_OOB_IN_ADV_DATA
+                // The peer advertises new OOB data
+                centralPeers[peerIdx].oobFound = 0;
+                centralPeers[peerIdx].oobNumReports = 0;
+#if APP_CONNECT_ACCEPT_LIST
+                centralOobScanDone = FALSE;
+#endif
+#endif
+                Central_resume();
+            }
         }
         break;
 
@@ -295,6 +545,461 @@ void Central_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         }
     }
 }
+/*********************************************************************
+ * @fn      Central_findPeer
+ *
+ * @brief   Find a peer of the set by address
+ *
+ * @param   pAddr - address of the device
+ *
+ * @return  index of the peer, CENTRAL_PEER_NONE if not in the set
+ */
+static uint8 Central_findPeer(uint8_t *pAddr)
+{
+    uint8 i;
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (memcmp(centralPeerAddrs[i], pAddr, B_ADDR_LEN) == 0)
+        {
+            return i;
+        }
+    }
+
+    return CENTRAL_PEER_NONE;
+}
+
+/*********************************************************************
+ * @fn      Central_findPeerByHandle
+ *
+ * @brief   Find a connected peer of the set by connection handle
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  index of the peer, CENTRAL_PEER_NONE if not found
+ */
+static uint8 Central_findPeerByHandle(uint16_t connHandle)
+{
+    uint8 i;
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (centralPeers[i].state >= CENTRAL_PEER_CONNECTED &&
+            centralPeers[i].connHandle == connHandle)
+        {
+            return i;
+        }
+    }
+
+    return CENTRAL_PEER_NONE;
+}
+
+#if !APP_CONNECT_ACCEPT_LIST
+/*********************************************************************
+ * @fn      Central_connectPeer
+ *
+ * @brief   Start the connection to a peer of the set
+ *
+ * @param   peerIdx - index of the peer
+ * @param   pScanRpt - the adv report of the peer
+ *
+ * @return  none
+ */
+static void Central_connectPeer(uint8 peerIdx, bleStk_GapScan_Evt_AdvRpt_t *pScanRpt)
+{
+    BLEAppUtil_ConnectParams_t connParams =
+    {
+      .peerAddrType = pScanRpt->addrType,
+      .phys = INIT_PHY_1M,
+      .timeout = CENTRAL_CONNECT_TIMEOUT
+    };
+
+    if (linkDB_NumActive() >= MAX_NUM_BLE_CONNS)
+    {
+        return;
+    }
+
+    memcpy(connParams.pPeerAddress, pScanRpt->addr, B_ADDR_LEN);
+    if (BLEAppUtil_connect(&connParams) == SUCCESS)
+    {
+        centralPeers[peerIdx].state = CENTRAL_PEER_CONNECTING;
+        centralConnectingPeer = peerIdx;
+    }
+}
+#endif // !APP_CONNECT_ACCEPT_LIST
+
+/*********************************************************************
+ * @fn      Central_startSet
+ *
+ * @brief   Start looking for the whole set: reset the set timing and
+ *          the search start of every peer
+ *
+ * @return  none
+ */
+static void Central_startSet(void)
+{
+    uint8 i;
+
+    centralSetTiming = TRUE;
+    centralSetStartTick = ClockP_getSystemTicks();
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (centralPeers[i].state == CENTRAL_PEER_IDLE)
+        {
+            centralPeers[i].searchStartTick = centralSetStartTick;
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      Central_resume
+ *
+ * @brief   Look for the peers of the set again while some are not
+ *          connected and a link is free: restart the accept list
+ *          initiator, after a short scan for the OOB data of the
+ *          peers with APP_OOB_IN_ADV_DATA, or the scan. Stop
+ *          scanning otherwise.
+ *
+ * @return  none
+ */
+static void Central_resume(void)
+{
+    uint8 i;
+
+    if (centralConnectingPeer != CENTRAL_PEER_NONE || centralInitiating)
+    {
+        return;
+    }
+#if APP_OOB_IN_ADV_DATA && APP_CONNECT_ACCEPT_LIST
+    if (centralOobScanning)
+    {
+        return;
+    }
+#endif
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (centralPeers[i].state == CENTRAL_PEER_IDLE)
+        {
+            break;
+        }
+    }
+
+#if APP_CONNECT_ACCEPT_LIST
+    if (i < CENTRAL_NUM_PEERS && linkDB_NumActive() < MAX_NUM_BLE_CONNS)
+    {
+#if APP_OOB_IN_ADV_DATA
+        // Once after each link change, a peer not advertising the
+        // data pairs without it after the scan duration
+        if (!centralOobScanDone && Central_isOobMissing() &&
+            BLEAppUtil_scanStart(&centralOobScanStartParams) == SUCCESS)
+        {
+            centralOobScanning = TRUE;
+            return;
+        }
+#endif
+        // No timeout, the controller waits for the first allowlisted
+        // device to advertise
+        if (GapInit_connectAl(INIT_PHY_1M, 0) == SUCCESS)
+        {
+            centralInitiating = TRUE;
+        }
+    }
+#else
+    if (i < CENTRAL_NUM_PEERS && linkDB_NumActive() < MAX_NUM_BLE_CONNS)
+    {
+        // Fails harmlessly when the scan is still running
+        BLEAppUtil_scanStart(&centralScanStartParams);
+    }
+    else
+    {
+        BLEAppUtil_scanStop();
+    }
+#endif
+}
+
+/*********************************************************************
+ * @fn      Central_recordConnectTime
+ *
+ * @brief   Add the time a peer took to connect, from the moment it was
+ *          looked for, to the distribution and print it
+ *
+ * @param   peerIdx - index of the peer
+ *
+ * @return  none
+ */
+static void Central_recordConnectTime(uint8 peerIdx)
+{
+    uint32_t connTimeMs = (ClockP_getSystemTicks() - centralPeers[peerIdx].searchStartTick) *
+                          ClockP_getSystemTickPeriod() / 1000;
+    uint8 bin = 0;
+
+    while (bin < CENTRAL_NUM_CONN_TIME_BINS - 1 && connTimeMs >= centralConnTimeBins[bin])
+    {
+        bin++;
+    }
+    centralConnTimeHist[bin]++;
+
+    centralNumConnTimes++;
+    centralConnTimeSumMs += connTimeMs;
+    centralConnTimeMinMs = MIN(centralConnTimeMinMs, connTimeMs);
+    centralConnTimeMaxMs = MAX(centralConnTimeMaxMs, connTimeMs);
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE5, 0, "Time to connect (%s): last %u ms - "
+                      "min %u avg %u max %u ms over %d",
+                      APP_CONNECT_ACCEPT_LIST ? "accept list" : "scan",
+                      connTimeMs, centralConnTimeMinMs, centralConnTimeSumMs / centralNumConnTimes,
+                      centralConnTimeMaxMs, centralNumConnTimes);
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "Time to connect (ms): <50: %d <100: %d <200: %d "
+                      "<500: %d <1000: %d <2000: %d more: %d",
+                      centralConnTimeHist[0], centralConnTimeHist[1], centralConnTimeHist[2],
+                      centralConnTimeHist[3], centralConnTimeHist[4], centralConnTimeHist[5],
+                      centralConnTimeHist[6]);
+}
+
+/*********************************************************************
+ * @fn      Central_printWakeups
+ *
+ * @brief   Print, for each scan filter, the number of advertising
+ *          reports the host was woken up for, how many came from the
+ *          peers of the set, and the scan time they were counted over
+ *
+ * @return  none
+ */
+static void Central_printWakeups(void)
+{
+    uint32_t scanMs[CENTRAL_NUM_SCAN_FLT];
+
+    memcpy(scanMs, centralScanMs, sizeof(scanMs));
+    if (centralScanning)
+    {
+        scanMs[centralScanFilter] += (ClockP_getSystemTicks() - centralScanStartTick) *
+                                     ClockP_getSystemTickPeriod() / 1000;
+    }
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE, 0, "Host wakeups (%s): no filter "
+                      MENU_MODULE_COLOR_YELLOW "%u " MENU_MODULE_COLOR_RESET "adv reports, %u from the set, in %u ms - "
+                      "accept list " MENU_MODULE_COLOR_YELLOW "%u " MENU_MODULE_COLOR_RESET "adv reports, %u from the set, in %u ms",
+                      (centralScanFilter == CENTRAL_SCAN_FLT_AL) ? "accept list" : "no filter",
+                      centralNumReports[CENTRAL_SCAN_FLT_NONE], centralNumPeerReports[CENTRAL_SCAN_FLT_NONE],
+                      scanMs[CENTRAL_SCAN_FLT_NONE],
+                      centralNumReports[CENTRAL_SCAN_FLT_AL], centralNumPeerReports[CENTRAL_SCAN_FLT_AL],
+                      scanMs[CENTRAL_SCAN_FLT_AL]);
+}
+
+#if APP_SCAN_FILTER_ACCEPT_LIST
+/*********************************************************************
+ * @fn      Central_toggleScanFilter
+ *
+ * @brief   Switch the scanner between the accept list filter policy
+ *          with the RSSI floor and no filter, to count the host
+ *          wakeups of both. Takes effect with the next scan.
+ *
+ * @return  SUCCESS, bleIncorrectMode while scanning, or stack call
+ *          status
+ */
+bStatus_t Central_toggleScanFilter(void)
+{
+    uint8 filter = (centralScanFilter == CENTRAL_SCAN_FLT_AL) ? CENTRAL_SCAN_FLT_NONE : CENTRAL_SCAN_FLT_AL;
+    uint8 policy = (filter == CENTRAL_SCAN_FLT_AL) ? SCAN_FLT_POLICY_AL : SCANNER_FILTER_POLICY;
+    int8 minRssi = (filter == CENTRAL_SCAN_FLT_AL) ? APP_SCAN_MIN_RSSI : SCANNER_FILTER_MIN_RSSI;
+    bStatus_t status;
+
+    // The reports of a running scan are counted for the current filter
+    if (centralScanning)
+    {
+        return bleIncorrectMode;
+    }
+
+    status = GapScan_setParam(SCAN_PARAM_FLT_POLICY, &policy);
+    if (status == SUCCESS)
+    {
+        status = GapScan_setParam(SCAN_PARAM_FLT_MIN_RSSI, &minRssi);
+    }
+    if (status == SUCCESS)
+    {
+        centralScanFilter = filter;
+    }
+    Central_printWakeups();
+
+    return status;
+}
+#endif // APP_SCAN_FILTER_ACCEPT_LIST
+
+#if APP_SCAN_FILTER_ACCEPT_LIST || APP_CONNECT_ACCEPT_LIST
+/*********************************************************************
+ * @fn      Central_loadAcceptList
+ *
+ * @brief   Replace the content of the controller's filter accept list
+ *          with the peers of the set. The list can not be changed
+ *          while scanning or initiating, so this runs before the
+ *          first scan.
+ *
+ * @return  SUCCESS or stack call status
+ */
+static bStatus_t Central_loadAcceptList(void)
+{
+    bStatus_t status;
+    uint8 i;
+
+    status = HCI_LE_ClearAcceptListCmd();
+    for (i = 0; i < CENTRAL_NUM_PEERS && status == SUCCESS; i++)
+    {
+        status = HCI_LE_AddAcceptListCmd(APP_PEER_ADDR_TYPE, (uint8 *)centralPeerAddrs[i]);
+    }
+
+    return status;
+}
+#endif // APP_SCAN_FILTER_ACCEPT_LIST || APP_CONNECT_ACCEPT_LIST
+
+/*********************************************************************
+ * @fn      Central_getPeerOob
+ *
+ * @brief   Get the OOB data a peer of the set carried in its
+ *          advertising data
+ *
+ * @param   connHandle - connection handle
+ * @param   pOob - filled with the confirm and random values
+ *
+ * @return  TRUE if the OOB data was found in the advertising data
+ */
+uint8_t Central_getPeerOob(uint16_t connHandle, gapBondOOBData_t *pOob)
+{
+#if APP_OOB_IN_ADV_DATA
+    uint8 peerIdx = Central_findPeerByHandle(connHandle);
+
+    if (peerIdx != CENTRAL_PEER_NONE && centralPeers[peerIdx].oobFound == CENTRAL_OOB_ALL_FOUND)
+    {
+        memcpy(pOob, &centralPeers[peerIdx].oob, sizeof(gapBondOOBData_t));
+        return TRUE;
+    }
+#endif
+    return FALSE;
+}
+
+/*********************************************************************
+ * @fn      Central_peerAuthenticated
+ *
+ * @brief   Mark the peer of a link as authenticated, and report the
+ *          time it took to authenticate the whole set
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Central_peerAuthenticated(uint16_t connHandle)
+{
+    uint8 peerIdx = Central_findPeerByHandle(connHandle);
+    uint8 numAuthenticated = 0;
+    uint8 i;
+
+    if (peerIdx == CENTRAL_PEER_NONE)
+    {
+        return;
+    }
+    centralPeers[peerIdx].state = CENTRAL_PEER_AUTHENTICATED;
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (centralPeers[i].state == CENTRAL_PEER_AUTHENTICATED)
+        {
+            numAuthenticated++;
+        }
+    }
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE5, 0, "Peers authenticated: %d / %d",
+                      numAuthenticated, CENTRAL_NUM_PEERS);
+
+    if (numAuthenticated == CENTRAL_NUM_PEERS && centralSetTiming)
+    {
+        uint32_t elapsedMs = (ClockP_getSystemTicks() - centralSetStartTick) *
+                             ClockP_getSystemTickPeriod() / 1000;
+
+        centralSetTiming = FALSE;
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE5, 0, "Peers authenticated: %d / %d - "
+                          "time to all authenticated = " MENU_MODULE_COLOR_YELLOW "%u ms" MENU_MODULE_COLOR_RESET,
+                          numAuthenticated, CENTRAL_NUM_PEERS, elapsedMs);
+    }
+}
+
+#if APP_OOB_IN_ADV_DATA
+/*********************************************************************
+ * @fn      Central_captureOobFromAdv
+ *
+ * @brief   Look for the SC OOB confirm/random AD structures in an
+ *          advertising report and store them with the peer, so no
+ *          OOB read is needed after connecting.
+ *
+ * @param   pPeer - peer of the set that sent the report
+ * @param   pScanRpt - the adv report to take the data from
+ *
+ * @return  the OOB values found so far (CENTRAL_OOB_xxx_FOUND)
+ */
+static uint8 Central_captureOobFromAdv(Central_peer_t *pPeer, bleStk_GapScan_Evt_AdvRpt_t *pScanRpt)
+{
+    uint8 oobFound = pPeer->oobFound;
+    uint16 i = 0;
+
+    while (i + 1 < pScanRpt->dataLen && pScanRpt->pData[i] != 0)
+    {
+        uint8 adLen = pScanRpt->pData[i];
+        uint8 adType = pScanRpt->pData[i + 1];
+
+        if (i + 1 + adLen > pScanRpt->dataLen)
+        {
+            break;
+        }
+        if (adLen == KEYLEN + 1 && adType == APP_ADTYPE_SC_CONFIRM_VALUE)
+        {
+            memcpy(pPeer->oob.confirm, &pScanRpt->pData[i + 2], KEYLEN);
+            pPeer->oobFound |= CENTRAL_OOB_CONFIRM_FOUND;
+        }
+        else if (adLen == KEYLEN + 1 && adType == APP_ADTYPE_SC_RANDOM_VALUE)
+        {
+            memcpy(pPeer->oob.rand, &pScanRpt->pData[i + 2], KEYLEN);
+            pPeer->oobFound |= CENTRAL_OOB_RANDOM_FOUND;
+        }
+        i += adLen + 1;
+    }
+
+    if (pPeer->oobFound == CENTRAL_OOB_ALL_FOUND && oobFound != CENTRAL_OOB_ALL_FOUND)
+    {
+        MenuModule_printf(APP_MENU_SCAN_EVENT, 0, "Scan status: OOB data from adv = 0x%02x 0x%02x 0x%02x 0x%02x ",
+                          pPeer->oob.confirm[0], pPeer->oob.confirm[1],
+                          pPeer->oob.rand[0], pPeer->oob.rand[1]);
+    }
+
+    return pPeer->oobFound;
+}
+
+#if APP_CONNECT_ACCEPT_LIST
+/*********************************************************************
+ * @fn      Central_isOobMissing
+ *
+ * @brief   Check whether a peer that is not connected has not sent its
+ *          OOB data yet
+ *
+ * @return  TRUE if the OOB scan has a peer to wait for
+ */
+static uint8 Central_isOobMissing(void)
+{
+    uint8 i;
+
+    for (i = 0; i < CENTRAL_NUM_PEERS; i++)
+    {
+        if (centralPeers[i].state == CENTRAL_PEER_IDLE &&
+            centralPeers[i].oobFound != CENTRAL_OOB_ALL_FOUND)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+#endif // APP_CONNECT_ACCEPT_LIST
+#endif // APP_OOB_IN_ADV_DATA
+
 /*********************************************************************
  * @fn      Central_addScanRes
  *
@@ -357,6 +1062,16 @@ bStatus_t Central_start()
         return(status);
     }
 
+#if APP_SCAN_FILTER_ACCEPT_LIST || APP_CONNECT_ACCEPT_LIST
+    // The scanner or the initiator only accept the devices of the list
+    status = Central_loadAcceptList();
+    if(status != SUCCESS)
+    {
+        // Return status value
+        return(status);
+    }
+#endif
+
     status = BLEAppUtil_scanInit(&centralScanInitParams);
     if(status != SUCCESS)
     {
@@ -370,6 +1085,12 @@ bStatus_t Central_start()
         // Return status value
         return(status);
     }
+
+#if APP_CONNECT_ACCEPT_LIST
+    // Connect to the set right away, scanning is left to the discovery
+    Central_startSet();
+    Central_resume();
+#endif
     // Return status value
     return(status);
 }
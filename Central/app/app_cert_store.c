@@ -0,0 +1,739 @@
+/******************************************************************************
+
+@file  app_cert_store.c
+
+@brief This file contains the flash resident certificate store
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_main.h>
+
+#include <ti/drivers/SHA2.h>
+#include <ti/drivers/ECDSA.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+/*
+ * Bundle format, little endian, offsets from the start of the bundle:
+ *
+ *   CertBundle_header_t                        16 bytes
+ *   CertBundle_entry_t[count]                  36 bytes each
+ *   certificates                               APP_CERT_LEN bytes each
+ *
+ * The CRC-32 (IEEE 802.3, as zlib.crc32) covers the bytes after the header.
+ * tools/cert_bundle/make_bundle.py builds the image.
+ *
+ * The bundle is not signed, so it is only written with the programmer,
+ * never at run time: make_bundle.py --previous puts a new bundle in the
+ * inactive bank with the next generation. A bank with a torn write fails
+ * the CRC check and the other bank stays in use. The valid bank with the
+ * highest generation is the active one.
+ */
+#define CERT_BUNDLE_MAGIC           0x444E4243  // "CBND"
+#define CERT_BUNDLE_VERSION         1
+
+// NVS_SLOT region, as set for CONFIG_NVSINTERNAL in basic_ble.syscfg
+#ifndef CERT_BUNDLE_NVS_BASE
+#define CERT_BUNDLE_NVS_BASE        0x7C000
+#endif
+#ifndef CERT_BUNDLE_NVS_SIZE
+#define CERT_BUNDLE_NVS_SIZE        0x4000
+#endif
+// One flash sector per bank, the two last sectors of the region. The
+// stack NV (NVOCMP) uses the first NVOCMP_NVPAGES sectors.
+#define CERT_BUNDLE_BANK_SIZE       0x800
+#define CERT_BUNDLE_BANK_A          (CERT_BUNDLE_NVS_BASE + CERT_BUNDLE_NVS_SIZE - 2 * CERT_BUNDLE_BANK_SIZE)
+#define CERT_BUNDLE_BANK_B          (CERT_BUNDLE_NVS_BASE + CERT_BUNDLE_NVS_SIZE - CERT_BUNDLE_BANK_SIZE)
+
+#define CERT_BUNDLE_HDR_LEN         16
+#define CERT_BUNDLE_ENTRY_LEN       (4 + CERT_FINGERPRINT_LEN)
+
+#if CERT_BUNDLE_HDR_LEN + CERT_BUNDLE_MAX_CERTS * (CERT_BUNDLE_ENTRY_LEN + APP_CERT_LEN) > CERT_BUNDLE_BANK_SIZE
+#error "CERT_BUNDLE_MAX_CERTS certificates do not fit in a bundle bank"
+#endif
+#if defined(NVOCMP_NVPAGES) && (NVOCMP_NVPAGES * CERT_BUNDLE_BANK_SIZE > CERT_BUNDLE_NVS_SIZE - 2 * CERT_BUNDLE_BANK_SIZE)
+#error "The stack NV pages overlap the certificate bundle banks"
+#endif
+
+/*
+ * Revocation list format, offsets from the start of the bank:
+ *
+ *   CertBundle_header_t, magic CERT_REVOKE_MAGIC  16 bytes
+ *   filter                                     CERT_REVOKE_FILTER_LEN bytes
+ *   revoked ids, sorted                        CERT_REVOKE_ID_LEN bytes each
+ *
+ * A revoked id is the start of the certificate fingerprint. The filter
+ * is a Bloom filter of the ids: a fingerprint is a SHA256 already, so
+ * its first CERT_REVOKE_HASHES 16-bit words serve as the bit indices. A
+ * clear bit tells in constant time that a certificate is not revoked,
+ * only the rare hits are confirmed by a binary search of the ids. The
+ * filter bits are stored inverted, so erased flash is an empty filter.
+ *
+ * The list uses two banks like the bundle, in the two sectors before the
+ * bundle banks, and is written with the programmer the same way:
+ * tools/cert_bundle/make_revoke.py --previous keeps the ids of the active
+ * list and adds the new ones in the inactive bank.
+ */
+#define CERT_REVOKE_MAGIC           0x4B565243  // "CRVK"
+#define CERT_REVOKE_VERSION         1
+
+#define CERT_REVOKE_BANK_A          (CERT_BUNDLE_BANK_A - 2 * CERT_BUNDLE_BANK_SIZE)
+#define CERT_REVOKE_BANK_B          (CERT_BUNDLE_BANK_A - CERT_BUNDLE_BANK_SIZE)
+
+#define CERT_REVOKE_FILTER_LEN      256
+#define CERT_REVOKE_FILTER_MASK     (CERT_REVOKE_FILTER_LEN * 8 - 1)
+#define CERT_REVOKE_HASHES          3
+#define CERT_REVOKE_ID_LEN          16
+#define CERT_REVOKE_IDS_OFFSET      (CERT_BUNDLE_HDR_LEN + CERT_REVOKE_FILTER_LEN)
+
+#if APP_CERT_REVOKE
+#if CERT_REVOKE_IDS_OFFSET + CERT_REVOKE_MAX_IDS * CERT_REVOKE_ID_LEN > CERT_BUNDLE_BANK_SIZE || CERT_REVOKE_MAX_IDS > 255
+#error "CERT_REVOKE_MAX_IDS ids do not fit in a revocation list bank"
+#endif
+#if defined(NVOCMP_NVPAGES) && (NVOCMP_NVPAGES * CERT_BUNDLE_BANK_SIZE > CERT_BUNDLE_NVS_SIZE - 4 * CERT_BUNDLE_BANK_SIZE)
+#error "The stack NV pages overlap the revocation list banks"
+#endif
+#endif
+
+// Built-in certificates: device, signer
+#define CERT_STORE_BUILTIN_NUM      2
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Header of a bundle or of a revocation list
+typedef struct
+{
+    uint32_t magic;         // CERT_BUNDLE_MAGIC or CERT_REVOKE_MAGIC
+    uint8_t  version;       // CERT_BUNDLE_VERSION
+    uint8_t  count;         // Entries of the index, or revoked ids
+    uint16_t len;           // Length of the bank content, header included
+    uint32_t generation;    // Incremented by each update
+    uint32_t crc;           // CRC-32 of the bytes after the header
+}CertBundle_header_t;
+
+typedef struct
+{
+    uint8_t  certId;        // One of CertStore_ids
+    uint8_t  reserved;
+    uint16_t offset;        // Offset of the certificate in the bundle
+    uint8_t  fingerprint[CERT_FINGERPRINT_LEN];
+}CertBundle_entry_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static const uint8_t *CertStore_find(uint8_t certId, uint8_t index, const uint8_t **ppFingerprint);
+#if APP_CERT_BUNDLE
+static const CertBundle_header_t *CertStore_checkBundle(const uint8_t *pBundle);
+#endif
+#if APP_CERT_REVOKE
+static const CertBundle_header_t *CertStore_checkRevoke(const uint8_t *pList);
+static uint8_t CertStore_isRevoked(const CertView_t *pCert);
+static uint16_t CertStore_filterBit(const uint8_t *pId, uint8_t hash);
+#endif
+#if APP_CERT_BUNDLE || APP_CERT_REVOKE
+static const CertBundle_header_t *CertStore_selectBank(const CertBundle_header_t *pA,
+                                                       const CertBundle_header_t *pB);
+static uint32_t CertStore_crc32(const uint8_t *pData, uint16_t len);
+#endif
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Built-in certificates, used when there is no valid bundle. They never
+// change at run time, const keeps them in flash instead of taking SRAM for
+// a copy initialized at boot.
+// Layout: id(1) data(8) public key X(32) Y(32) signature r(32) s(32)
+static const uint8_t certStoreSignerCert[APP_CERT_LEN] =
+{
+    CERT_STORE_SIGNER,
+    0x3E, 0x12, 0xCB, 0x3D, 0x01, 0x32, 0x36, 0x6F, // 8 bytes data
+    0xC4, 0xBC, 0x58, 0x1D, 0xAE, 0xA6, 0xB6, 0x44, 0x15, 0xBE, 0x3E, // public key X
+    0x1F, 0x59, 0x8B, 0x83, 0xBA, 0x17, 0x57, 0xD6, 0x1A, 0x81, 0xB9,
+    0xD1, 0xD6, 0xAB, 0xF6, 0xDF, 0x6D, 0xFD, 0xEE, 0x89, 0x24,
+    0x2F, 0xB7, 0x2B, 0x22, 0x54, 0xDF, 0x99, 0x1E, 0x7D, 0xF3, 0xAD, // public key Y
+    0x88, 0xA5, 0x99, 0x51, 0x4D, 0xF7, 0x4C, 0x91, 0x09, 0x06, 0x47,
+    0x20, 0x77, 0x4B, 0x7E, 0x3A, 0xB4, 0x2D, 0xC0, 0x08, 0xBA,
+    0x84, 0xE6, 0x0D, 0x13, 0x37, 0xAB, 0x47, 0xDA, 0xA9, 0x5E, 0x2D, // signature R + S
+    0xBA, 0x80, 0x7A, 0x10, 0x99, 0x9A, 0x15, 0xAF, 0x92, 0x22, 0x1C,
+    0xC1, 0x3B, 0xE7, 0x22, 0x6F, 0x74, 0xAF, 0x69, 0x67, 0x00, 0x5B,
+    0x84, 0xD9, 0x8F, 0x0B, 0x30, 0x3F, 0xEC, 0xD0, 0x4D, 0xA4, 0x05,
+    0x15, 0x43, 0x87, 0xC9, 0xEF, 0x01, 0xBB, 0x8E, 0x87, 0x39, 0x20,
+    0x57, 0x84, 0x50, 0x9D, 0x63, 0xC6, 0x2C, 0x87, 0x56
+};
+
+static const uint8_t certStoreDeviceCert[APP_CERT_LEN] =
+{
+    CERT_STORE_DEVICE,
+    0x74, 0x79, 0x41, 0x3A, 0x50, 0xEF, 0x4B, 0x34, // 8 bytes data
+    0xBB, 0x12, 0xBF, 0xEF, 0x48, 0xE8, 0xAC, 0x5E, 0x54, 0x07, 0x90, // public key X
+    0xA9, 0x58, 0xD0, 0x99, 0xC4, 0xA7, 0xEF, 0x31, 0x58, 0xD4, 0xBD,
+    0xAF, 0x3A, 0x86, 0x8C, 0x33, 0x96, 0x1D, 0x73, 0x45, 0x90,
+    0x74, 0xC2, 0xC9, 0x63, 0xB4, 0xA0, 0xE2, 0xDC, 0xF6, 0x96, 0x02, // public key Y
+    0xBA, 0xDF, 0xFC, 0x8E, 0x5D, 0x40, 0x7A, 0xEF, 0x61, 0xEE, 0x98,
+    0x61, 0xFB, 0xB1, 0x2A, 0x9C, 0x46, 0xA9, 0x99, 0x50, 0x46,
+    0x1F, 0x2A, 0x03, 0x4A, 0x0C, 0xCE, 0xDC, 0x97, 0xC8, 0x83, 0x55, // signature R + S
+    0x3D, 0x08, 0x4D, 0x4C, 0x5D, 0xDA, 0x46, 0x44, 0x65, 0xBB, 0x47,
+    0x37, 0x49, 0x4A, 0xE4, 0xE2, 0x09, 0x5D, 0xA5, 0x0F, 0x52, 0x91,
+    0x29, 0xCD, 0xD4, 0xD1, 0xEA, 0xE3, 0xFC, 0x1B, 0xBC, 0xA7, 0x37,
+    0xC7, 0xA9, 0x15, 0xB6, 0x79, 0xC6, 0xB6, 0x9F, 0x18, 0xE6, 0x15,
+    0x59, 0xAB, 0x02, 0xD2, 0xF5, 0xE6, 0xDB, 0x16, 0xF5
+};
+
+// Fingerprints of the built-in certificates, computed by CertStore_init
+static uint8_t certStoreBuiltinFp[CERT_STORE_BUILTIN_NUM][CERT_FINGERPRINT_LEN];
+
+#if APP_CERT_BUNDLE
+// Active bundle, read in place from flash. NULL: built-in certificates.
+static const CertBundle_header_t *pCertBundle = NULL;
+#endif
+#if APP_CERT_REVOKE
+// Active revocation list, read in place from flash. NULL: nothing revoked.
+static const CertBundle_header_t *pCertRevoke = NULL;
+#endif
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CertStore_init
+ *
+ * @brief   Select the newest valid revocation list and certificate
+ *          bundle, and compute the fingerprints of the built-in
+ *          certificates when there is no bundle
+ *
+ * @return  none
+ */
+void CertStore_init(void)
+{
+#if APP_CERT_REVOKE
+    pCertRevoke = CertStore_selectBank(CertStore_checkRevoke((const uint8_t *)CERT_REVOKE_BANK_A),
+                                       CertStore_checkRevoke((const uint8_t *)CERT_REVOKE_BANK_B));
+#endif
+
+#if APP_CERT_BUNDLE
+    pCertBundle = CertStore_selectBank(CertStore_checkBundle((const uint8_t *)CERT_BUNDLE_BANK_A),
+                                       CertStore_checkBundle((const uint8_t *)CERT_BUNDLE_BANK_B));
+    if (pCertBundle != NULL)
+    {
+        return;
+    }
+#endif
+
+    CryptoCtx_hash(certStoreDeviceCert, APP_CERT_LEN, certStoreBuiltinFp[0]);
+    CryptoCtx_hash(certStoreSignerCert, APP_CERT_LEN, certStoreBuiltinFp[1]);
+}
+
+/*********************************************************************
+ * @fn      CertStore_get
+ *
+ * @brief   Get a local certificate, the first one of its id
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL for an unknown id
+ */
+const uint8_t *CertStore_get(uint8_t certId)
+{
+    return CertStore_find(certId, 0, NULL);
+}
+
+/*********************************************************************
+ * @fn      CertStore_getAt
+ *
+ * @brief   Get one of the local certificates of an id
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL past the last one
+ */
+const uint8_t *CertStore_getAt(uint8_t certId, uint8_t index)
+{
+    return CertStore_find(certId, index, NULL);
+}
+
+/*********************************************************************
+ * @fn      CertStore_getFingerprint
+ *
+ * @brief   Get the fingerprint of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  CERT_FINGERPRINT_LEN bytes, or NULL past the last one
+ */
+const uint8_t *CertStore_getFingerprint(uint8_t certId, uint8_t index)
+{
+    const uint8_t *pFingerprint = NULL;
+
+    CertStore_find(certId, index, &pFingerprint);
+
+    return pFingerprint;
+}
+
+/*********************************************************************
+ * @fn      CertStore_findByFingerprint
+ *
+ * @brief   Find a local certificate from its fingerprint
+ *
+ * @param   pFingerprint - CERT_FINGERPRINT_LEN bytes
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByFingerprint(const uint8_t *pFingerprint)
+{
+    static const uint8_t certIds[] = {CERT_STORE_DEVICE, CERT_STORE_SIGNER};
+    const uint8_t *pCert;
+    const uint8_t *pFp;
+    uint8_t i;
+    uint8_t index;
+
+    for (i = 0; i < sizeof(certIds); i++)
+    {
+        for (index = 0; (pCert = CertStore_find(certIds[i], index, &pFp)) != NULL; index++)
+        {
+            if (memcmp(pFp, pFingerprint, CERT_FINGERPRINT_LEN) == 0)
+            {
+                return pCert;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn      CertStore_findByPublicKey
+ *
+ * @brief   Find a local certificate of an id from its public key
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes X || Y
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByPublicKey(uint8_t certId, const uint8_t *pPublicKey)
+{
+    const uint8_t *pCert;
+    uint8_t index;
+
+    for (index = 0; (pCert = CertStore_find(certId, index, NULL)) != NULL; index++)
+    {
+        if (memcmp(((const CertView_t *)pCert)->publicKey, pPublicKey, CERT_PUBLIC_KEY_LEN) == 0)
+        {
+            return pCert;
+        }
+    }
+
+    return NULL;
+}
+
+/*********************************************************************
+ * @fn      CertStore_getPublicKey
+ *
+ * @brief   Get the public key X || Y of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes in flash, or NULL for an
+ *          unknown id
+ */
+const uint8_t *CertStore_getPublicKey(uint8_t certId)
+{
+    const uint8_t *pCert = CertStore_get(certId);
+
+    if (pCert == NULL)
+    {
+        return NULL;
+    }
+
+    return ((const CertView_t *)pCert)->publicKey;
+}
+
+/*********************************************************************
+ * @fn      CertStore_verifyCert
+ *
+ * @brief   Verify a received certificate against the key of its
+ *          signer. A revoked certificate is rejected before any
+ *          signature verification.
+ *
+ * @param   pCert - certificate, see CertView_parse
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes key of the signer
+ *
+ * @return  ECDSA_STATUS_SUCCESS, CERT_STORE_REVOKED_STATUS or the
+ *          error of the verification
+ */
+int_fast16_t CertStore_verifyCert(const CertView_t *pCert, const uint8_t *pPublicKey)
+{
+    if (pCert == NULL)
+    {
+        return ECDSA_STATUS_ERROR;
+    }
+
+#if APP_CERT_REVOKE
+    if (CertStore_isRevoked(pCert))
+    {
+        return CERT_STORE_REVOKED_STATUS;
+    }
+#endif
+
+    return CryptoCtx_verifyCert(pCert, pPublicKey);
+}
+
+/*********************************************************************
+ * @fn      CertStore_verifySigned
+ *
+ * @brief   Verify a certificate against each signer of the store. A
+ *          revoked certificate is rejected before any signature
+ *          verification.
+ *
+ * @param   pCert - certificate, see CertView_parse
+ *
+ * @return  ECDSA_STATUS_SUCCESS when a signer signed it,
+ *          CERT_STORE_REVOKED_STATUS, otherwise the error of the last
+ *          verification
+ */
+int_fast16_t CertStore_verifySigned(const CertView_t *pCert)
+{
+    int_fast16_t status = ECDSA_STATUS_ERROR;
+    const uint8_t *pSigner;
+    uint8_t index;
+
+    if (pCert == NULL)
+    {
+        return status;
+    }
+
+#if APP_CERT_REVOKE
+    if (CertStore_isRevoked(pCert))
+    {
+        return CERT_STORE_REVOKED_STATUS;
+    }
+#endif
+
+    for (index = 0; (pSigner = CertStore_getAt(CERT_STORE_SIGNER, index)) != NULL; index++)
+    {
+        status = CryptoCtx_verifyCert(pCert, ((const CertView_t *)pSigner)->publicKey);
+        if (status == ECDSA_STATUS_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      CertStore_find
+ *
+ * @brief   Certificate and fingerprint of the index-th certificate of
+ *          an id, in the active bundle or the built-in certificates
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ * @param   ppFingerprint - out: its fingerprint, may be NULL
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL past the last one
+ */
+static const uint8_t *CertStore_find(uint8_t certId, uint8_t index, const uint8_t **ppFingerprint)
+{
+    const uint8_t *pCert = NULL;
+    const uint8_t *pFingerprint = NULL;
+
+#if APP_CERT_BUNDLE
+    if (pCertBundle != NULL)
+    {
+        const CertBundle_entry_t *pEntry = (const CertBundle_entry_t *)(pCertBundle + 1);
+        uint8_t i;
+
+        for (i = 0; i < pCertBundle->count; i++, pEntry++)
+        {
+            if (pEntry->certId == certId && index-- == 0)
+            {
+                pCert = (const uint8_t *)pCertBundle + pEntry->offset;
+                pFingerprint = pEntry->fingerprint;
+                break;
+            }
+        }
+    }
+    else
+#endif
+    if (index == 0 && certId == CERT_STORE_DEVICE)
+    {
+        pCert = certStoreDeviceCert;
+        pFingerprint = certStoreBuiltinFp[0];
+    }
+    else if (index == 0 && certId == CERT_STORE_SIGNER)
+    {
+        pCert = certStoreSignerCert;
+        pFingerprint = certStoreBuiltinFp[1];
+    }
+
+    if (ppFingerprint != NULL)
+    {
+        *ppFingerprint = pFingerprint;
+    }
+
+    return pCert;
+}
+
+#if APP_CERT_BUNDLE
+/*********************************************************************
+ * @fn      CertStore_checkBundle
+ *
+ * @brief   Check the header, the index and the CRC of a bundle
+ *
+ * @param   pBundle - bank in flash
+ *
+ * @return  the bundle header, or NULL when the bundle is not valid
+ */
+static const CertBundle_header_t *CertStore_checkBundle(const uint8_t *pBundle)
+{
+    const CertBundle_header_t *pHdr = (const CertBundle_header_t *)pBundle;
+    const CertBundle_entry_t *pEntry = (const CertBundle_entry_t *)(pHdr + 1);
+    uint16_t certsOffset;
+    uint8_t i;
+
+    if (pHdr->magic != CERT_BUNDLE_MAGIC ||
+        pHdr->version != CERT_BUNDLE_VERSION ||
+        pHdr->count == 0 || pHdr->count > CERT_BUNDLE_MAX_CERTS)
+    {
+        return NULL;
+    }
+
+    certsOffset = sizeof(CertBundle_header_t) + pHdr->count * sizeof(CertBundle_entry_t);
+    if (pHdr->len < certsOffset || pHdr->len > CERT_BUNDLE_BANK_SIZE)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < pHdr->count; i++, pEntry++)
+    {
+        if (pEntry->offset < certsOffset ||
+            pEntry->offset + APP_CERT_LEN > pHdr->len ||
+            pBundle[pEntry->offset] != pEntry->certId)
+        {
+            return NULL;
+        }
+    }
+
+    if (CertStore_crc32(&pBundle[sizeof(CertBundle_header_t)], pHdr->len - sizeof(CertBundle_header_t)) != pHdr->crc)
+    {
+        return NULL;
+    }
+
+    return pHdr;
+}
+#endif
+
+#if APP_CERT_REVOKE
+/*********************************************************************
+ * @fn      CertStore_checkRevoke
+ *
+ * @brief   Check the header and the CRC of a revocation list bank
+ *
+ * @param   pList - bank in flash
+ *
+ * @return  the list header, or NULL when the bank is not valid
+ */
+static const CertBundle_header_t *CertStore_checkRevoke(const uint8_t *pList)
+{
+    const CertBundle_header_t *pHdr = (const CertBundle_header_t *)pList;
+
+    if (pHdr->magic != CERT_REVOKE_MAGIC ||
+        pHdr->version != CERT_REVOKE_VERSION ||
+        pHdr->count > CERT_REVOKE_MAX_IDS ||
+        pHdr->len != CERT_REVOKE_IDS_OFFSET + pHdr->count * CERT_REVOKE_ID_LEN)
+    {
+        return NULL;
+    }
+
+    if (CertStore_crc32(&pList[sizeof(CertBundle_header_t)], pHdr->len - sizeof(CertBundle_header_t)) != pHdr->crc)
+    {
+        return NULL;
+    }
+
+    return pHdr;
+}
+
+/*********************************************************************
+ * @fn      CertStore_isRevoked
+ *
+ * @brief   Look a certificate up in the revocation list. Most
+ *          certificates are cleared by the filter in constant time,
+ *          a filter hit is confirmed by a binary search.
+ *
+ * @param   pCert - certificate
+ *
+ * @return  TRUE when the certificate is revoked
+ */
+static uint8_t CertStore_isRevoked(const CertView_t *pCert)
+{
+    const uint8_t *pFilter;
+    const uint8_t *pIds;
+    uint8_t fingerprint[CERT_FINGERPRINT_LEN];
+    uint16_t bit;
+    uint8_t k;
+    int16_t low;
+    int16_t high;
+    int16_t mid;
+    int cmp;
+
+    if (pCertRevoke == NULL || pCertRevoke->count == 0)
+    {
+        return FALSE;
+    }
+
+    if (CryptoCtx_hash((const uint8_t *)pCert, sizeof(CertView_t), fingerprint) != SHA2_STATUS_SUCCESS)
+    {
+        // Fail closed, the certificate can not be cleared
+        return TRUE;
+    }
+
+    pFilter = (const uint8_t *)pCertRevoke + CERT_BUNDLE_HDR_LEN;
+    for (k = 0; k < CERT_REVOKE_HASHES; k++)
+    {
+        bit = CertStore_filterBit(fingerprint, k);
+        if (pFilter[bit >> 3] & BV(bit & 7))
+        {
+            return FALSE;
+        }
+    }
+
+    pIds = (const uint8_t *)pCertRevoke + CERT_REVOKE_IDS_OFFSET;
+    low = 0;
+    high = pCertRevoke->count - 1;
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        cmp = memcmp(&pIds[mid * CERT_REVOKE_ID_LEN], fingerprint, CERT_REVOKE_ID_LEN);
+        if (cmp == 0)
+        {
+            return TRUE;
+        }
+        if (cmp < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+
+    return FALSE;
+}
+
+/*********************************************************************
+ * @fn      CertStore_filterBit
+ *
+ * @brief   Bit of the revocation filter for one of the hashes of an id
+ *
+ * @param   pId - revoked id or fingerprint
+ * @param   hash - 0 to CERT_REVOKE_HASHES - 1
+ *
+ * @return  bit index in the filter
+ */
+static uint16_t CertStore_filterBit(const uint8_t *pId, uint8_t hash)
+{
+    return (pId[2 * hash] | ((uint16_t)pId[2 * hash + 1] << 8)) & CERT_REVOKE_FILTER_MASK;
+}
+#endif
+
+#if APP_CERT_BUNDLE || APP_CERT_REVOKE
+/*********************************************************************
+ * @fn      CertStore_selectBank
+ *
+ * @brief   Newest of two valid banks
+ *
+ * @param   pA - header of bank A, NULL when not valid
+ * @param   pB - header of bank B, NULL when not valid
+ *
+ * @return  the bank with the highest generation, NULL when neither is
+ *          valid
+ */
+static const CertBundle_header_t *CertStore_selectBank(const CertBundle_header_t *pA,
+                                                       const CertBundle_header_t *pB)
+{
+    // Generations are compared modulo 2^32
+    if (pA != NULL && pB != NULL)
+    {
+        return ((int32_t)(pB->generation - pA->generation) > 0) ? pB : pA;
+    }
+
+    return (pA != NULL) ? pA : pB;
+}
+
+/*********************************************************************
+ * @fn      CertStore_crc32
+ *
+ * @brief   CRC-32 of a buffer, reflected polynomial 0xEDB88320. Bitwise,
+ *          it only runs at boot.
+ *
+ * @param   pData - data
+ * @param   len - length of the data
+ *
+ * @return  CRC-32
+ */
+static uint32_t CertStore_crc32(const uint8_t *pData, uint16_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint8_t bit;
+
+    while (len--)
+    {
+        crc ^= *pData++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+#endif
@@ -53,6 +53,7 @@ Target Device: cc23xx
 #include <stdarg.h>
 
 #include "ti_ble_config.h"
+#include <icall.h>
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
@@ -64,9 +65,13 @@ Target Device: cc23xx
 void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Pairing_ecckeyHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+#if APP_PHY_POLICY
+static void Connection_radioStatsCB(uint16_t connHandle, const RadioStats_t *pStats);
+static bStatus_t Connection_setPhy(App_connCtx *pCtx, uint8_t phy);
+#endif
 
-static uint8_t Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr);
-static uint8_t Connection_removeConnInfo(uint16_t connHandle);
+static App_connCtx *Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr);
+static void Connection_removeConnInfo(uint16_t connHandle);
 //*****************************************************************************
 //! Globals
 //*****************************************************************************
@@ -100,11 +105,45 @@ BLEAppUtil_EventHandler_t PairingecckeyHandler =
     .eventMask      = BLEAPPUTIL_GENERATE_ECC_DONE
 };
 
-// Holds the connection handles
-static App_connInfo connectionConnList[MAX_NUM_BLE_CONNS];
+// Connection contexts. A context keeps its slot while the link is up, so
+// the slot index also indexes the per-link tables of the other modules.
+static App_connCtx connectionCtxList[MAX_NUM_BLE_CONNS];
+// Slot of each connection handle, or CONNECTION_SLOT_INVALID
+static uint8_t connectionSlotMap[CONNECTION_HANDLE_MAP_SIZE];
+// Stack of the free slots
+static uint8_t connectionFreeSlots[MAX_NUM_BLE_CONNS];
+static uint8_t connectionNumFree = 0;
+// Slots of the active links, for the connected device list of the menu
+static uint8_t connectionActiveSlots[MAX_NUM_BLE_CONNS];
+static uint8_t connectionNumActive = 0;
+#if APP_PHY_POLICY
+// Links of the Connection_setPhy commands waiting for their command
+// status, in the order they were sent. A link has one at most.
+static uint16_t connectionPhyCmdHandles[MAX_NUM_BLE_CONNS];
+static uint8_t connectionPhyCmdFirst = 0;
+static uint8_t connectionNumPhyCmds = 0;
+#endif
+
+// Parameters requested for each Connection_paramProfiles entry
+static const gapUpdateLinkParamReq_t connectionParamProfiles[CONN_PARAM_PROFILE_NUM] =
+{
+    // CONN_PARAM_PROFILE_HANDSHAKE
+    {
+     .intervalMin = APP_HANDSHAKE_CONN_INT,
+     .intervalMax = APP_HANDSHAKE_CONN_INT,
+     .connLatency = APP_HANDSHAKE_CONN_LAT,
+     .connTimeout = APP_HANDSHAKE_SUP_TO
+    },
+    // CONN_PARAM_PROFILE_SENSOR
+    {
+     .intervalMin = APP_SENSOR_CONN_INT,
+     .intervalMax = APP_SENSOR_CONN_INT,
+     .connLatency = APP_SENSOR_CONN_LAT,
+     .connTimeout = APP_SENSOR_SUP_TO
+    }
+};
 
 gapBondOOBData_t localOobData;
-gapBondOOBData_t remoteOobData;
 
 //*****************************************************************************
 //! Functions
@@ -130,9 +169,33 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         {
             gapEstLinkReqEvent_t *gapEstMsg = (gapEstLinkReqEvent_t *)pMsgData;
 
+            // A connection attempt to a peer of the set timed out
+            if (gapEstMsg->hdr.status != SUCCESS)
+            {
+                break;
+            }
+
             // Add the connection to the connected device list
             Connection_addConnInfo(gapEstMsg->connectionHandle, gapEstMsg->devAddr);
 
+            // Hold the certificate traffic until the link is configured
+            LinkReady_add(gapEstMsg->connectionHandle);
+#if APP_RADIO_STATS
+            RadioStats_add(gapEstMsg->connectionHandle);
+#endif
+
+#if APP_MUTUAL_AUTH
+            MutualAuth_reset(gapEstMsg->connectionHandle);
+#endif
+#if APP_CERT_CHAIN
+            CertChain_reset(gapEstMsg->connectionHandle);
+#endif
+
+#if APP_PHY_POLICY
+            // Halve the airtime of the handshake
+            Connection_setPhy(Connection_getCtx(gapEstMsg->connectionHandle), HCI_PHY_2_MBPS);
+#endif
+
             /*! Print the peer address and connection handle number */
             MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Established - "
                               "Connected to " MENU_MODULE_COLOR_YELLOW "%s " MENU_MODULE_COLOR_RESET
@@ -151,8 +214,14 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         {
             gapTerminateLinkEvent_t *gapTermMsg = (gapTerminateLinkEvent_t *)pMsgData;
 
+#if APP_RADIO_STATS
+            RadioStats_remove(gapTermMsg->connectionHandle);
+#endif
+            LinkReady_remove(gapTermMsg->connectionHandle);
             // Remove the connection from the conneted device list
             Connection_removeConnInfo(gapTermMsg->connectionHandle);
+            Frag_reset(gapTermMsg->connectionHandle);
+            Pairing_remove(gapTermMsg->connectionHandle);
 
             /*! Print the peer address and connection handle number */
             MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Terminated - "
@@ -171,10 +240,18 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         case BLEAPPUTIL_LINK_PARAM_UPDATE_REQ_EVENT:
         {
             gapUpdateLinkParamReqEvent_t *pReq = (gapUpdateLinkParamReqEvent_t *)pMsgData;
+            App_connCtx *pCtx = Connection_getCtx(pReq->req.connectionHandle);
+            const gapUpdateLinkParamReq_t *pProfile = &connectionParamProfiles[CONN_PARAM_PROFILE_HANDSHAKE];
 
-            // Only accept connection intervals with slave latency of 0
-            // This is just an example of how the application can send a response
-            if(pReq->req.connLatency == 0)
+            if (pCtx != NULL)
+            {
+                pProfile = &connectionParamProfiles[pCtx->paramProfile];
+            }
+
+            // Only accept requests that are not slower than the current profile,
+            // so the peer can not slow down the handshake
+            if(pReq->req.intervalMin <= pProfile->intervalMax &&
+               pReq->req.connLatency <= pProfile->connLatency)
             {
                 BLEAppUtil_paramUpdateRsp(pReq,TRUE);
             }
@@ -200,6 +277,10 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                   MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Params update - "
                                     "connectionHandle = " MENU_MODULE_COLOR_YELLOW "%d " MENU_MODULE_COLOR_RESET,
                                     pPkt->connectionHandle);
+#if APP_RADIO_STATS
+                  // The event rate changed with the interval
+                  RadioStats_reset(pPkt->connectionHandle);
+#endif
               }
               else
               {
@@ -273,7 +354,7 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         case BLEAPPUTIL_HCI_COMMAND_STATUS_EVENT_CODE:
         {
             hciEvt_CommandStatus_t *pHciMsg = (hciEvt_CommandStatus_t *)pMsgData;
-            switch ( event )
+            switch ( pHciMsg->cmdOpcode )
             {
               case HCI_LE_SET_PHY:
               {
@@ -288,6 +369,22 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                                         MENU_MODULE_COLOR_YELLOW "0x%02x" MENU_MODULE_COLOR_RESET,
                                         pHciMsg->cmdStatus);
                   }
+#if APP_PHY_POLICY
+                  if (connectionNumPhyCmds > 0)
+                  {
+                      uint16_t connHandle = connectionPhyCmdHandles[connectionPhyCmdFirst];
+                      App_connCtx *pCtx = Connection_getCtx(connHandle);
+
+                      connectionPhyCmdFirst = (connectionPhyCmdFirst + 1) % MAX_NUM_BLE_CONNS;
+                      connectionNumPhyCmds--;
+                      // No PHY update will complete on that link, keep its PHY
+                      if (pHciMsg->cmdStatus != SUCCESS && pCtx != NULL && pCtx->phyPending)
+                      {
+                          pCtx->phyPending = FALSE;
+                          LinkReady_setPhy(connHandle, 0);
+                      }
+                  }
+#endif
                   break;
               }
 
@@ -298,12 +395,20 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
               }
               break;
             }
+            break;
         }
 
         case BLEAPPUTIL_HCI_LE_EVENT_CODE:
         {
             hciEvt_BLEPhyUpdateComplete_t *pPUC = (hciEvt_BLEPhyUpdateComplete_t*) pMsgData;
 
+            if (pPUC->BLEEventCode == HCI_BLE_DATA_LENGTH_CHANGE_EVENT)
+            {
+                hciEvt_BLEDataLengthChange_t *pDLC = (hciEvt_BLEDataLengthChange_t *)pMsgData;
+
+                LinkReady_setDataLen(pDLC->connHandle, pDLC->maxTxOctets, pDLC->maxRxOctets);
+            }
+
             if (pPUC->BLEEventCode == HCI_BLE_PHY_UPDATE_COMPLETE_EVENT)
             {
               if (pPUC->status != SUCCESS)
@@ -322,6 +427,26 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                                     pPUC->connHandle, currPhy);
 #endif // #if !defined(Display_DISABLE_ALL)
               }
+              LinkReady_setPhy(pPUC->connHandle, (pPUC->status != SUCCESS) ? 0 :
+                               (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_2M) ? HCI_PHY_2_MBPS :
+                               (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_CODED) ? HCI_PHY_CODED : HCI_PHY_1_MBPS);
+#if APP_PHY_POLICY
+              {
+                  App_connCtx *pCtx = Connection_getCtx(pPUC->connHandle);
+                  if (pCtx != NULL)
+                  {
+                      pCtx->phyPending = FALSE;
+                      if (pPUC->status == SUCCESS)
+                      {
+                          pCtx->phy =
+                                  (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_2M) ? HCI_PHY_2_MBPS :
+                                  (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_CODED) ? HCI_PHY_CODED : HCI_PHY_1_MBPS;
+                      }
+                      // Judge the new PHY on its own statistics
+                      RadioStats_reset(pPUC->connHandle);
+                  }
+              }
+#endif
             }
 
             break;
@@ -336,91 +461,242 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 }
 
 /*********************************************************************
- * @fn      Connection_addConnInfo
+ * @fn      Connection_setParamProfile
+ *
+ * @brief   Request the connection parameters of a profile. Called
+ *          on the handshake state changes: the link runs at the
+ *          shortest interval during the certificates and the pairing,
+ *          then moves to a long interval with slave latency.
  *
- * @brief   Add a device to the connected device list
+ * @param   connHandle - connection handle
+ * @param   profile - one of Connection_paramProfiles
  *
- * @return  index of the connected device list entry where the new connection
- *          info is put in.
- *          If there is no room, MAX_NUM_BLE_CONNS will be returned.
+ * @return  SUCCESS or stack call status
  */
-static uint8_t Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr)
+bStatus_t Connection_setParamProfile(uint16_t connHandle, uint8_t profile)
 {
-  uint8_t i = 0;
+    gapUpdateLinkParamReq_t paramUpdateReq;
+    App_connCtx *pCtx = Connection_getCtx(connHandle);
+    bStatus_t status;
 
-  for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
-  {
-    if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID)
+    if (pCtx == NULL || profile >= CONN_PARAM_PROFILE_NUM)
+    {
+        return INVALIDPARAMETER;
+    }
+
+    if (pCtx->paramProfile == profile)
     {
-      // Found available entry to put a new connection info in
-      connectionConnList[i].connHandle = connHandle;
-      memcpy(connectionConnList[i].peerAddress, pAddr, B_ADDR_LEN);
+        return SUCCESS;
+    }
 
-      break;
+    paramUpdateReq = connectionParamProfiles[profile];
+    paramUpdateReq.connectionHandle = connHandle;
+
+    status = BLEAppUtil_paramUpdateReq(&paramUpdateReq);
+    if (status == SUCCESS)
+    {
+        pCtx->paramProfile = profile;
     }
-  }
 
-  return i;
+    return status;
 }
 
+#if APP_PHY_POLICY
 /*********************************************************************
- * @fn      Connection_removeConnInfo
+ * @fn      Connection_radioStatsCB
+ *
+ * @brief   Move a link between 2M and Coded PHY from the rolling
+ *          RSSI and error rates of the radio statistics.
  *
- * @brief   Remove a device from the connected device list
+ * @param   connHandle - connection handle
+ * @param   pStats - statistics of the link
  *
- * @return  index of the connected device list entry where the new connection
- *          info is removed from.
- *          If connHandle is not found, MAX_NUM_BLE_CONNS will be returned.
+ * @return  none
  */
-static uint8_t Connection_removeConnInfo(uint16_t connHandle)
+static void Connection_radioStatsCB(uint16_t connHandle, const RadioStats_t *pStats)
 {
-  uint8_t i = 0;
-  uint8_t index = 0;
-  uint8_t maxNumConn = MAX_NUM_BLE_CONNS;
+    App_connCtx *pConn = Connection_getCtx(connHandle);
+    uint16_t errPct = pStats->crcPct + pStats->missPct;
 
-  for (i = 0; i < maxNumConn; i++)
-  {
-    if (connectionConnList[i].connHandle == connHandle)
+    // Wait for enough events on the current PHY
+    if (pConn == NULL || pStats->avgEvents < APP_PHY_POLICY_WINDOW)
+    {
+        return;
+    }
+
+    if (pConn->phy != HCI_PHY_CODED &&
+        (pStats->avgRssi < APP_PHY_CODED_RSSI ||
+         errPct * APP_PHY_CODED_ERR_RATIO > 100))
+    {
+        // Marginal link, trade throughput for range
+        Connection_setPhy(pConn, HCI_PHY_CODED);
+    }
+    else if (pConn->phy == HCI_PHY_CODED && pStats->avgRssi > APP_PHY_2M_RSSI &&
+             errPct * APP_PHY_CODED_ERR_RATIO <= 100)
     {
-      // Mark the entry as deleted
-      connectionConnList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        Connection_setPhy(pConn, HCI_PHY_2_MBPS);
+    }
+}
 
-      break;
+/*********************************************************************
+ * @fn      Connection_setPhy
+ *
+ * @brief   Request a PHY for both directions of a link
+ *
+ * @param   pCtx - connection context
+ * @param   phy - HCI_PHY_2_MBPS or HCI_PHY_CODED
+ *
+ * @return  SUCCESS or stack call status
+ */
+static bStatus_t Connection_setPhy(App_connCtx *pCtx, uint8_t phy)
+{
+    bStatus_t status;
+
+    if (pCtx == NULL || pCtx->phyPending)
+    {
+        return blePending;
+    }
+
+    BLEAppUtil_ConnPhyParams_t phyParams =
+    {
+     .connHandle = pCtx->connHandle,
+     .allPhys = 0,
+     .txPhy = phy,
+     .rxPhy = phy,
+     // Use the S8 coding for the longest range
+     .phyOpts = (phy == HCI_PHY_CODED) ? HCI_PHY_OPT_S8 : HCI_PHY_OPT_NONE
+    };
+
+    status = BLEAppUtil_setConnPhy(&phyParams);
+    if (status == SUCCESS)
+    {
+        pCtx->phyPending = TRUE;
+        LinkReady_expectPhy(phyParams.connHandle);
+        // The command status only tells the opcode, remember the link
+        if (connectionNumPhyCmds < MAX_NUM_BLE_CONNS)
+        {
+            connectionPhyCmdHandles[(connectionPhyCmdFirst + connectionNumPhyCmds) % MAX_NUM_BLE_CONNS] =
+                    phyParams.connHandle;
+            connectionNumPhyCmds++;
+        }
     }
+
+    return status;
+}
+#endif // APP_PHY_POLICY
+
+/*********************************************************************
+ * @fn      Connection_addConnInfo
+ *
+ * @brief   Take a free slot for the context of a new connection
+ *
+ * @param   connHandle - connection handle
+ * @param   pAddr - peer address
+ *
+ * @return  the new context, or NULL when there is no free slot or the
+ *          handle is out of the handle map
+ */
+static App_connCtx *Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr)
+{
+  App_connCtx *pCtx;
+  uint8_t slot;
+
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE || connectionNumFree == 0 ||
+      connectionSlotMap[connHandle] != CONNECTION_SLOT_INVALID)
+  {
+    return NULL;
+  }
+
+  slot = connectionFreeSlots[--connectionNumFree];
+  pCtx = &connectionCtxList[slot];
+
+  memset(pCtx, 0, sizeof(App_connCtx));
+  pCtx->connHandle = connHandle;
+  memcpy(pCtx->peerAddress, pAddr, B_ADDR_LEN);
+  // The central connects with the handshake parameters
+  pCtx->paramProfile = CONN_PARAM_PROFILE_HANDSHAKE;
+  pCtx->phy = HCI_PHY_1_MBPS;
+
+  pCtx->activeIdx = connectionNumActive;
+  connectionActiveSlots[connectionNumActive++] = slot;
+  connectionSlotMap[connHandle] = slot;
+
+  return pCtx;
+}
+
+/*********************************************************************
+ * @fn      Connection_removeConnInfo
+ *
+ * @brief   Release the context slot of a connection. The last active
+ *          link takes the place of the removed one in the list.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+static void Connection_removeConnInfo(uint16_t connHandle)
+{
+  App_connCtx *pCtx = Connection_getCtx(connHandle);
+  uint8_t lastSlot;
+
+  if (pCtx == NULL)
+  {
+    return;
   }
 
-  // Save the index to return
-  index = i;
+  lastSlot = connectionActiveSlots[--connectionNumActive];
+  connectionActiveSlots[pCtx->activeIdx] = lastSlot;
+  connectionCtxList[lastSlot].activeIdx = pCtx->activeIdx;
+
+  connectionFreeSlots[connectionNumFree++] = connectionSlotMap[connHandle];
+  connectionSlotMap[connHandle] = CONNECTION_SLOT_INVALID;
+  pCtx->connHandle = LINKDB_CONNHANDLE_INVALID;
 
-  // Shift the items in the array
-  for(i = 0; i < maxNumConn - 1; i++)
+  // A message left incomplete by the link
+  if (pCtx->pNotiMsg != NULL)
   {
-      if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID &&
-          connectionConnList[i + 1].connHandle == LINKDB_CONNHANDLE_INVALID)
-      {
-        break;
-      }
-      if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID &&
-          connectionConnList[i + 1].connHandle != LINKDB_CONNHANDLE_INVALID)
-      {
-        memmove(&connectionConnList[i], &connectionConnList[i+1], sizeof(App_connInfo));
-        connectionConnList[i + 1].connHandle = LINKDB_CONNHANDLE_INVALID;
-      }
+    ICall_free(pCtx->pNotiMsg);
+    pCtx->pNotiMsg = NULL;
   }
+}
 
-  return index;
+/*********************************************************************
+ * @fn      Connection_getCtx
+ *
+ * @brief   Find the context of a connection
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the connection context, or NULL if the link is unknown
+ */
+App_connCtx *Connection_getCtx(uint16_t connHandle)
+{
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE ||
+      connectionSlotMap[connHandle] == CONNECTION_SLOT_INVALID)
+  {
+    return NULL;
+  }
+
+  return &connectionCtxList[connectionSlotMap[connHandle]];
 }
 
 /*********************************************************************
- * @fn      Connection_getConnList
+ * @fn      Connection_getCtxByIndex
  *
- * @brief   Get the connection list
+ * @brief   Get the context of an entry of the connected device list
  *
- * @return  connection list
+ * @param   index - index in the connected device list
+ *
+ * @return  the connection context, or NULL past the last connection
  */
-App_connInfo *Connection_getConnList(void)
+App_connCtx *Connection_getCtxByIndex(uint8_t index)
 {
-  return connectionConnList;
+  if (index >= connectionNumActive)
+  {
+    return NULL;
+  }
+
+  return &connectionCtxList[connectionActiveSlots[index]];
 }
 
 /*********************************************************************
@@ -433,11 +709,12 @@ App_connInfo *Connection_getConnList(void)
  */
 uint16_t Connection_getConnhandle(uint8_t index)
 {
+  App_connCtx *pCtx = Connection_getCtxByIndex(index);
 
-    if (index < MAX_NUM_BLE_CONNS)
-    {
-      return connectionConnList[index].connHandle;
-    }
+  if (pCtx != NULL)
+  {
+    return pCtx->connHandle;
+  }
 
   return MAX_NUM_BLE_CONNS;
 }
@@ -457,11 +734,18 @@ bStatus_t Connection_start()
     bStatus_t status = SUCCESS;
     uint8 i;
 
-    // Initialize the connList handles
+    // All the slots are free
+    for (i = 0; i < CONNECTION_HANDLE_MAP_SIZE; i++)
+    {
+        connectionSlotMap[i] = CONNECTION_SLOT_INVALID;
+    }
     for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
     {
-        connectionConnList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        connectionCtxList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        connectionFreeSlots[i] = MAX_NUM_BLE_CONNS - 1 - i;
     }
+    connectionNumFree = MAX_NUM_BLE_CONNS;
+    connectionNumActive = 0;
 
     status = BLEAppUtil_registerEventHandler(&connectionConnHandler);
     if(status != SUCCESS)
@@ -475,6 +759,17 @@ bStatus_t Connection_start()
         return(status);
     }
 
+#if APP_PHY_POLICY
+    // The radio statistics of every link feed the PHY policy
+    status = RadioStats_start(Connection_radioStatsCB);
+#elif APP_RADIO_STATS
+    status = RadioStats_start(NULL);
+#endif
+    if(status != SUCCESS)
+    {
+        return(status);
+    }
+
     status = BLEAppUtil_registerEventHandler(&PairingecckeyHandler);
     if(status != SUCCESS)
     {
@@ -495,24 +790,21 @@ bStatus_t Connection_start()
 /*********************************************************************
  * @fn      Connection_getConnIndex
  *
- * @brief   Find index in the connected device list by connHandle
+ * @brief   Find the context slot of a connection. The slot does not
+ *          change while the link is up.
  *
- * @return  the index of the entry that has the given connection handle.
+ * @return  the slot of the given connection handle.
  *          if there is no match, LL_INACTIVE_CONNECTIONS will be returned.
  */
 uint16_t Connection_getConnIndex(uint16_t connHandle)
 {
-  uint8_t i;
-
-  for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE ||
+      connectionSlotMap[connHandle] == CONNECTION_SLOT_INVALID)
   {
-    if (connectionConnList[i].connHandle == connHandle)
-    {
-      return i;
-    }
+    return LL_INACTIVE_CONNECTIONS;
   }
 
-  return LL_INACTIVE_CONNECTIONS;
+  return connectionSlotMap[connHandle];
 }
 
 #endif // ( HOST_CONFIG & (CENTRAL_CFG | PERIPHERAL_CFG) )
@@ -0,0 +1,189 @@
+/******************************************************************************
+
+@file  app_crypto_ctx.h
+
+@brief This file contains the certificate layout and the interface of
+       the verification context
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef APP_CRYPTO_CTX_H_
+#define APP_CRYPTO_CTX_H_
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// The context does not depend on the BLE stack: build it with
+// CRYPTO_CTX_HOST defined and tools/host_crypto/include in the include path
+// to run it on a PC, SHA2 and ECDSA then come from the software backend of
+// tools/host_crypto.
+
+// Certificate: id, data, public key X || Y, signature r || s over the
+// SHA256 of the public key
+#define APP_CERT_LEN                137
+#define CERT_DATA_LEN               8
+#define CERT_PUBLIC_KEY_OFFSET      9
+#define CERT_PUBLIC_KEY_LEN         64
+#define CERT_SIGNATURE_OFFSET       73
+#define CERT_SIGNATURE_S_OFFSET     105
+#define CERT_SIGNATURE_LEN          64
+// SHA256 digest
+#define CRYPTO_CTX_DIGEST_LEN       32
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// View of a certificate laid over the buffer it was received in, a
+// notification, a characteristic value or the certificate store. Bytes
+// only, so it has no padding and can be laid over any address.
+typedef struct
+{
+    uint8_t id;
+    uint8_t data[CERT_DATA_LEN];
+    uint8_t publicKey[CERT_PUBLIC_KEY_LEN];     // X || Y
+    uint8_t r[CRYPTO_CTX_DIGEST_LEN];
+    uint8_t s[CRYPTO_CTX_DIGEST_LEN];
+}CertView_t;
+
+_Static_assert(offsetof(CertView_t, publicKey) == CERT_PUBLIC_KEY_OFFSET, "certificate public key offset");
+_Static_assert(offsetof(CertView_t, r) == CERT_SIGNATURE_OFFSET, "certificate signature r offset");
+_Static_assert(offsetof(CertView_t, s) == CERT_SIGNATURE_S_OFFSET, "certificate signature s offset");
+_Static_assert(sizeof(CertView_t) == APP_CERT_LEN, "certificate length");
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CryptoCtx_hash
+ *
+ * @brief   SHA256 of a buffer
+ *
+ * @param   pData - data to hash
+ * @param   len - length of the data
+ * @param   pDigest - CRYPTO_CTX_DIGEST_LEN bytes output
+ *
+ * @return  SHA2_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_hash(const uint8_t *pData, uint16_t len, uint8_t *pDigest);
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyDigest
+ *
+ * @brief   ECDSA P-256 verification of a digest
+ *
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes public key X || Y
+ * @param   pDigest - CRYPTO_CTX_DIGEST_LEN bytes digest
+ * @param   pSignature - 64 bytes signature r || s
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyDigest(const uint8_t *pPublicKey, const uint8_t *pDigest,
+                                    const uint8_t *pSignature);
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyData
+ *
+ * @brief   ECDSA P-256 verification of the SHA256 of a buffer
+ *
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes public key X || Y
+ * @param   pData - signed data
+ * @param   len - length of the data
+ * @param   pSignature - 64 bytes signature r || s
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyData(const uint8_t *pPublicKey, const uint8_t *pData, uint16_t len,
+                                  const uint8_t *pSignature);
+
+/*********************************************************************
+ * @fn      CryptoCtx_lockEcdsa
+ *
+ * @brief   Wait until the ECDSA driver is free and hold it, around
+ *          every ECDSA_open / ECDSA_close outside of this module
+ *
+ * @return  none
+ */
+void CryptoCtx_lockEcdsa(void);
+
+/*********************************************************************
+ * @fn      CryptoCtx_unlockEcdsa
+ *
+ * @brief   Release the ECDSA driver held with CryptoCtx_lockEcdsa
+ *
+ * @return  none
+ */
+void CryptoCtx_unlockEcdsa(void);
+
+/*********************************************************************
+ * @fn      CertView_parse
+ *
+ * @brief   View of the certificate at the start of a received buffer,
+ *          nothing is copied
+ *
+ * @param   pBuf - received buffer
+ * @param   len - length of the buffer
+ *
+ * @return  view over pBuf, or NULL when the buffer is shorter than a
+ *          certificate
+ */
+const CertView_t *CertView_parse(const uint8_t *pBuf, uint16_t len);
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyCert
+ *
+ * @brief   Verify the signature of a certificate over its public key,
+ *          hashed and verified in place
+ *
+ * @param   pCert - certificate
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes key of the signer
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyCert(const CertView_t *pCert, const uint8_t *pPublicKey);
+
+#endif /* APP_CRYPTO_CTX_H_ */
@@ -0,0 +1,297 @@
+/******************************************************************************
+
+@file  app_crypto_prof.c
+
+@brief This file contains the crypto operation profiler
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#ifdef CRYPTO_CTX_HOST
+// clock_gettime with -std=c11
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <string.h>
+#ifdef CRYPTO_CTX_HOST
+#include <time.h>
+#include <app_crypto_prof.h>
+#else
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/devices/DeviceFamily.h>
+#include DeviceFamily_constructPath(inc/hw_types.h)
+#include DeviceFamily_constructPath(inc/hw_memmap.h)
+#include DeviceFamily_constructPath(inc/hw_systim.h)
+#endif
+
+#if APP_CRYPTO_PROF
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#ifdef CRYPTO_CTX_HOST
+#define CRYPTO_PROF_NS_PER_TICK     1
+#else
+// SYSTIM TIME250N, always on and independent of the ClockP tick
+#define CRYPTO_PROF_NS_PER_TICK     250
+#endif
+
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static CryptoProf_stats_t cryptoProfStats[CRYPTO_PROF_NUM];
+
+static const char * const cryptoProfNames[CRYPTO_PROF_NUM] =
+{
+    "SHA2_hashData",
+    "ECDSA_verify",
+    "TA010 Nonce",
+    "TA010 Sign",
+    "SCGetLocalOOB"
+};
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CryptoProf_start
+ *
+ * @brief   Timestamp of the start of an operation
+ *
+ * @return  timestamp for CryptoProf_stop
+ */
+uint32_t CryptoProf_start(void)
+{
+#ifdef CRYPTO_CTX_HOST
+    struct timespec ts;
+
+    // Wraps every 4.3 s, far longer than any operation
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+#else
+    return HWREG(SYSTIM_BASE + SYSTIM_O_TIME250N);
+#endif
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_stop
+ *
+ * @brief   Add the duration of an operation to its statistics
+ *
+ * @param   op - one of CryptoProf_ops
+ * @param   start - timestamp returned by CryptoProf_start
+ *
+ * @return  none
+ */
+void CryptoProf_stop(uint8_t op, uint32_t start)
+{
+    CryptoProf_stats_t *pStats;
+    uint64_t ticks = (uint32_t)(CryptoProf_start() - start);
+    uint32_t ns;
+    uint32_t us;
+    uint8_t bucket = 0;
+#ifndef CRYPTO_CTX_HOST
+    uintptr_t key;
+#endif
+
+    if (op >= CRYPTO_PROF_NUM)
+    {
+        return;
+    }
+
+    ns = (ticks * CRYPTO_PROF_NS_PER_TICK > UINT32_MAX) ? UINT32_MAX : (uint32_t)(ticks * CRYPTO_PROF_NS_PER_TICK);
+    for (us = ns / 1000; us > 1 && bucket < CRYPTO_PROF_BUCKETS - 1; us >>= 1)
+    {
+        bucket++;
+    }
+
+#ifndef CRYPTO_CTX_HOST
+    // The TA010 Sign task records its commands too
+    key = HwiP_disable();
+#endif
+    pStats = &cryptoProfStats[op];
+    if (pStats->count == 0 || ns < pStats->minNs)
+    {
+        pStats->minNs = ns;
+    }
+    if (ns > pStats->maxNs)
+    {
+        pStats->maxNs = ns;
+    }
+    pStats->count++;
+    pStats->totalNs += ns;
+    pStats->hist[bucket]++;
+#ifndef CRYPTO_CTX_HOST
+    HwiP_restore(key);
+#endif
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_get
+ *
+ * @brief   Statistics of an operation
+ *
+ * @param   op - one of CryptoProf_ops
+ *
+ * @return  statistics, or NULL for an unknown operation
+ */
+const CryptoProf_stats_t *CryptoProf_get(uint8_t op)
+{
+    return (op < CRYPTO_PROF_NUM) ? &cryptoProfStats[op] : NULL;
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_getPercentileUs
+ *
+ * @brief   Upper bound of the histogram bucket holding a percentile
+ *
+ * @param   op - one of CryptoProf_ops
+ * @param   percent - 1 to 100
+ *
+ * @return  bound in microseconds, 0 when the operation never ran,
+ *          UINT32_MAX in the open ended bucket
+ */
+uint32_t CryptoProf_getPercentileUs(uint8_t op, uint8_t percent)
+{
+    uint32_t total;
+    uint32_t sum = 0;
+    uint32_t rank;
+    uint8_t bucket;
+
+    if (op >= CRYPTO_PROF_NUM)
+    {
+        return 0;
+    }
+
+    // Every sample is in one bucket, they add up to count
+    total = cryptoProfStats[op].count;
+    rank = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+
+    for (bucket = 0; bucket < CRYPTO_PROF_BUCKETS && total != 0; bucket++)
+    {
+        sum += cryptoProfStats[op].hist[bucket];
+        if (sum >= rank)
+        {
+            return (bucket == CRYPTO_PROF_BUCKETS - 1) ? UINT32_MAX : (2UL << bucket);
+        }
+    }
+
+    return 0;
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_getName
+ *
+ * @brief   Name of an operation, for the reports
+ *
+ * @param   op - one of CryptoProf_ops
+ *
+ * @return  name
+ */
+const char *CryptoProf_getName(uint8_t op)
+{
+    return (op < CRYPTO_PROF_NUM) ? cryptoProfNames[op] : "?";
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_reset
+ *
+ * @brief   Clear the statistics of all operations
+ *
+ * @return  none
+ */
+void CryptoProf_reset(void)
+{
+    memset(cryptoProfStats, 0, sizeof(cryptoProfStats));
+}
+
+#ifndef CRYPTO_CTX_HOST
+/*********************************************************************
+ * @fn      CryptoProf_getLocalOob
+ *
+ * @brief   GAPBondMgr_SCGetLocalOOBParameters that records its duration
+ *
+ * @param   pLocalOobData - filled with the new local OOB data
+ *
+ * @return  status of GAPBondMgr_SCGetLocalOOBParameters
+ */
+bStatus_t CryptoProf_getLocalOob(gapBondOOBData_t *pLocalOobData)
+{
+    uint32_t start = CryptoProf_start();
+    bStatus_t status = GAPBondMgr_SCGetLocalOOBParameters(pLocalOobData);
+
+    CryptoProf_stop(CRYPTO_PROF_OOB_PARAMS, start);
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      CryptoProf_print
+ *
+ * @brief   Print the statistics on the menu, one line per operation
+ *
+ * @return  none
+ */
+void CryptoProf_print(void)
+{
+    const CryptoProf_stats_t *pStats;
+    uint32_t avgNs;
+    uint8_t op;
+
+    for (op = 0; op < CRYPTO_PROF_NUM; op++)
+    {
+        pStats = &cryptoProfStats[op];
+        avgNs = pStats->count ? (uint32_t)(pStats->totalNs / pStats->count) : 0;
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1 + op, 0, "%s: n = %d avg = %d us (%d cycles) "
+                          "min = %d max = %d us - p50 < %d p90 < %d us",
+                          cryptoProfNames[op], pStats->count, avgNs / 1000,
+                          (uint32_t)((uint64_t)avgNs * CRYPTO_PROF_CPU_MHZ / 1000),
+                          pStats->minNs / 1000, pStats->maxNs / 1000,
+                          CryptoProf_getPercentileUs(op, 50), CryptoProf_getPercentileUs(op, 90));
+    }
+}
+#endif
+
+#endif // APP_CRYPTO_PROF
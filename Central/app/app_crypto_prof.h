@@ -0,0 +1,168 @@
+/******************************************************************************
+
+@file  app_crypto_prof.h
+
+@brief This file contains the crypto operation profiler definitions and
+       prototypes
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef APP_CRYPTO_PROF_H_
+#define APP_CRYPTO_PROF_H_
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Crypto operation profiler: duration of every SHA2_hashData, ECDSA_verify,
+// TA010 command and GAPBondMgr_SCGetLocalOOBParameters call, with a
+// histogram per operation in fixed memory. On the target the time base is
+// the 250 ns SYSTIM timer: the Cortex-M0+ has no DWT cycle counter, so the
+// cycles are derived from it at CRYPTO_PROF_CPU_MHZ. Built with
+// CRYPTO_CTX_HOST the profiler does not depend on the BLE stack and uses
+// the monotonic clock of the PC.
+#ifndef APP_CRYPTO_PROF
+#define APP_CRYPTO_PROF             1
+#endif
+// Histogram buckets: bucket 0 below 2 us, bucket b from 2^b to 2^(b+1) us,
+// the last one open ended (above 0.5 s)
+#define CRYPTO_PROF_BUCKETS         20
+// CPU clock, for the cycle counts
+#define CRYPTO_PROF_CPU_MHZ         48
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Profiled operations
+typedef enum
+{
+    CRYPTO_PROF_SHA2_HASH,          // SHA2_hashData
+    CRYPTO_PROF_ECDSA_VERIFY,       // ECDSA_verify
+    CRYPTO_PROF_TA010_NONCE,        // TA010 Nonce command
+    CRYPTO_PROF_TA010_SIGN,         // TA010 Sign command
+    CRYPTO_PROF_OOB_PARAMS,         // GAPBondMgr_SCGetLocalOOBParameters
+    CRYPTO_PROF_NUM
+}CryptoProf_ops;
+
+// Statistics of an operation since boot or the last reset
+typedef struct
+{
+    uint32_t count;
+    uint32_t minNs;
+    uint32_t maxNs;
+    uint64_t totalNs;
+    uint32_t hist[CRYPTO_PROF_BUCKETS];
+}CryptoProf_stats_t;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CryptoProf_start
+ *
+ * @brief   Timestamp of the start of an operation
+ *
+ * @return  timestamp for CryptoProf_stop
+ */
+uint32_t CryptoProf_start(void);
+
+/*********************************************************************
+ * @fn      CryptoProf_stop
+ *
+ * @brief   Add the duration of an operation to its statistics
+ *
+ * @param   op - one of CryptoProf_ops
+ * @param   start - timestamp returned by CryptoProf_start
+ *
+ * @return  none
+ */
+void CryptoProf_stop(uint8_t op, uint32_t start);
+
+/*********************************************************************
+ * @fn      CryptoProf_get
+ *
+ * @brief   Statistics of an operation
+ *
+ * @param   op - one of CryptoProf_ops
+ *
+ * @return  statistics, or NULL for an unknown operation
+ */
+const CryptoProf_stats_t *CryptoProf_get(uint8_t op);
+
+/*********************************************************************
+ * @fn      CryptoProf_getPercentileUs
+ *
+ * @brief   Upper bound of the histogram bucket holding a percentile
+ *
+ * @param   op - one of CryptoProf_ops
+ * @param   percent - 1 to 100
+ *
+ * @return  bound in microseconds, 0 when the operation never ran,
+ *          UINT32_MAX in the open ended bucket
+ */
+uint32_t CryptoProf_getPercentileUs(uint8_t op, uint8_t percent);
+
+/*********************************************************************
+ * @fn      CryptoProf_getName
+ *
+ * @brief   Name of an operation, for the reports
+ *
+ * @param   op - one of CryptoProf_ops
+ *
+ * @return  name
+ */
+const char *CryptoProf_getName(uint8_t op);
+
+/*********************************************************************
+ * @fn      CryptoProf_reset
+ *
+ * @brief   Clear the statistics of all operations
+ *
+ * @return  none
+ */
+void CryptoProf_reset(void);
+
+#endif /* APP_CRYPTO_PROF_H_ */
@@ -48,26 +48,29 @@ Target Device: cc23xx
 //! Includes
 //*****************************************************************************
 #include <string.h>
+#include <icall.h>
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
+#include <app_nonce_pool.h>
 #include <ti/bleapp/profiles/simple_gatt/simple_gatt_profile.h>
 
 #include <ti/drivers/SHA2.h>
 #include <ti/drivers/ECDSA.h>
-#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
-//*****************************************************************************
-//! Defines
-//*****************************************************************************
- #define SHA2_INSTANCE 0
 //*****************************************************************************
 //! Globals
 //*****************************************************************************
-gapBondOOBData_t remoteOobData;
-
 static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 static void Verify_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
-static void Challenge_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+static void Verify_processMsg(uint16_t connHandle, uint8_t *pMsg, uint16_t len);
+static void Challenge_processMsg(uint16_t connHandle, App_connCtx *pCtx, uint8_t *pMsg, uint16_t len);
+static void Data_startAuthentication(uint16_t connHandle, App_connCtx *pCtx);
+static void Data_authenticated(uint16_t connHandle, uint8_t role);
+#if APP_CERT_CHAIN
+static void Data_chainVerified(uint16_t connHandle, int_fast16_t status);
+#endif
+static void Data_linkReadyCB(uint16_t connHandle);
+static void Data_setRemoteOob(App_connCtx *pCtx, uint8_t *pValue);
 // Events handlers struct, contains the handlers and event masks
 // of the application data module
 BLEAppUtil_EventHandler_t dataGATTHandler =
@@ -77,6 +80,7 @@ BLEAppUtil_EventHandler_t dataGATTHandler =
     .eventMask      = BLEAPPUTIL_ATT_FLOW_CTRL_VIOLATED_EVENT |
                       BLEAPPUTIL_ATT_MTU_UPDATED_EVENT |
                       BLEAPPUTIL_ATT_READ_RSP |
+                      BLEAPPUTIL_ATT_READ_BLOB_RSP |
                       BLEAPPUTIL_ATT_WRITE_CMD |
                       BLEAPPUTIL_ATT_WRITE_REQ |
                       BLEAPPUTIL_ATT_EXCHANGE_MTU_RSP |
@@ -90,14 +94,6 @@ BLEAppUtil_EventHandler_t verifyHandler =
     .eventMask      = BLEAPPUTIL_ATT_HANDLE_VALUE_NOTI
 };
 
-BLEAppUtil_EventHandler_t challengeHandler =
-{
-    .handlerType    = BLEAPPUTIL_GATT_TYPE,
-    .pEventHandler  = Challenge_EventHandler,
-    .eventMask      = BLEAPPUTIL_ATT_READ_RSP |
-                      BLEAPPUTIL_ATT_HANDLE_VALUE_NOTI
-};
-
 // ECDSA param
 //uint8_t signerPrivateKeyingMaterial[32] = {0x80, 0x6B, 0xA4, 0x5D, 0x93, 0x02, 0x48, 0xD5, 0x33, 0x31,
 //                                           0x87, 0xE5, 0xDD, 0xE7, 0x4C, 0x06, 0x24, 0xDB, 0x71, 0x00,
@@ -109,34 +105,6 @@ BLEAppUtil_EventHandler_t challengeHandler =
 //                                           0x0C, 0xF9, 0x24, 0x1D, 0x9D, 0xE5, 0x8C, 0xCE, 0x2A, 0xB5,
 //                                           0x2D, 0xC5};
 
-uint8_t signerCert[137] = {0x02, // signer Certificate id
-                           0x3E, 0x12, 0xCB, 0x3D, 0x01, 0x32, 0x36, 0x6F, //8 bytes data
-                           0xC4, 0xBC, 0x58, 0x1D, 0xAE, 0xA6, 0xB6, 0x44, 0x15, 0xBE, 0x3E, // public key X
-                           0x1F, 0x59, 0x8B, 0x83, 0xBA, 0x17, 0x57, 0xD6, 0x1A, 0x81, 0xB9,
-                           0xD1, 0xD6, 0xAB, 0xF6, 0xDF, 0x6D, 0xFD, 0xEE, 0x89, 0x24,
-                           0x2F, 0xB7, 0x2B, 0x22, 0x54, 0xDF, 0x99, 0x1E, 0x7D, 0xF3, 0xAD, // public key Y
-                           0x88, 0xA5, 0x99, 0x51, 0x4D, 0xF7, 0x4C, 0x91, 0x09, 0x06, 0x47,
-                           0x20, 0x77, 0x4B, 0x7E, 0x3A, 0xB4, 0x2D, 0xC0, 0x08, 0xBA,
-                           0x84, 0xE6, 0x0D, 0x13, 0x37, 0xAB, 0x47, 0xDA, 0xA9, 0x5E, 0x2D, // signature R + S
-                           0xBA, 0x80, 0x7A, 0x10, 0x99, 0x9A, 0x15, 0xAF, 0x92, 0x22, 0x1C,
-                           0xC1, 0x3B, 0xE7, 0x22, 0x6F, 0x74, 0xAF, 0x69, 0x67, 0x00, 0x5B,
-                           0x84, 0xD9, 0x8F, 0x0B, 0x30, 0x3F, 0xEC, 0xD0, 0x4D, 0xA4, 0x05,
-                           0x15, 0x43, 0x87, 0xC9, 0xEF, 0x01, 0xBB, 0x8E, 0x87, 0x39, 0x20,
-                           0x57, 0x84, 0x50, 0x9D, 0x63, 0xC6, 0x2C, 0x87, 0x56};  // store the local signer certificates
-uint8_t deviceCert[137] = {0x01, // device Certificate id
-                           0x74, 0x79, 0x41, 0x3A, 0x50, 0xEF, 0x4B, 0x34, // 8 bytes data
-                           0xBB, 0x12, 0xBF, 0xEF, 0x48, 0xE8, 0xAC, 0x5E, 0x54, 0x07, 0x90, // public key X
-                           0xA9, 0x58, 0xD0, 0x99, 0xC4, 0xA7, 0xEF, 0x31, 0x58, 0xD4, 0xBD,
-                           0xAF, 0x3A, 0x86, 0x8C, 0x33, 0x96, 0x1D, 0x73, 0x45, 0x90,
-                           0x74, 0xC2, 0xC9, 0x63, 0xB4, 0xA0, 0xE2, 0xDC, 0xF6, 0x96, 0x02, // public key Y
-                           0xBA, 0xDF, 0xFC, 0x8E, 0x5D, 0x40, 0x7A, 0xEF, 0x61, 0xEE, 0x98,
-                           0x61, 0xFB, 0xB1, 0x2A, 0x9C, 0x46, 0xA9, 0x99, 0x50, 0x46,
-                           0x1F, 0x2A, 0x03, 0x4A, 0x0C, 0xCE, 0xDC, 0x97, 0xC8, 0x83, 0x55, // signature R + S
-                           0x3D, 0x08, 0x4D, 0x4C, 0x5D, 0xDA, 0x46, 0x44, 0x65, 0xBB, 0x47,
-                           0x37, 0x49, 0x4A, 0xE4, 0xE2, 0x09, 0x5D, 0xA5, 0x0F, 0x52, 0x91,
-                           0x29, 0xCD, 0xD4, 0xD1, 0xEA, 0xE3, 0xFC, 0x1B, 0xBC, 0xA7, 0x37,
-                           0xC7, 0xA9, 0x15, 0xB6, 0x79, 0xC6, 0xB6, 0x9F, 0x18, 0xE6, 0x15,
-                           0x59, 0xAB, 0x02, 0xD2, 0xF5, 0xE6, 0xDB, 0x16, 0xF5};   // store the local device certificates
 //*****************************************************************************
 //! Functions
 //*****************************************************************************
@@ -156,6 +124,7 @@ uint8_t deviceCert[137] = {0x01, // device Certificate id
 static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 {
   gattMsgEvent_t *gattMsg = ( gattMsgEvent_t * )pMsgData;
+  App_connCtx *pCtx = Connection_getCtx(gattMsg->connHandle);
   switch ( gattMsg->method )
   {
     case ATT_FLOW_CTRL_VIOLATED_EVENT:
@@ -168,7 +137,8 @@ static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
       {
 //          MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "GATT status: ATT MTU update to %d",
 //                            gattMsg->msg.mtuEvt.MTU);
-          doAttReadReq(37, 1);
+          // The transfers start from Data_linkReadyCB
+          LinkReady_setMtu(gattMsg->connHandle, gattMsg->msg.mtuEvt.MTU);
       }
       break;
 
@@ -188,27 +158,32 @@ static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 
     case ATT_READ_RSP:
 
-        if (gattMsg->msg.readRsp.len == 32)
+        if (pCtx != NULL && gattMsg->msg.readRsp.len == SIMPLEGATTPROFILE_CHAR1_LEN)
         {
-            MenuModule_printf(APP_MENU_CONN_EVENT, 0, "OOB data = 0x%02x 0x%02x 0x%02x 0x%02x 0x%02x ",
-                              gattMsg->msg.readRsp.pValue[0], gattMsg->msg.readRsp.pValue[1], gattMsg->msg.readRsp.pValue[2],
-                              gattMsg->msg.readRsp.pValue[3], gattMsg->msg.readRsp.pValue[4]);
-
-            uint8_t oobEnabled = TRUE;
-            GAPBondMgr_SetParameter(GAPBOND_OOB_ENABLED, sizeof(uint8_t), &oobEnabled);
+            Data_setRemoteOob(pCtx, gattMsg->msg.readRsp.pValue);
 
-            for (int i = 0; i < 16; i++) {
-                remoteOobData.confirm[i] = gattMsg->msg.readRsp.pValue[i];
-            }
+            Data_startAuthentication(gattMsg->connHandle, pCtx);
+        }
+        break;
 
-            for (int i = 0; i < 16; i++) {
-                remoteOobData.rand[i] = gattMsg->msg.readRsp.pValue[i + 16];
+    case ATT_READ_BLOB_RSP:
+        if (pCtx == NULL)
+        {
+            break;
+        }
+        if (gattMsg->hdr.status == bleProcedureComplete)
+        {
+            if (pCtx->remoteOobLen == SIMPLEGATTPROFILE_CHAR1_LEN)
+            {
+                Data_setRemoteOob(pCtx, pCtx->remoteOobValue);
+                Data_startAuthentication(gattMsg->connHandle, pCtx);
             }
-            GAPBondMgr_SCSetRemoteOOBParameters(&remoteOobData, 1);
-
-            // send the signer cert req to tpms
-            uint8_t signerCertReqCmd[2] = {5, 3};
-            doAttWriteNoRsp(43, signerCertReqCmd, sizeof(signerCertReqCmd));
+        }
+        else if (pCtx->remoteOobLen + gattMsg->msg.readBlobRsp.len <= SIMPLEGATTPROFILE_CHAR1_LEN)
+        {
+            memcpy(&pCtx->remoteOobValue[pCtx->remoteOobLen], gattMsg->msg.readBlobRsp.pValue,
+                   gattMsg->msg.readBlobRsp.len);
+            pCtx->remoteOobLen += gattMsg->msg.readBlobRsp.len;
         }
         break;
 
@@ -232,6 +207,176 @@ static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
   }
 }
 
+/*********************************************************************
+ * @fn      Data_setRemoteOob
+ *
+ * @brief   Keep the confirm and random values read from
+ *          Characteristic 1 of the peer for the pairing of the link
+ *
+ * @param   pCtx - connection context
+ * @param   pValue - SIMPLEGATTPROFILE_CHAR1_LEN bytes, confirm then random
+ *
+ * @return  none
+ */
+static void Data_setRemoteOob(App_connCtx *pCtx, uint8_t *pValue)
+{
+    MenuModule_printf(APP_MENU_CONN_EVENT, 0, "OOB data = 0x%02x 0x%02x 0x%02x 0x%02x 0x%02x ",
+                      pValue[0], pValue[1], pValue[2], pValue[3], pValue[4]);
+
+    memcpy(pCtx->remoteOob.confirm, pValue, KEYLEN);
+    memcpy(pCtx->remoteOob.rand, &pValue[KEYLEN], KEYLEN);
+}
+
+/*********************************************************************
+ * @fn      Data_linkReadyCB
+ *
+ * @brief   Called once the MTU, data length and PHY of the link are
+ *          negotiated, or the negotiation timed out. Starts the
+ *          OOB and certificate traffic.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+static void Data_linkReadyCB(uint16_t connHandle)
+{
+    App_connCtx *pCtx = Connection_getCtx(connHandle);
+
+    if (pCtx == NULL)
+    {
+        return;
+    }
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "Certificate transfer: %s",
+                      (LinkReady_getStrategy(connHandle, APP_CERT_LEN) == LINK_XFER_SINGLE_PACKET) ? "single packet" :
+                      (LinkReady_getStrategy(connHandle, APP_CERT_LEN) == LINK_XFER_LL_FRAGMENTS) ? "LL fragments" :
+                      "ATT fragments");
+
+    if (Central_getPeerOob(connHandle, &pCtx->remoteOob))
+    {
+        // The OOB data already came with the advertising data
+        Data_startAuthentication(connHandle, pCtx);
+    }
+    else
+    {
+        // The OOB data does not fit in one Read Response at small ATT_MTU
+        if (LinkReady_getMtu(connHandle) - 1 < SIMPLEGATTPROFILE_CHAR1_LEN)
+        {
+            pCtx->remoteOobLen = 0;
+            doAttReadLongReq(connHandle, 37, 1);
+        }
+        else
+        {
+            doAttReadReq(connHandle, 37, 1);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      Data_startAuthentication
+ *
+ * @brief   Start the authentication, either with the single round
+ *          mutual challenge-response or by requesting the signer
+ *          certificate from the peripheral and sending our challenge.
+ *
+ * @param   connHandle - connection handle
+ * @param   pCtx - connection context
+ *
+ * @return  none
+ */
+static void Data_startAuthentication(uint16_t connHandle, App_connCtx *pCtx)
+{
+#if APP_MUTUAL_AUTH
+    MutualAuth_start(connHandle, MUTUAL_AUTH_ROLE_CENTRAL);
+#else
+#if APP_CERT_CHAIN
+    // The chain of the peripheral is verified as it arrives
+    CertChain_request(connHandle);
+#else
+    // send the signer cert req to tpms
+    uint8_t signerCertReqCmd[2] = {5, 3};
+    doAttWriteNoRsp(connHandle, 43, signerCertReqCmd, sizeof(signerCertReqCmd));
+#endif
+
+    /*
+     * Send our challenge right away, so the TA010 of the peripheral signs
+     * it while the certificates are verified
+     */
+    uint8_t nonceId = 0x03;
+    if (NoncePool_get(pCtx->challengeNonce) == NONCE_POOL_SUCCESS)
+    {
+        // Id and nonce are written straight in the stack buffer
+        Frag_begin(connHandle, 50, ATT_WRITE_CMD, 1 + APP_NONCE_LEN);
+        Frag_write(&nonceId, 1);
+        Frag_write(pCtx->challengeNonce, APP_NONCE_LEN);
+        bStatus_t status = Frag_end();
+        MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttWriteCmd = "
+                          MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
+                          status);
+    }
+#endif
+}
+
+/*********************************************************************
+ * @fn      Data_authenticated
+ *
+ * @brief   The peer of a link passed the challenge, pair the link.
+ *
+ * @param   connHandle - connection handle
+ * @param   role - MUTUAL_AUTH_ROLE_CENTRAL
+ *
+ * @return  none
+ */
+static void Data_authenticated(uint16_t connHandle, uint8_t role)
+{
+    App_connCtx *pCtx = Connection_getCtx(connHandle);
+
+    if (pCtx == NULL || role != MUTUAL_AUTH_ROLE_CENTRAL)
+    {
+        return;
+    }
+
+    Central_peerAuthenticated(connHandle);
+    Pairing_request(connHandle);
+}
+
+#if APP_CERT_CHAIN
+/*********************************************************************
+ * @fn      Data_chainVerified
+ *
+ * @brief   The certificate chain of the peripheral was verified or
+ *          rejected. Once verified, our certificates are sent as after
+ *          the device certificate of the two certificate exchange.
+ *
+ * @param   connHandle - connection handle
+ * @param   status - ECDSA_STATUS_SUCCESS or the error of the rejected
+ *          certificate
+ *
+ * @return  none
+ */
+static void Data_chainVerified(uint16_t connHandle, int_fast16_t status)
+{
+    if (status != ECDSA_STATUS_SUCCESS)
+    {
+        return;
+    }
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE3, 0, "device verify status = %d", status);
+    doAttWriteNoRsp(connHandle, 43, CertStore_get(CERT_STORE_SIGNER), APP_CERT_LEN);
+}
+#endif
+
+/*********************************************************************
+ * @fn      Verify_EventHandler
+ *
+ * @brief   Reassemble the notifications of the peripheral and hand the
+ *          complete messages to the certificate and challenge handling
+ *
+ * @param   event - message event.
+ * @param   pMsgData - pointer to message data.
+ *
+ * @return  none
+ */
 static void Verify_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 {
     gattMsgEvent_t *gattMsg = ( gattMsgEvent_t * )pMsgData;
@@ -239,151 +384,36 @@ static void Verify_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     {
         case ATT_HANDLE_VALUE_NOTI:
         {
-            if (gattMsg->msg.handleValueNoti.pValue[0] == 2) //verify signer certificate
-            {
-                uint8_t signerPublicKeyingMaterial[65] = {0};
-                signerPublicKeyingMaterial[0] = 4;
-                memcpy(&signerPublicKeyingMaterial[1], &signerCert[9], 64);
-
-                uint8_t r[32] = {0};
-                uint8_t s[32] = {0};
-                int_fast16_t shaResult;
-                int_fast16_t verifyResult;
-                // SHA256 signer public key
-                SHA2_Params params;
-                SHA2_Handle handle;
-                uint8_t message[64] = {0};
-                for (int i = 0 ; i < 64 ; i++)
-                {
-                    message[i] = gattMsg->msg.handleValueNoti.pValue[ 9 + i ];
-                }
-                uint8_t shaDigest[32]; // 32 bytes hash values
-                SHA2_init();
-                SHA2_Params_init(&params);
-                handle = SHA2_open(SHA2_INSTANCE, NULL);
-
-                shaResult = SHA2_hashData(handle, message, sizeof(message), shaDigest);
-                SHA2_close(handle);
-
-                // ecdsa verify signer certificate
-                for (int i = 0; i < 32; i++) {
-                    r[i] = gattMsg->msg.handleValueNoti.pValue[73 + i];
-                    s[i] = gattMsg->msg.handleValueNoti.pValue[105 + i];
-                }
-                CryptoKey signerPublicKey;
-                ECDSA_Handle ecdsaHandle;
-                ECDSA_Params ecdsaParams;
-                ECDSA_OperationVerify operationVerify;
-
-                ECDSA_init();
-                ECDSA_Params_init(&ecdsaParams);
-                ecdsaHandle = ECDSA_open(0, NULL);
-                CryptoKeyPlaintext_initKey(&signerPublicKey,
-                                           signerPublicKeyingMaterial,
-                                           sizeof(signerPublicKeyingMaterial));
-
-                ECDSA_OperationVerify_init(&operationVerify);
-                operationVerify.curve           = &ECCParams_NISTP256;
-                operationVerify.theirPublicKey  = &signerPublicKey;
-                operationVerify.hash            = shaDigest;
-                operationVerify.r               = r;
-                operationVerify.s               = s;
-
-                verifyResult = ECDSA_verify(ecdsaHandle, &operationVerify);
-                if (verifyResult == ECDSA_STATUS_SUCCESS)
-                {
-                    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0 ,"signer verify status = %d", verifyResult);
-                    ECDSA_close(ecdsaHandle);
-                    uint8_t deviceCertReqCmd[2] = {6, 3};
-                    doAttWriteNoRsp(40, deviceCertReqCmd, sizeof(deviceCertReqCmd));
-                }
-            }
-            else if (gattMsg->msg.handleValueNoti.pValue[0] == 1) //verify device certificate
+            App_connCtx *pCtx = Connection_getCtx(gattMsg->connHandle);
+            uint8_t *pMsg = gattMsg->msg.handleValueNoti.pValue;
+            uint16_t len = gattMsg->msg.handleValueNoti.len;
+            uint8_t isFragment = Frag_isFragment(pMsg, len);
+            uint8_t rxStatus;
+
+            if (pCtx == NULL)
             {
-                uint8_t devicePublicKeyingMaterial[65] = {0};
-                devicePublicKeyingMaterial[0] = 4;
-                memcpy(&devicePublicKeyingMaterial[1], &deviceCert[9], 64);
-
-                uint8_t r[32] = {0};
-                uint8_t s[32] = {0};
-                int_fast16_t shaResult;
-                int_fast16_t verifyResult;
-                // SHA256 signer public key
-                SHA2_Params params;
-                SHA2_Handle handle;
-                uint8_t message[64] = {0};
-                for (int i = 0 ; i < 64 ; i++)
-                {
-                    message[i] = gattMsg->msg.handleValueNoti.pValue[ 9 + i ];
-                }
-                uint8_t shaDigest[32]; // 32 bytes hash values
-                SHA2_init();
-                SHA2_Params_init(&params);
-                handle = SHA2_open(SHA2_INSTANCE, NULL);
-
-                shaResult = SHA2_hashData(handle, message, sizeof(message), shaDigest);
-                SHA2_close(handle);
-
-                // ecdsa verify signer certificate
-                for (int i = 0; i < 32; i++) {
-                    r[i] = gattMsg->msg.handleValueNoti.pValue[73 + i];
-                    s[i] = gattMsg->msg.handleValueNoti.pValue[105 + i];
-                }
-                CryptoKey devicePublicKey;
-                ECDSA_Handle ecdsaHandle;
-                ECDSA_Params ecdsaParams;
-                ECDSA_OperationVerify operationVerify;
-
-                ECDSA_init();
-                ECDSA_Params_init(&ecdsaParams);
-                ecdsaHandle = ECDSA_open(0, NULL);
-                CryptoKeyPlaintext_initKey(&devicePublicKey,
-                                           devicePublicKeyingMaterial,
-                                           sizeof(devicePublicKeyingMaterial));
-
-                ECDSA_OperationVerify_init(&operationVerify);
-                operationVerify.curve           = &ECCParams_NISTP256;
-                operationVerify.theirPublicKey  = &devicePublicKey;
-                operationVerify.hash            = shaDigest;
-                operationVerify.r               = r;
-                operationVerify.s               = s;
-
-                verifyResult = ECDSA_verify(ecdsaHandle, &operationVerify);
-                if (verifyResult == ECDSA_STATUS_SUCCESS)
-                {
-                    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE3, 0, "device verify status = %d", verifyResult);
-                    ECDSA_close(ecdsaHandle);
-//                    uint8_t successMsg[2] = {0xaa, 0xbb};
-                    doAttWriteNoRsp(43, signerCert, sizeof(signerCert));
-//                    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR3, SIMPLEGATTPROFILE_CHAR3_LEN,
-//                                                    signerCert);
-//                    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR2, SIMPLEGATTPROFILE_CHAR2_LEN,
-//                                                    deviceCert);
-                }
+                break;
             }
 
-            else if (gattMsg->msg.handleValueNoti.pValue[0] == 0x55 && gattMsg->msg.handleValueNoti.pValue[1] == 0x66)
+            // Whole messages are read in the PDU, a buffer is only taken
+            // while a fragmented one comes in
+            if (pCtx->pNotiMsg == NULL && isFragment)
             {
-                doAttWriteNoRsp(40, deviceCert, sizeof(deviceCert));
+                pCtx->pNotiMsg = MemStats_malloc(APP_FRAG_MSG_MAX_LEN);
             }
 
-            else if (gattMsg->msg.handleValueNoti.pValue[0] == 0xaa && gattMsg->msg.handleValueNoti.pValue[1] == 0xbb)
+            rxStatus = Frag_receive(gattMsg->connHandle, &pMsg, &len, pCtx->pNotiMsg, APP_FRAG_MSG_MAX_LEN);
+            if (rxStatus == FRAG_RX_DONE)
             {
-                uint8_t nonceReq[2] = {0x12, 0x23};
-                doAttWriteNoRsp(50, nonceReq, sizeof(nonceReq));
+                Verify_processMsg(gattMsg->connHandle, pMsg, len);
+                Challenge_processMsg(gattMsg->connHandle, pCtx, pMsg, len);
             }
 
-            else if (gattMsg->msg.handleValueNoti.pValue[0] == 0xcc && gattMsg->msg.handleValueNoti.pValue[1] == 0xdd)
+            if (pCtx->pNotiMsg != NULL &&
+                (pMsg == pCtx->pNotiMsg || (isFragment && rxStatus == FRAG_RX_ERROR)))
             {
-                /*
-                 * Send a nonce commands to TA010 to get the 32 bytes random number
-                 */
-                uint8_t ta010Nonce[33] = {0x03, // nonce id
-                                          0x6B, 0x54, 0x38, 0xE5, 0xE3, 0xC0, 0x1B, 0xF1,
-                                          0x44, 0x1E, 0x90, 0xDB, 0x8E, 0x9D, 0x0D, 0xB8,
-                                          0xE4, 0xBB, 0xA1, 0x0D, 0xD9, 0x05, 0xDC, 0x0C,
-                                          0xC0, 0xCA, 0x3F, 0x48, 0xB3, 0x7C, 0xA8, 0x79};
-                doAttWriteNoRsp(50, ta010Nonce, sizeof(ta010Nonce));
+                ICall_free(pCtx->pNotiMsg);
+                pCtx->pNotiMsg = NULL;
             }
         }
             break;
@@ -394,92 +424,154 @@ static void Verify_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     }
 }
 
-static void Challenge_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
+/*********************************************************************
+ * @fn      Verify_processMsg
+ *
+ * @brief   Handle the certificate messages of the peripheral
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - complete message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+static void Verify_processMsg(uint16_t connHandle, uint8_t *pMsg, uint16_t len)
 {
-    gattMsgEvent_t *gattMsg = ( gattMsgEvent_t * )pMsgData;
-    switch ( gattMsg->method )
+    if (len == 0)
     {
-        case ATT_HANDLE_VALUE_NOTI:
-            {
-                if (gattMsg->msg.handleValueNoti.pValue[0] == 3)
-                {
-                    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "32 bytes Nonce received = %d 0x%02x 0x%02x 0x%02x ",
-                                      gattMsg->msg.handleValueNoti.len, gattMsg->msg.handleValueNoti.pValue[0], gattMsg->msg.handleValueNoti.pValue[1],
-                                      gattMsg->msg.handleValueNoti.pValue[2]);
-                    /*
-                     *  Send sign command + gattMsg->msg.handleValueNoti.pValue[1] ~ gattMsg->msg.handleValueNoti.pValue[32] to TA010
-                     */
-                    uint8_t ta010Signature[65] = {0x06,
-                                                  0x60, 0x1E, 0xAF, 0xC6, 0x69, 0xEF, 0x3C, 0xFE, 0x96, 0x49, 0x3A, 0xAC, 0xD0, 0x45, 0xBF, // signature r
-                                                  0x74, 0xF8, 0x1B, 0xD6, 0xCE, 0x34, 0x65, 0x8F, 0x79, 0x34, 0x59, 0x3F, 0x74, 0xF2, 0x0C,
-                                                  0xA8, 0x3F,
-                                                  0xAF, 0x00, 0xFA, 0x71, 0x3B, 0x53, 0xDC, 0x40, 0x25, 0x39, 0x6D, 0xE8, 0xAC, 0x0D, 0x41, // signature s
-                                                  0xA2, 0x7C, 0x38, 0x06, 0xCA, 0x7E, 0x04, 0x34, 0x40, 0x3C, 0xAD, 0x8F, 0x48, 0x30, 0xA1,
-                                                  0xA9, 0xA7};
-                    doAttWriteNoRsp(53, ta010Signature, sizeof(ta010Signature));
-                }
-                else if (gattMsg->msg.handleValueNoti.pValue[0] == 6)
-                {
-                    uint8_t devicePublicKeyingMaterial[65] = {0};
-                    devicePublicKeyingMaterial[0] = 4;
-                    memcpy(&devicePublicKeyingMaterial[1], &deviceCert[9], 64);
-
-                    uint8_t r[32] = {0};
-                    uint8_t s[32] = {0};
-                    int_fast16_t shaResult;
-                    int_fast16_t verifyResult;
-                    // SHA256 signer public key
-                    SHA2_Params params;
-                    SHA2_Handle handle;
-                    uint8_t message[32] = {0x6B, 0x54, 0x38, 0xE5, 0xE3, 0xC0, 0x1B, 0xF1, 0x44, 0x1E, 0x90, 0xDB, 0x8E, 0x9D, 0x0D, 0xB8,
-                                           0xE4, 0xBB, 0xA1, 0x0D, 0xD9, 0x05, 0xDC, 0x0C, 0xC0, 0xCA, 0x3F, 0x48, 0xB3, 0x7C, 0xA8, 0x79};
-                    uint8_t shaDigest[32]; // 32 bytes hash values
-                    SHA2_init();
-                    SHA2_Params_init(&params);
-                    handle = SHA2_open(SHA2_INSTANCE, NULL);
-
-                    shaResult = SHA2_hashData(handle, message, sizeof(message), shaDigest);
-                    SHA2_close(handle);
-
-                    // verify signature
-                    for (int i = 0; i < 32; i++) {
-                        r[i] = gattMsg->msg.handleValueNoti.pValue[1 + i];
-                        s[i] = gattMsg->msg.handleValueNoti.pValue[33 + i];
-                    }
-                    CryptoKey devicePublicKey;
-                    ECDSA_Handle ecdsaHandle;
-                    ECDSA_Params ecdsaParams;
-                    ECDSA_OperationVerify operationVerify;
-
-                    ECDSA_init();
-                    ECDSA_Params_init(&ecdsaParams);
-                    ecdsaHandle = ECDSA_open(0, NULL);
-                    CryptoKeyPlaintext_initKey(&devicePublicKey,
-                                               devicePublicKeyingMaterial,
-                                               sizeof(devicePublicKeyingMaterial));
-
-                    ECDSA_OperationVerify_init(&operationVerify);
-                    operationVerify.curve           = &ECCParams_NISTP256;
-                    operationVerify.theirPublicKey  = &devicePublicKey;
-                    operationVerify.hash            = shaDigest;
-                    operationVerify.r               = r;
-                    operationVerify.s               = s;
-
-                    verifyResult = ECDSA_verify(ecdsaHandle, &operationVerify);
-                    if (verifyResult == ECDSA_STATUS_SUCCESS)
-                    {
-                        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0 ,"challenge verify status = %d", verifyResult);
-                        ECDSA_close(ecdsaHandle);
-
-                        ClockP_sleep(1);
-                        GAPBondMgr_Pair(0);
-                    }
-                }
-            }
-            break;
+        return;
+    }
 
-        default:
-            break;
+#if APP_MUTUAL_AUTH
+    if (pMsg[0] == MUTUAL_AUTH_HELLO_ID)
+    {
+        MutualAuth_processHello(connHandle, pMsg, len);
+    }
+    else if (pMsg[0] == MUTUAL_AUTH_FINISH_ID)
+    {
+        MutualAuth_processFinish(connHandle, pMsg, len);
+    }
+    else
+#endif
+#if APP_CERT_CHAIN
+    if (pMsg[0] == CERT_CHAIN_LINK_ID)
+    {
+        CertChain_processLink(connHandle, pMsg, len);
+    }
+    else
+#endif
+    if (pMsg[0] == 2) //verify signer certificate
+    {
+        int_fast16_t verifyResult;
+
+        // Any signer of the certificate bundle is trusted
+        verifyResult = CertStore_verifySigned(CertView_parse(pMsg, len));
+        if (verifyResult == ECDSA_STATUS_SUCCESS)
+        {
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0 ,"signer verify status = %d", verifyResult);
+            uint8_t deviceCertReqCmd[2] = {6, 3};
+            doAttWriteNoRsp(connHandle, 40, deviceCertReqCmd, sizeof(deviceCertReqCmd));
+        }
+    }
+    else if (pMsg[0] == 1) //verify device certificate
+    {
+        int_fast16_t verifyResult;
+
+        verifyResult = CertStore_verifyCert(CertView_parse(pMsg, len), CertStore_getPublicKey(CERT_STORE_DEVICE));
+        if (verifyResult == ECDSA_STATUS_SUCCESS)
+        {
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE3, 0, "device verify status = %d", verifyResult);
+//                    uint8_t successMsg[2] = {0xaa, 0xbb};
+            doAttWriteNoRsp(connHandle, 43, CertStore_get(CERT_STORE_SIGNER), APP_CERT_LEN);
+//                    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR3, SIMPLEGATTPROFILE_CHAR3_LEN,
+//                                                    signerCert);
+//                    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR2, SIMPLEGATTPROFILE_CHAR2_LEN,
+//                                                    deviceCert);
+        }
+    }
+
+    else if (len >= 2 && pMsg[0] == 0x55 && pMsg[1] == 0x66)
+    {
+        doAttWriteNoRsp(connHandle, 40, CertStore_get(CERT_STORE_DEVICE), APP_CERT_LEN);
+    }
+
+    else if (len >= 2 && pMsg[0] == 0xaa && pMsg[1] == 0xbb)
+    {
+        uint8_t nonceReq[2] = {0x12, 0x23};
+        doAttWriteNoRsp(connHandle, 50, nonceReq, sizeof(nonceReq));
+    }
+
+    else if (len >= 2 && pMsg[0] == 0xcc && pMsg[1] == 0xdd)
+    {
+        // Our nonce went out with the signer certificate request,
+        // the peripheral sends its signature now
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "challenge accepted by the peripheral");
+    }
+}
+
+/*********************************************************************
+ * @fn      Challenge_processMsg
+ *
+ * @brief   Handle the challenge messages of the peripheral
+ *
+ * @param   connHandle - connection handle
+ * @param   pCtx - connection context
+ * @param   pMsg - complete message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+static void Challenge_processMsg(uint16_t connHandle, App_connCtx *pCtx, uint8_t *pMsg, uint16_t len)
+{
+    // Messages shorter than their nonce or signature are dropped
+    if (len >= 1 + APP_NONCE_LEN && pMsg[0] == 3)
+    {
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "32 bytes Nonce received = %d 0x%02x 0x%02x 0x%02x ",
+                          len, pMsg[0], pMsg[1],
+                          pMsg[2]);
+        /*
+         *  Send sign command + pMsg[1] ~ pMsg[32] to TA010
+         */
+        uint8_t ta010Signature[65] = {0x06};
+        uint8_t nonceDigest[CRYPTO_CTX_DIGEST_LEN];
+
+        if (CryptoCtx_hash(&pMsg[1], APP_NONCE_LEN, nonceDigest) == SHA2_STATUS_SUCCESS &&
+            Ta010_sign(nonceDigest, &ta010Signature[1]) == SUCCESS)
+        {
+            doAttWriteNoRsp(connHandle, 53, ta010Signature, sizeof(ta010Signature));
+        }
+    }
+    else if (len >= 1 + CERT_SIGNATURE_LEN && pMsg[0] == 6)
+    {
+        int_fast16_t verifyResult;
+#if APP_CERT_CHAIN
+        // Key of the device certificate that ended the verified chain
+        const uint8_t *pPeerKey = CertChain_getDeviceKey(connHandle);
+#else
+        const uint8_t *pPeerKey = CertStore_getPublicKey(CERT_STORE_DEVICE);
+#endif
+
+        // The signature must answer a nonce we issued and did not see answered yet
+        if (NoncePool_consume(pCtx->challengeNonce) != NONCE_POOL_SUCCESS)
+        {
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0, "challenge rejected - nonce replay");
+            return;
+        }
+
+        if (pPeerKey == NULL)
+        {
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0, "challenge rejected - certificate not verified");
+            return;
+        }
+
+        verifyResult = CryptoCtx_verifyData(pPeerKey, pCtx->challengeNonce, APP_NONCE_LEN, &pMsg[1]);
+        if (verifyResult == ECDSA_STATUS_SUCCESS)
+        {
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0 ,"challenge verify status = %d - connectionHandle = %d",
+                              verifyResult, connHandle);
+
+            Data_authenticated(connHandle, MUTUAL_AUTH_ROLE_CENTRAL);
+        }
     }
 }
 
@@ -497,10 +589,22 @@ bStatus_t Data_start( void )
 {
   bStatus_t status = SUCCESS;
 
+  // Fill the nonce pool before the first challenge
+  NoncePool_init();
+
+  // Start the transfers of a link once it is configured
+  LinkReady_init(Data_linkReadyCB);
+  Frag_init();
+#if APP_MUTUAL_AUTH
+  MutualAuth_init(Data_authenticated);
+#endif
+#if APP_CERT_CHAIN
+  CertChain_init(Data_chainVerified);
+#endif
+
   // Register the handlers
   status = BLEAppUtil_registerEventHandler( &dataGATTHandler );
   status = BLEAppUtil_registerEventHandler( &verifyHandler );
-  status = BLEAppUtil_registerEventHandler( &challengeHandler );
 
   // Return status value
   return( status );
@@ -0,0 +1,421 @@
+/******************************************************************************
+
+@file  app_link_ready.c
+
+@brief This file contains the link readiness tracker, it holds the
+       large handshake transfers until the link is configured
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Max time the handshake waits for the MTU, data length and PHY updates
+#ifndef LINK_READY_TIMEOUT_MS
+#define LINK_READY_TIMEOUT_MS   500
+#endif
+
+// ATT header of a Write Command or a Notification
+#define LINK_READY_ATT_HDR_LEN  3
+// L2CAP header
+#define LINK_READY_L2CAP_HDR_LEN 4
+
+// Link state flags
+#define LINK_READY_MTU_DONE     BV(0)
+#define LINK_READY_DLE_DONE     BV(1)
+#define LINK_READY_PHY_PENDING  BV(2)
+#define LINK_READY_RELEASED     BV(3)
+#define LINK_READY_ALL_DONE     (LINK_READY_MTU_DONE | LINK_READY_DLE_DONE)
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef struct
+{
+    uint16_t connHandle;
+    uint16_t mtu;           // Negotiated ATT_MTU
+    uint16_t txOctets;      // LL payload octets, local to peer
+    uint16_t rxOctets;      // LL payload octets, peer to local
+    uint8_t  phy;           // HCI_PHY_xx
+    uint8_t  flags;
+    ClockP_Struct timer;
+}LinkReady_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static LinkReady_t *LinkReady_find(uint16_t connHandle);
+static void LinkReady_check(LinkReady_t *pLink, uint8_t timedOut);
+static void LinkReady_timerCB(uintptr_t arg);
+static void LinkReady_timeoutCB(char *pData);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Indexed by the connection slot, see Connection_getConnIndex
+static LinkReady_t linkReadyList[MAX_NUM_BLE_CONNS];
+static LinkReady_readyCB_t linkReadyCB = NULL;
+// One bit per entry of linkReadyList whose timer expired
+static volatile uint8_t linkReadyTimedOut = 0;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      LinkReady_init
+ *
+ * @brief   Clear the tracker and register the callback that starts
+ *          the large transfers of a link.
+ *
+ * @param   readyCB - called once per link in the BLEAppUtil context
+ *
+ * @return  none
+ */
+void LinkReady_init(LinkReady_readyCB_t readyCB)
+{
+    uint8_t i;
+    ClockP_Params clockParams;
+
+    linkReadyCB = readyCB;
+
+    ClockP_Params_init(&clockParams);
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        linkReadyList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        clockParams.arg = i;
+        ClockP_construct(&linkReadyList[i].timer, LinkReady_timerCB,
+                         (LINK_READY_TIMEOUT_MS * 1000) / ClockP_getSystemTickPeriod(),
+                         &clockParams);
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_add
+ *
+ * @brief   Start tracking a new link with the default values. Call
+ *          it after the link was added to the connected device list.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_add(uint16_t connHandle)
+{
+    uint16_t slot = Connection_getConnIndex(connHandle);
+    LinkReady_t *pLink;
+
+    if (slot >= MAX_NUM_BLE_CONNS)
+    {
+        return;
+    }
+
+    pLink = &linkReadyList[slot];
+    pLink->connHandle = connHandle;
+    pLink->mtu = ATT_MTU_SIZE;
+    pLink->txOctets = LL_MIN_LINK_DATA_LEN;
+    pLink->rxOctets = LL_MIN_LINK_DATA_LEN;
+    pLink->phy = HCI_PHY_1_MBPS;
+    pLink->flags = 0;
+    linkReadyTimedOut &= ~(1 << slot);
+    ClockP_start(ClockP_handle(&pLink->timer));
+}
+
+/*********************************************************************
+ * @fn      LinkReady_remove
+ *
+ * @brief   Stop tracking a link. Call it before the link is removed
+ *          from the connected device list.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_remove(uint16_t connHandle)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    if (pLink != NULL)
+    {
+        ClockP_stop(ClockP_handle(&pLink->timer));
+        pLink->connHandle = LINKDB_CONNHANDLE_INVALID;
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_setMtu
+ *
+ * @brief   Record the negotiated ATT_MTU (ATT_MTU_UPDATED_EVENT)
+ *
+ * @param   connHandle - connection handle
+ * @param   mtu - new ATT_MTU
+ *
+ * @return  none
+ */
+void LinkReady_setMtu(uint16_t connHandle, uint16_t mtu)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    if (pLink != NULL)
+    {
+        pLink->mtu = mtu;
+        pLink->flags |= LINK_READY_MTU_DONE;
+        LinkReady_check(pLink, FALSE);
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_setDataLen
+ *
+ * @brief   Record the LL payload sizes (HCI_BLE_DATA_LENGTH_CHANGE_EVENT)
+ *
+ * @param   connHandle - connection handle
+ * @param   txOctets - max LL payload sent
+ * @param   rxOctets - max LL payload received
+ *
+ * @return  none
+ */
+void LinkReady_setDataLen(uint16_t connHandle, uint16_t txOctets, uint16_t rxOctets)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    if (pLink != NULL)
+    {
+        pLink->txOctets = txOctets;
+        pLink->rxOctets = rxOctets;
+        pLink->flags |= LINK_READY_DLE_DONE;
+        LinkReady_check(pLink, FALSE);
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_expectPhy
+ *
+ * @brief   Hold the large transfers until a requested PHY update
+ *          completed
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_expectPhy(uint16_t connHandle)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    if (pLink != NULL)
+    {
+        pLink->flags |= LINK_READY_PHY_PENDING;
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_setPhy
+ *
+ * @brief   Record the PHY of a link (HCI_BLE_PHY_UPDATE_COMPLETE_EVENT)
+ *
+ * @param   connHandle - connection handle
+ * @param   phy - HCI_PHY_xx, or 0 when the update failed
+ *
+ * @return  none
+ */
+void LinkReady_setPhy(uint16_t connHandle, uint8_t phy)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    if (pLink != NULL)
+    {
+        if (phy != 0)
+        {
+            pLink->phy = phy;
+        }
+        pLink->flags &= ~LINK_READY_PHY_PENDING;
+        LinkReady_check(pLink, FALSE);
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_getMtu
+ *
+ * @brief   Negotiated ATT_MTU of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  ATT_MTU, ATT_MTU_SIZE if the link is unknown
+ */
+uint16_t LinkReady_getMtu(uint16_t connHandle)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+
+    return (pLink != NULL) ? pLink->mtu : ATT_MTU_SIZE;
+}
+
+/*********************************************************************
+ * @fn      LinkReady_getStrategy
+ *
+ * @brief   Choose how a message is carried with the negotiated values
+ *
+ * @param   connHandle - connection handle
+ * @param   msgLen - length of the message (ATT value)
+ *
+ * @return  one of LinkReady_strategies
+ */
+uint8_t LinkReady_getStrategy(uint16_t connHandle, uint16_t msgLen)
+{
+    LinkReady_t *pLink = LinkReady_find(connHandle);
+    uint16_t attLen = msgLen + LINK_READY_ATT_HDR_LEN;
+
+    if (pLink == NULL || attLen > pLink->mtu)
+    {
+        return LINK_XFER_ATT_FRAGMENTS;
+    }
+
+    if (attLen + LINK_READY_L2CAP_HDR_LEN > pLink->txOctets)
+    {
+        return LINK_XFER_LL_FRAGMENTS;
+    }
+
+    return LINK_XFER_SINGLE_PACKET;
+}
+
+/*********************************************************************
+ * @fn      LinkReady_find
+ *
+ * @brief   Find the tracker entry of a link from its connection slot
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  entry or NULL
+ */
+static LinkReady_t *LinkReady_find(uint16_t connHandle)
+{
+    uint16_t slot = Connection_getConnIndex(connHandle);
+
+    if (slot >= MAX_NUM_BLE_CONNS || linkReadyList[slot].connHandle != connHandle)
+    {
+        return NULL;
+    }
+
+    return &linkReadyList[slot];
+}
+
+/*********************************************************************
+ * @fn      LinkReady_check
+ *
+ * @brief   Release the large transfers of a link once every update
+ *          completed or the timer expired
+ *
+ * @param   pLink - tracker entry
+ * @param   timedOut - TRUE when called on the timer expiry
+ *
+ * @return  none
+ */
+static void LinkReady_check(LinkReady_t *pLink, uint8_t timedOut)
+{
+    if (pLink->flags & LINK_READY_RELEASED)
+    {
+        return;
+    }
+
+    if (!timedOut &&
+        ((pLink->flags & LINK_READY_ALL_DONE) != LINK_READY_ALL_DONE ||
+         (pLink->flags & LINK_READY_PHY_PENDING)))
+    {
+        return;
+    }
+
+    ClockP_stop(ClockP_handle(&pLink->timer));
+    pLink->flags |= LINK_READY_RELEASED;
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "Link ready%s - MTU = %d TX = %d RX = %d PHY = %d",
+                      timedOut ? " (timeout)" : "", pLink->mtu, pLink->txOctets, pLink->rxOctets, pLink->phy);
+
+    if (linkReadyCB != NULL)
+    {
+        linkReadyCB(pLink->connHandle);
+    }
+}
+
+/*********************************************************************
+ * @fn      LinkReady_timerCB
+ *
+ * @brief   Timer expiry, handled in the BLEAppUtil context
+ *
+ * @param   arg - connection slot, index in linkReadyList
+ *
+ * @return  none
+ */
+static void LinkReady_timerCB(uintptr_t arg)
+{
+    linkReadyTimedOut |= (1 << arg);
+    BLEAppUtil_invokeFunctionNoData(LinkReady_timeoutCB);
+}
+
+/*********************************************************************
+ * @fn      LinkReady_timeoutCB
+ *
+ * @brief   Release the links whose timer expired
+ *
+ * @param   pData - unused
+ *
+ * @return  none
+ */
+static void LinkReady_timeoutCB(char *pData)
+{
+    uint8_t i;
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if (linkReadyTimedOut & (1 << i))
+        {
+            linkReadyTimedOut &= ~(1 << i);
+            if (linkReadyList[i].connHandle != LINKDB_CONNHANDLE_INVALID)
+            {
+                LinkReady_check(&linkReadyList[i], TRUE);
+            }
+        }
+    }
+}
@@ -123,9 +123,17 @@ void App_StackInitDoneHandler(gapDeviceInitDoneEvent_t *deviceInitDoneData)
 {
     bStatus_t status = SUCCESS;
 
+    // Certificates, before any handshake can use them
+    CertStore_init();
+
     // Menu
     Menu_start();
 
+#if APP_MEM_STATS
+    // The init done handler runs in the BLEAppUtil task
+    MemStats_start(appMainParams.taskStackSize);
+#endif
+
     // Print the device ID address
     MenuModule_printf(APP_MENU_DEVICE_ADDRESS, 0, "BLE ID Address: "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_GREEN "%s" MENU_MODULE_COLOR_RESET,
@@ -242,12 +250,19 @@ void App_StackInitDoneHandler(gapDeviceInitDoneEvent_t *deviceInitDoneData)
 //    HCI_EXT_SetMaxDataLenCmd(251, 2120, 251, 2120);
 }
 
-void doAttWriteReq(uint16 handle, uint8_t *inputValue, uint16_t inputLen)
+void doAttWriteReq(uint16 connHandle, uint16 handle, const uint8_t *inputValue, uint16_t inputLen)
 {
     attWriteReq_t Req;
     Req.handle = handle;
     Req.len = inputLen;
-    Req.pValue = GATT_bm_alloc(0, ATT_WRITE_REQ, inputLen, NULL);
+    Req.pValue = MemStats_bmAlloc(connHandle, ATT_WRITE_REQ, inputLen);
+    if (Req.pValue == NULL)
+    {
+        MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttWriteReq = "
+                          MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
+                          bleMemAllocError);
+        return;
+    }
     for (int i = 0; i < inputLen; i++)
     {
         Req.pValue[i] = inputValue[i];
@@ -255,7 +270,7 @@ void doAttWriteReq(uint16 handle, uint8_t *inputValue, uint16_t inputLen)
     Req.sig = 0;
     Req.cmd = 0;
 
-    bStatus_t status = GATT_WriteCharValue(0, &Req, BLEAppUtil_getSelfEntity());
+    bStatus_t status = GATT_WriteCharValue(connHandle, &Req, BLEAppUtil_getSelfEntity());
     if ( status != SUCCESS )
     {
         GATT_bm_free((gattMsg_t *)&Req, ATT_WRITE_REQ);
@@ -265,68 +280,57 @@ void doAttWriteReq(uint16 handle, uint8_t *inputValue, uint16_t inputLen)
                       status);
 }
 
-void doAttWriteNoRsp(uint16 handle, uint8_t *inputValue, uint16_t inputLen)
+void doAttWriteNoRsp(uint16 connHandle, uint16 handle, const uint8_t *inputValue, uint16_t inputLen)
 {
-    attWriteReq_t Req;
-    Req.handle = handle;
-    Req.len = inputLen;
-    Req.pValue = GATT_bm_alloc(0, ATT_WRITE_REQ, inputLen, NULL);
-    for (int i = 0; i < inputLen; i++)
-    {
-        Req.pValue[i] = inputValue[i];
-    }
-    Req.sig = 0;
-    Req.cmd = 1;
+    // Split in fragments when the ATT_MTU is too small
+    bStatus_t status = Frag_send(connHandle, handle, ATT_WRITE_CMD, inputValue, inputLen);
 
-    bStatus_t status = GATT_WriteNoRsp(0, &Req);
-    if ( status != SUCCESS )
-    {
-        GATT_bm_free((gattMsg_t *)&Req, ATT_WRITE_REQ);
-    }
     MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttWriteCmd = "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
                       status);
 }
 
-void doAttReadReq(uint16 handle, uint8 charNum)
+void doAttReadReq(uint16 connHandle, uint16 handle, uint8 charNum)
 {
     attReadReq_t req;
     req.handle = handle;
 
-    bStatus_t status = GATT_ReadCharValue(0, &req, BLEAppUtil_getSelfEntity());
+    bStatus_t status = GATT_ReadCharValue(connHandle, &req, BLEAppUtil_getSelfEntity());
     MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: GATTRead char %d = "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "0x%02x" MENU_MODULE_COLOR_RESET,
                       charNum, status);
 }
 
-void doAttNotification(uint16 handle, uint8_t *notiVal, uint16_t len)
+void doAttReadLongReq(uint16 connHandle, uint16 handle, uint8 charNum)
 {
-    attHandleValueNoti_t req;
+    attReadBlobReq_t req;
+    req.handle = handle;
+    req.offset = 0;
 
-    req.handle = handle; //46
-    req.len = len;
-    req.pValue = GATT_bm_alloc(0, ATT_HANDLE_VALUE_NOTI, len, NULL);
-    for (int i = 0; i < len; i++)
-    {
-        req.pValue[i] = notiVal[i];
-    }
+    // Read Blob requests until the whole value is read, for values
+    // larger than ATT_MTU - 1
+    bStatus_t status = GATT_ReadLongCharValue(connHandle, &req, BLEAppUtil_getSelfEntity());
+    MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: GATTReadLong char %d = "
+                      MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "0x%02x" MENU_MODULE_COLOR_RESET,
+                      charNum, status);
+}
+
+void doAttNotification(uint16 connHandle, uint16 handle, const uint8_t *notiVal, uint16_t len)
+{
+    // Split in fragments when the ATT_MTU is too small
+    bStatus_t status = Frag_send(connHandle, handle, ATT_HANDLE_VALUE_NOTI, notiVal, len);
 
-    bStatus_t status = GATT_Notification(0, &req, 0);
-    if ( status != SUCCESS )
-    {
-        GATT_bm_free((gattMsg_t *)&req, ATT_HANDLE_VALUE_NOTI);
-    }
     MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttNotification = "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
                       status);
 }
 
-bStatus_t doAttMtuExchange(uint16 MTUVals)
+bStatus_t doAttMtuExchange(uint16 connHandle, uint16 MTUVals)
 {
     // Exchange and set Max MTU
     attExchangeMTUReq_t req;
     req.clientRxMTU = MTUVals - L2CAP_HDR_SIZE;
-    bStatus_t status = GATT_ExchangeMTU(0, &req, BLEAppUtil_getSelfEntity());
+    bStatus_t status = GATT_ExchangeMTU(connHandle, &req, BLEAppUtil_getSelfEntity());
 
     return status;
 }
@@ -49,6 +49,8 @@ Target Device: cc23xx
 //! Includes
 //*****************************************************************************
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_crypto_ctx.h>
+#include <app_crypto_prof.h>
 
 //*****************************************************************************
 //! Defines
@@ -56,7 +58,214 @@ Target Device: cc23xx
 extern uint8_t oobEnabled;
 #define KEYLEN 16
 extern gapBondOOBData_t localOobData;
-extern gapBondOOBData_t remoteOobData;
+
+// The controller allocates the connection handles from 0, below the
+// maximum number of connections, so they index the connection contexts
+// directly
+#ifndef CONNECTION_HANDLE_MAP_SIZE
+#define CONNECTION_HANDLE_MAP_SIZE  MAX_NUM_BLE_CONNS
+#endif
+#define CONNECTION_SLOT_INVALID     0xFF
+
+// Carry the Peripheral's SC OOB confirm/rand in its advertising data so the
+// Central can set the remote OOB data before the connection completes,
+// instead of reading Characteristic 1 after the MTU exchange.
+// The confirm value is placed in the advertising data and the random value
+// in the scan response, since both do not fit in one 31 byte legacy PDU.
+#ifndef APP_OOB_IN_ADV_DATA
+#define APP_OOB_IN_ADV_DATA 1
+#endif
+
+// AD types for the LE Secure Connections OOB values (Core Spec Supplement)
+#define APP_ADTYPE_SC_CONFIRM_VALUE 0x22
+#define APP_ADTYPE_SC_RANDOM_VALUE  0x23
+
+// Sensors the Central connects to and authenticates, as a list of
+// addresses in the byte order of the advertising reports. Up to
+// MAX_NUM_BLE_CONNS of them are connected and run their handshake at
+// the same time. MAX_NUM_BLE_CONNS comes from the number of connections
+// in basic_ble.syscfg and is 1 in the provided project, so the list
+// holds one peer until it is raised. Several sensors are off by default
+// because the SRAM of the Central is full, each extra link must be paid
+// for from the FreeRTOS heap, see the README.
+#ifndef APP_PEER_ADDR_LIST
+#define APP_PEER_ADDR_LIST          { { 0x96, 0x5D, 0x3C, 0x93, 0x72, 0x84 } }
+#endif
+// Address type of the peers of the set
+#ifndef APP_PEER_ADDR_TYPE
+#define APP_PEER_ADDR_TYPE          ADDRTYPE_PUBLIC
+#endif
+
+// Load the peers of the set in the controller's filter accept list and
+// scan with the accept list filter policy and an RSSI floor, so the
+// controller drops the reports of the other devices in range and the
+// host only wakes up for our own sensors. The scanning menu switches the
+// filter off and on, and the host wakeups are counted for both.
+#ifndef APP_SCAN_FILTER_ACCEPT_LIST
+#define APP_SCAN_FILTER_ACCEPT_LIST 1
+#endif
+// Reports received below this RSSI (dBm) are dropped by the controller
+#ifndef APP_SCAN_MIN_RSSI
+#define APP_SCAN_MIN_RSSI           (-90)
+#endif
+
+// Connect to the peers of the set with the initiator filter policy: the
+// controller connects to any device of the filter accept list on the
+// first advertisement it hears, without an advertising report going to
+// the host first. Scanning is then only used to discover new sensors,
+// and with APP_OOB_IN_ADV_DATA for a short scan before the initiator
+// starts, to collect the OOB data of the peers that are not connected.
+#ifndef APP_CONNECT_ACCEPT_LIST
+#define APP_CONNECT_ACCEPT_LIST     1
+#endif
+
+// Per-link radio statistics: RSSI, CRC errors and missed events of the
+// connection event reports, folded every APP_RADIO_STATS_PERIOD_MS into
+// rolling averages for the link policies, the menu and Characteristic 7
+#ifndef APP_RADIO_STATS
+#define APP_RADIO_STATS             1
+#endif
+#ifndef APP_RADIO_STATS_PERIOD_MS
+#define APP_RADIO_STATS_PERIOD_MS   1000
+#endif
+// Weight of a new period in the rolling averages is 1 / 2^shift
+#ifndef APP_RADIO_STATS_AVG_SHIFT
+#define APP_RADIO_STATS_AVG_SHIFT   2
+#endif
+// Size of the serialized statistics of a link
+#define RADIO_STATS_SERIAL_LEN      19
+
+// Stack high water marks of the application tasks, heap watermarks and
+// allocation failures, for the menu and Characteristic 8
+#ifndef APP_MEM_STATS
+#define APP_MEM_STATS               1
+#endif
+// Watched tasks: BLEAppUtil, the TA010 Sign task and a spare slot
+#define MEM_STATS_MAX_TASKS         3
+// Size of the serialized memory statistics
+#define MEM_STATS_SERIAL_LEN        (MEM_STATS_MAX_TASKS * 4 + 10)
+
+// Single round mutual challenge-response: both sides send their device
+// certificate with a fresh TA010 nonce (HELLO) and answer with a signature
+// over both nonces (FINISH), instead of the sequential certificate and
+// challenge phases. Each side verifies the peer certificate against the
+// signers of its certificate store, so the device certificates must come
+// from a bundle whose signer issued them, and each device needs its own
+// TA010 key. HELLO carries the device certificate of the TA010 key, which
+// signs FINISH: a bundle may hold the certificates of several devices.
+#ifndef APP_MUTUAL_AUTH
+#define APP_MUTUAL_AUTH 0
+#endif
+
+// The TA010 Nonce and Sign commands are executed locally on the CPU until
+// the I2C transport is wired in, 0 does not build yet. The emulated Sign
+// shares the CPU with the verifications, so it cannot run alongside them.
+#ifndef TA010_EMULATED
+#define TA010_EMULATED 1
+#endif
+// Test builds only: the emulated Sign uses the private key of the built-in
+// device certificate. That key is public, so an image built with it has no
+// identity of its own and must never ship. Without it the emulated Sign
+// fails and the device cannot answer a challenge.
+#ifndef TA010_TEST_KEY
+#define TA010_TEST_KEY 0
+#endif
+
+#define APP_NONCE_LEN               32
+#define MUTUAL_AUTH_HELLO_ID        0x07
+#define MUTUAL_AUTH_FINISH_ID       0x08
+// id + certificate + nonce
+#define MUTUAL_AUTH_HELLO_LEN       (1 + APP_CERT_LEN + APP_NONCE_LEN)
+// id + signature r + s
+#define MUTUAL_AUTH_FINISH_LEN      (1 + 64)
+
+// Certificates of the certificate store, by certificate id
+typedef enum
+{
+    CERT_STORE_DEVICE = 0x01,
+    CERT_STORE_SIGNER = 0x02
+}CertStore_ids;
+
+// Certificate bundle: the certificates of the store are read in place
+// from a double-buffered bundle at the end of the NVS_SLOT flash region,
+// see app_cert_store.c. The bundle is written with the programmer. Without
+// a valid bundle the certificates built in the image are used.
+#ifndef APP_CERT_BUNDLE
+#define APP_CERT_BUNDLE             1
+#endif
+// Certificates of a bundle, signers and device certificates together
+#ifndef CERT_BUNDLE_MAX_CERTS
+#define CERT_BUNDLE_MAX_CERTS       8
+#endif
+// Fingerprint of a certificate: SHA256 of its APP_CERT_LEN bytes
+#define CERT_FINGERPRINT_LEN        32
+
+// Certificate revocation: fingerprints of rejected certificates are kept
+// in a double-buffered list in NVS_SLOT, with a Bloom filter in front of
+// it, see app_cert_store.c. A revoked certificate is rejected before any
+// signature verification.
+#ifndef APP_CERT_REVOKE
+#define APP_CERT_REVOKE             1
+#endif
+// Revoked certificates the list holds
+#ifndef CERT_REVOKE_MAX_IDS
+#define CERT_REVOKE_MAX_IDS         96
+#endif
+// CertStore_verifyCert status of a revoked certificate, below the ECDSA
+// driver status codes (ECDSA_STATUS_RESERVED is -32)
+#define CERT_STORE_REVOKED_STATUS   (-33)
+
+// Certificate chain: the peripheral sends root -> intermediates -> device,
+// one certificate per message, and the central verifies each one as it
+// arrives, keeping only the key of the current issuer. The first bad
+// certificate aborts the transfer. The certificates built in the image
+// are self-signed and do not form a chain: enable it together with a
+// bundle that holds the issuers of the device certificate, in any order
+// and next to other signers.
+#ifndef APP_CERT_CHAIN
+#define APP_CERT_CHAIN              0
+#endif
+// Certificates of a chain, root and device included
+#ifndef CERT_CHAIN_MAX_DEPTH
+#define CERT_CHAIN_MAX_DEPTH        4
+#endif
+// Certificates sent ahead of the acknowledgements
+#ifndef CERT_CHAIN_WINDOW
+#define CERT_CHAIN_WINDOW           2
+#endif
+#define CERT_CHAIN_REQ_ID           0x09
+#define CERT_CHAIN_LINK_ID          0x0A
+#define CERT_CHAIN_ACK_ID           0x0B
+#define CERT_CHAIN_ABORT_ID         0x0C
+// Index of a chain message, flagged on the device certificate
+#define CERT_CHAIN_LAST             BV(7)
+// id + index + certificate
+#define CERT_CHAIN_LINK_LEN         (2 + APP_CERT_LEN)
+
+// Largest handshake message. A message the ATT_MTU cannot carry in one PDU
+// is sent as fragments of APP_FRAG_HDR_LEN + (ATT_MTU - 3 - APP_FRAG_HDR_LEN)
+// bytes. The fragment header is 0xE0 - 0xFF and handshake message ids stay
+// below it, so each PDU tells the receiver how it is framed.
+#define APP_FRAG_MSG_MAX_LEN        MUTUAL_AUTH_HELLO_LEN
+#define APP_FRAG_HDR_LEN            1
+
+// Connection parameters of the handshake (certificates, challenge and
+// pairing) and of the sensor traffic once the bond is saved.
+// Intervals in 1.25 ms units, supervision timeouts in 10 ms units.
+#ifndef APP_HANDSHAKE_CONN_INT
+#define APP_HANDSHAKE_CONN_INT      6       // 7.5 ms
+#endif
+#define APP_HANDSHAKE_CONN_LAT      0
+#define APP_HANDSHAKE_SUP_TO        300     // 3 s
+
+#ifndef APP_SENSOR_CONN_INT
+#define APP_SENSOR_CONN_INT         800     // 1 s
+#endif
+#ifndef APP_SENSOR_CONN_LAT
+#define APP_SENSOR_CONN_LAT         4
+#endif
+// Must be larger than (1 + latency) * interval * 2
+#define APP_SENSOR_SUP_TO           1200    // 12 s
 //*****************************************************************************
 //! Typedefs
 //*****************************************************************************
@@ -78,6 +287,116 @@ typedef enum
     APP_MENU_PROFILE_STATUS_LINE5
 }AppMenu_rows;
 
+// Handshake phases measured by the phase timers
+typedef enum
+{
+    APP_PHASE_VERIFY,       // Peer certificates and challenge verification
+    APP_PHASE_TA010_SIGN,   // TA010 Sign command over the peer nonce
+    APP_PHASE_NUM
+}App_phases;
+
+// PHY policy: 2M right after the connection, Coded when the link gets
+// marginal and back to 2M once it recovered
+#ifndef APP_PHY_POLICY
+#define APP_PHY_POLICY              1
+#endif
+// The PHY policy consumes the radio statistics
+#if APP_PHY_POLICY && !APP_RADIO_STATS
+#error "APP_PHY_POLICY requires APP_RADIO_STATS"
+#endif
+// Connection events averaged on the current PHY before a decision
+#define APP_PHY_POLICY_WINDOW       64
+// Average RSSI (dBm) below which the link moves to Coded PHY
+#define APP_PHY_CODED_RSSI          (-85)
+// Average RSSI (dBm) above which the link goes back to 2M PHY
+#define APP_PHY_2M_RSSI             (-70)
+// Move to Coded PHY when more than 1 / APP_PHY_CODED_ERR_RATIO of the
+// connection events had a CRC error or were missed
+#define APP_PHY_CODED_ERR_RATIO     4
+
+// Connection parameter profiles, selected by the handshake state
+typedef enum
+{
+    CONN_PARAM_PROFILE_HANDSHAKE,
+    CONN_PARAM_PROFILE_SENSOR,
+    CONN_PARAM_PROFILE_NUM
+}Connection_paramProfiles;
+
+// Pairing state of a link
+typedef enum
+{
+    PAIRING_LINK_IDLE,
+    PAIRING_LINK_QUEUED,        // Waits for the link being paired
+    PAIRING_LINK_ACTIVE         // Owns the OOB data of the bond manager
+}Pairing_linkStates;
+
+// Transfer strategy of a message, chosen from the negotiated link values
+typedef enum
+{
+    LINK_XFER_SINGLE_PACKET,    // Fits in one ATT PDU and one LL packet
+    LINK_XFER_LL_FRAGMENTS,     // One ATT PDU split by the LL
+    LINK_XFER_ATT_FRAGMENTS     // Larger than the ATT_MTU
+}LinkReady_strategies;
+
+// Frag_receive status
+typedef enum
+{
+    FRAG_RX_DONE,       // The message is complete
+    FRAG_RX_PENDING,    // More fragments are expected
+    FRAG_RX_ERROR       // Malformed fragment, the message is dropped
+}Frag_rxStatus;
+
+// Called once the link is configured for the large transfers
+typedef void (*LinkReady_readyCB_t)(uint16_t connHandle);
+
+typedef enum
+{
+    MUTUAL_AUTH_ROLE_CENTRAL,
+    MUTUAL_AUTH_ROLE_PERIPHERAL
+}MutualAuth_roles;
+
+// Called once the peer of a link is authenticated
+typedef void (*MutualAuth_doneCB_t)(uint16_t connHandle, uint8_t role);
+
+// Called once the peer certificate chain is verified or rejected
+typedef void (*CertChain_doneCB_t)(uint16_t connHandle, int_fast16_t status);
+
+// Radio statistics of a link
+typedef struct
+{
+  uint16_t  connHandle;
+  uint8_t   phy;                    // HCI_PHY_xx of the last connection event
+  int8_t    lastRssi;               // dBm, last received connection event
+  int8_t    avgRssi;                // dBm, rolling average
+  uint8_t   crcPct;                 // Rolling % of the events with a CRC error
+  uint8_t   missPct;                // Rolling % of the missed events
+  uint16_t  evtRate;                // Rolling connection events per period
+  uint32_t  avgEvents;              // Events in the averages since the last reset
+  uint32_t  totalEvents;            // Totals since the connection
+  uint32_t  totalCrc;
+  uint32_t  totalMissed;
+  uint32_t  totalSkipped;           // Event counter gaps (latency, scheduling)
+}RadioStats_t;
+
+// Called for each link at the end of a sampling period
+typedef void (*RadioStats_sampleCB_t)(uint16_t connHandle, const RadioStats_t *pStats);
+
+// Memory statistics since boot, all sizes in bytes
+typedef struct
+{
+  struct
+  {
+    uint32_t  stackSize;
+    uint32_t  stackPeak;            // Deepest use of the painted stack
+  }tasks[MEM_STATS_MAX_TASKS];
+  uint8_t   numTasks;
+  uint32_t  heapSize;
+  uint32_t  heapFree;
+  uint32_t  heapMinFree;            // Lowest free heap, heapSize - peak use
+  uint16_t  bmAllocFailures;        // Failed GATT_bm_alloc
+  uint16_t  mallocFailures;         // Failed ICall_malloc
+}MemStats_t;
+
 PACKED_ALIGNED_TYPEDEF_STRUCT
 {
   /// Type of TargetA address in the directed advertising PDU
@@ -86,12 +405,23 @@ PACKED_ALIGNED_TYPEDEF_STRUCT
   BLEAppUtil_BDaddr  address;
 }App_scanResults;
 
-// Connected device information
+// Connection context, holds the per-link state of the application
 PACKED_ALIGNED_TYPEDEF_STRUCT
 {
   uint16_t  connHandle;             // Connection Handle
   BLEAppUtil_BDaddr peerAddress;    // The address of the peer device
-} App_connInfo;
+  uint8_t   activeIdx;              // Index in the connected device list
+  uint8_t   paramProfile;           // Requested Connection_paramProfiles
+  uint8_t   phy;                    // Current HCI_PHY_xx of the link
+  uint8_t   phyPending;             // A PHY update is in progress
+  gapBondOOBData_t remoteOob;       // OOB data of the peer, used when paired
+  uint8_t   remoteOobValue[2 * KEYLEN]; // Characteristic 1 of the peer
+  uint16_t  remoteOobLen;           // Bytes of remoteOobValue read so far
+  uint8_t   challengeNonce[APP_NONCE_LEN]; // Last challenge sent to the peer
+  uint8_t   *pNotiMsg;              // Fragmented notification being reassembled, heap
+  uint8_t   pairState;              // Pairing_linkStates
+  uint8_t   pairSeq;                // Pairing request order
+} App_connCtx;
 
 //*****************************************************************************
 //! Functions
@@ -109,6 +439,17 @@ PACKED_ALIGNED_TYPEDEF_STRUCT
  */
 bStatus_t Peripheral_start(void);
 
+/*********************************************************************
+ * @fn      Peripheral_updateOobAdvData
+ *
+ * @brief   Generate new local OOB data, store it in Characteristic 1
+ *          and load the confirm/random values into the advertising
+ *          and scan response data of the advertise set.
+ *
+ * @return  SUCCESS, errorInfo
+ */
+bStatus_t Peripheral_updateOobAdvData(void);
+
 /*********************************************************************
  * @fn      Broadcaster_start
  *
@@ -293,13 +634,87 @@ bStatus_t Menu_start(void);
 uint8 Scan_getScanResList(App_scanResults **scanRes);
 
 /*********************************************************************
- * @fn      Connection_getConnList
+ * @fn      Central_getPeerOob
+ *
+ * @brief   Get the OOB data a peer of the set carried in its
+ *          advertising data
+ *
+ * @param   connHandle - connection handle
+ * @param   pOob - filled with the confirm and random values
+ *
+ * @return  TRUE if the OOB data was found in the advertising data
+ */
+uint8_t Central_getPeerOob(uint16_t connHandle, gapBondOOBData_t *pOob);
+
+/*********************************************************************
+ * @fn      Central_peerAuthenticated
+ *
+ * @brief   Mark the peer of a link as authenticated, and report the
+ *          time it took to authenticate the whole set
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Central_peerAuthenticated(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Central_toggleScanFilter
+ *
+ * @brief   Switch the scanner between the accept list filter and no
+ *          filter, see APP_SCAN_FILTER_ACCEPT_LIST
+ *
+ * @return  SUCCESS, bleIncorrectMode while scanning, or stack call
+ *          status
+ */
+bStatus_t Central_toggleScanFilter(void);
+
+/*********************************************************************
+ * @fn      Pairing_request
  *
- * @brief   Get the connection list
+ * @brief   Pair an authenticated link with the OOB data of its
+ *          connection context. The remote OOB data of the bond manager
+ *          is shared by all links, so one link is paired at a time and
+ *          the other requests wait their turn.
  *
- * @return  connection list
+ * @param   connHandle - connection handle
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER for an unknown link
+ */
+bStatus_t Pairing_request(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Pairing_remove
+ *
+ * @brief   Drop the pairing request of a terminated link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Pairing_remove(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Connection_getCtx
+ *
+ * @brief   Find the context of a connection
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the connection context, or NULL if the link is unknown
+ */
+App_connCtx *Connection_getCtx(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Connection_getCtxByIndex
+ *
+ * @brief   Get the context of an entry of the connected device list
+ *
+ * @param   index - index in the connected device list
+ *
+ * @return  the connection context, or NULL past the last connection
  */
-App_connInfo *Connection_getConnList(void);
+App_connCtx *Connection_getCtxByIndex(uint8_t index);
 
 /*********************************************************************
  * @fn      Connection_getConnhandle
@@ -314,21 +729,808 @@ uint16_t Connection_getConnhandle(uint8_t index);
 /*********************************************************************
  * @fn      Connection_getConnIndex
  *
- * @brief   Find index in the connected device list by connHandle
+ * @brief   Find the context slot of a connection. The slot does not
+ *          change while the link is up.
  *
- * @return  the index of the entry that has the given connection handle.
+ * @return  the slot of the given connection handle.
  *          if there is no match, LL_INACTIVE_CONNECTIONS will be returned.
  */
 uint16_t Connection_getConnIndex(uint16_t connHandle);
 
-void doAttWriteReq(uint16 handle, uint8_t *inputValue, uint16_t inputLen);
+/*********************************************************************
+ * @fn      Ta010_nonce
+ *
+ * @brief   Execute the TA010 Nonce command
+ *
+ * @param   nonce - buffer of APP_NONCE_LEN bytes
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_nonce(uint8_t *nonce);
+
+/*********************************************************************
+ * @fn      Ta010_sign
+ *
+ * @brief   Execute the TA010 Sign command over a SHA256 digest
+ *
+ * @param   digest - 32 bytes digest
+ * @param   signature - buffer of 64 bytes for r + s
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_sign(uint8_t *digest, uint8_t *signature);
+
+/*********************************************************************
+ * @fn      Ta010_getPublicKey
+ *
+ * @brief   Execute the TA010 GenKey command: public key of the slot 0
+ *          private key that Ta010_sign uses
+ *
+ * @param   publicKey - buffer of CERT_PUBLIC_KEY_LEN bytes for X || Y
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_getPublicKey(uint8_t *publicKey);
+
+/*********************************************************************
+ * @fn      Ta010_signAsync
+ *
+ * @brief   Start the TA010 Sign command without waiting for it, or
+ *          right after a discarded one
+ *
+ * @param   digest - 32 bytes digest
+ * @param   doneCB - called in the BLEAppUtil context when done
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_signAsync(uint8_t *digest, InvokeFromBLEAppUtilContext_t doneCB);
+
+/*********************************************************************
+ * @fn      Ta010_getSignResult
+ *
+ * @brief   Take the signature of the last Ta010_signAsync call
+ *
+ * @param   signature - buffer of 64 bytes for r + s
+ *
+ * @return  SUCCESS if a signature was ready, FAILURE otherwise
+ */
+bStatus_t Ta010_getSignResult(uint8_t *signature);
+
+/*********************************************************************
+ * @fn      Ta010_discardSign
+ *
+ * @brief   Drop the result of the pending Sign command
+ *
+ * @return  none
+ */
+void Ta010_discardSign(void);
+
+/*********************************************************************
+ * @fn      PhaseTimer_start
+ *
+ * @brief   Start timing a handshake phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_start(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_stop
+ *
+ * @brief   Stop timing a handshake phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_stop(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_getUs
+ *
+ * @brief   Duration of the last run of a phase in microseconds
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  duration
+ */
+uint32_t PhaseTimer_getUs(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_getOverlapUs
+ *
+ * @brief   Time in microseconds during which two phases ran together
+ *
+ * @param   phaseA - one of App_phases
+ * @param   phaseB - one of App_phases
+ *
+ * @return  overlap
+ */
+uint32_t PhaseTimer_getOverlapUs(uint8_t phaseA, uint8_t phaseB);
+
+/*********************************************************************
+ * @fn      PhaseTimer_reset
+ *
+ * @brief   Stop and clear every phase timer, e.g. when the handshake
+ *          failed or the link it was timing is gone
+ *
+ * @return  none
+ */
+void PhaseTimer_reset(void);
+
+/*********************************************************************
+ * @fn      Frag_init
+ *
+ * @brief   Clear the fragmentation layer
+ *
+ * @return  none
+ */
+void Frag_init(void);
+
+/*********************************************************************
+ * @fn      Frag_reset
+ *
+ * @brief   Drop the queued and partly received messages of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Frag_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Frag_send
+ *
+ * @brief   Send a handshake message, split in fragments when the
+ *          ATT_MTU of the link is too small
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   pMsg - message
+ * @param   len - length of the message
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER or bleMemAllocError
+ */
+bStatus_t Frag_send(uint16_t connHandle, uint16_t attHandle, uint8_t method,
+                    const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_begin
+ *
+ * @brief   Start a message given in parts with Frag_write. The parts
+ *          are copied straight in the stack buffers of the fragments.
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   len - length of the whole message
+ *
+ * @return  SUCCESS, INVALIDPARAMETER or bleMemAllocError
+ */
+bStatus_t Frag_begin(uint16_t connHandle, uint16_t attHandle, uint8_t method, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_write
+ *
+ * @brief   Append a part to the message started by Frag_begin
+ *
+ * @param   pData - data, may be in flash
+ * @param   len - length of the data
+ *
+ * @return  none
+ */
+void Frag_write(const uint8_t *pData, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_end
+ *
+ * @brief   Finish the message started by Frag_begin
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER, bleMemAllocError
+ *          or the stack error that dropped the message
+ */
+bStatus_t Frag_end(void);
+
+/*********************************************************************
+ * @fn      Frag_receive
+ *
+ * @brief   Place a received PDU in the message buffer
+ *
+ * @param   connHandle - connection handle
+ * @param   ppMsg - in: PDU, out: complete message
+ * @param   pLen - in: length of the PDU, out: length of the message
+ * @param   pBuf - buffer the fragments are reassembled in
+ * @param   bufLen - size of pBuf
+ *
+ * @return  one of Frag_rxStatus
+ */
+uint8_t Frag_receive(uint16_t connHandle, uint8_t **ppMsg, uint16_t *pLen,
+                     uint8_t *pBuf, uint16_t bufLen);
+
+/*********************************************************************
+ * @fn      Frag_isFragment
+ *
+ * @brief   Tell a fragment from a whole message by its first byte
+ *
+ * @param   pPdu - received PDU
+ * @param   len - length of the PDU
+ *
+ * @return  TRUE when the PDU carries a fragment header
+ */
+uint8_t Frag_isFragment(const uint8_t *pPdu, uint16_t len);
+
+/*********************************************************************
+ * @fn      MutualAuth_init
+ *
+ * @brief   Register the callback of the authenticated links
+ *
+ * @param   doneCB - called when the peer FINISH was verified, may be NULL
+ *
+ * @return  none
+ */
+void MutualAuth_init(MutualAuth_doneCB_t doneCB);
+
+/*********************************************************************
+ * @fn      MutualAuth_reset
+ *
+ * @brief   Clear the mutual authentication state of the link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void MutualAuth_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      MutualAuth_start
+ *
+ * @brief   Send the HELLO message (certificate + nonce)
+ *
+ * @param   connHandle - connection handle
+ * @param   role - MUTUAL_AUTH_ROLE_CENTRAL or MUTUAL_AUTH_ROLE_PERIPHERAL
+ *
+ * @return  none
+ */
+void MutualAuth_start(uint16_t connHandle, uint8_t role);
+
+/*********************************************************************
+ * @fn      MutualAuth_processHello
+ *
+ * @brief   Verify the peer HELLO message
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processHello(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      MutualAuth_processFinish
+ *
+ * @brief   Verify the peer FINISH message
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processFinish(uint16_t connHandle, uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_init
+ *
+ * @brief   Register the callback of the verified chains
+ *
+ * @param   doneCB - called when a chain is verified or rejected, may be NULL
+ *
+ * @return  none
+ */
+void CertChain_init(CertChain_doneCB_t doneCB);
+
+/*********************************************************************
+ * @fn      CertChain_reset
+ *
+ * @brief   Clear the certificate chain state of the link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      CertChain_request
+ *
+ * @brief   Ask the peripheral for its certificate chain (central)
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_request(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      CertChain_processRequest
+ *
+ * @brief   Start sending the local certificate chain (peripheral)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processRequest(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_processLink
+ *
+ * @brief   Verify a received certificate of the chain (central)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processLink(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_processAck
+ *
+ * @brief   Handle the acknowledgement or abort of a sent certificate
+ *          (peripheral)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processAck(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_getDeviceKey
+ *
+ * @brief   Public key of the peer device certificate, once its chain
+ *          is verified
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes, or NULL while the chain is not
+ *          verified
+ */
+const uint8_t *CertChain_getDeviceKey(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Connection_setParamProfile
+ *
+ * @brief   Request the connection parameters of a profile
+ *
+ * @param   connHandle - connection handle
+ * @param   profile - one of Connection_paramProfiles
+ *
+ * @return  SUCCESS or stack call status
+ */
+bStatus_t Connection_setParamProfile(uint16_t connHandle, uint8_t profile);
+
+/*********************************************************************
+ * @fn      LinkReady_init
+ *
+ * @brief   Clear the link readiness tracker
+ *
+ * @param   readyCB - called once per link when it is configured
+ *
+ * @return  none
+ */
+void LinkReady_init(LinkReady_readyCB_t readyCB);
+
+/*********************************************************************
+ * @fn      LinkReady_add
+ *
+ * @brief   Start tracking a new link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_add(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_remove
+ *
+ * @brief   Stop tracking a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_remove(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_setMtu
+ *
+ * @brief   Record the negotiated ATT_MTU
+ *
+ * @param   connHandle - connection handle
+ * @param   mtu - new ATT_MTU
+ *
+ * @return  none
+ */
+void LinkReady_setMtu(uint16_t connHandle, uint16_t mtu);
+
+/*********************************************************************
+ * @fn      LinkReady_setDataLen
+ *
+ * @brief   Record the negotiated LL payload sizes
+ *
+ * @param   connHandle - connection handle
+ * @param   txOctets - max LL payload sent
+ * @param   rxOctets - max LL payload received
+ *
+ * @return  none
+ */
+void LinkReady_setDataLen(uint16_t connHandle, uint16_t txOctets, uint16_t rxOctets);
+
+/*********************************************************************
+ * @fn      LinkReady_expectPhy
+ *
+ * @brief   Wait for a requested PHY update before the large transfers
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_expectPhy(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_setPhy
+ *
+ * @brief   Record the PHY of a link
+ *
+ * @param   connHandle - connection handle
+ * @param   phy - HCI_PHY_xx, or 0 when the update failed
+ *
+ * @return  none
+ */
+void LinkReady_setPhy(uint16_t connHandle, uint8_t phy);
+
+/*********************************************************************
+ * @fn      LinkReady_getMtu
+ *
+ * @brief   Negotiated ATT_MTU of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  ATT_MTU
+ */
+uint16_t LinkReady_getMtu(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_getStrategy
+ *
+ * @brief   Transfer strategy of a message on a link
+ *
+ * @param   connHandle - connection handle
+ * @param   msgLen - length of the message
+ *
+ * @return  one of LinkReady_strategies
+ */
+uint8_t LinkReady_getStrategy(uint16_t connHandle, uint16_t msgLen);
+
+/*********************************************************************
+ * @fn      CertStore_init
+ *
+ * @brief   Select the newest valid certificate bundle, and compute the
+ *          fingerprints of the built-in certificates when there is none
+ *
+ * @return  none
+ */
+void CertStore_init(void);
+
+/*********************************************************************
+ * @fn      CertStore_get
+ *
+ * @brief   Get a local certificate, the first one of its id
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL for an unknown id
+ */
+const uint8_t *CertStore_get(uint8_t certId);
+
+/*********************************************************************
+ * @fn      CertStore_getAt
+ *
+ * @brief   Get one of the local certificates of an id, a bundle may
+ *          hold several signers
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL past the last one
+ */
+const uint8_t *CertStore_getAt(uint8_t certId, uint8_t index);
+
+/*********************************************************************
+ * @fn      CertStore_getFingerprint
+ *
+ * @brief   Get the fingerprint of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  CERT_FINGERPRINT_LEN bytes, or NULL past the last one
+ */
+const uint8_t *CertStore_getFingerprint(uint8_t certId, uint8_t index);
+
+/*********************************************************************
+ * @fn      CertStore_findByFingerprint
+ *
+ * @brief   Find a local certificate from its fingerprint
+ *
+ * @param   pFingerprint - CERT_FINGERPRINT_LEN bytes
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByFingerprint(const uint8_t *pFingerprint);
+
+/*********************************************************************
+ * @fn      CertStore_findByPublicKey
+ *
+ * @brief   Find a local certificate of an id from its public key
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes X || Y
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByPublicKey(uint8_t certId, const uint8_t *pPublicKey);
+
+/*********************************************************************
+ * @fn      CertStore_verifySigned
+ *
+ * @brief   Verify a certificate against each signer of the store
+ *
+ * @param   pCert - certificate, see CertView_parse
+ *
+ * @return  ECDSA_STATUS_SUCCESS when a signer signed it,
+ *          CERT_STORE_REVOKED_STATUS, otherwise the error of the last
+ *          verification
+ */
+int_fast16_t CertStore_verifySigned(const CertView_t *pCert);
+
+/*********************************************************************
+ * @fn      CertStore_verifyCert
+ *
+ * @brief   Verify a received certificate against the key of its
+ *          signer, after checking the revocation list
+ *
+ * @param   pCert - certificate, see CertView_parse
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes key of the signer
+ *
+ * @return  ECDSA_STATUS_SUCCESS, CERT_STORE_REVOKED_STATUS or the
+ *          error of the verification
+ */
+int_fast16_t CertStore_verifyCert(const CertView_t *pCert, const uint8_t *pPublicKey);
+
+/*********************************************************************
+ * @fn      CertStore_getPublicKey
+ *
+ * @brief   Get the public key of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes in flash, or NULL for an
+ *          unknown id
+ */
+const uint8_t *CertStore_getPublicKey(uint8_t certId);
+
+/*********************************************************************
+ * @fn      RadioStats_start
+ *
+ * @brief   Start the radio statistics collector
+ *
+ * @param   sampleCB - called for each link every sampling period, or NULL
+ *
+ * @return  SUCCESS or stack call status
+ */
+bStatus_t RadioStats_start(RadioStats_sampleCB_t sampleCB);
+
+/*********************************************************************
+ * @fn      RadioStats_add
+ *
+ * @brief   Start collecting the statistics of a new link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_add(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_remove
+ *
+ * @brief   Stop collecting the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_remove(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_reset
+ *
+ * @brief   Restart the rolling averages of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_get
+ *
+ * @brief   Read the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ * @param   pStats - filled with the statistics
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if the link is unknown
+ */
+bStatus_t RadioStats_get(uint16_t connHandle, RadioStats_t *pStats);
+
+/*********************************************************************
+ * @fn      RadioStats_serialize
+ *
+ * @brief   Write the statistics of a link for the diagnostic
+ *          characteristic
+ *
+ * @param   connHandle - connection handle
+ * @param   pBuf - RADIO_STATS_SERIAL_LEN bytes
+ *
+ * @return  none
+ */
+void RadioStats_serialize(uint16_t connHandle, uint8_t *pBuf);
+
+/*********************************************************************
+ * @fn      RadioStats_print
+ *
+ * @brief   Print the statistics of a link on the menu
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_print(uint16_t connHandle);
+
+#if APP_MEM_STATS
+/*********************************************************************
+ * @fn      MemStats_start
+ *
+ * @brief   Watch the stack of the calling task, the BLEAppUtil task
+ *          when called from the stack init done handler.
+ *
+ * @param   appStackSize - stack size of the calling task in bytes
+ *
+ * @return  none
+ */
+void MemStats_start(uint32_t appStackSize);
+
+/*********************************************************************
+ * @fn      MemStats_addTask
+ *
+ * @brief   Watch the stack of a task. Tasks added twice are kept once.
+ *
+ * @param   taskHandle - FreeRTOS handle of the task
+ * @param   stackSize - stack size of the task in bytes
+ *
+ * @return  none
+ */
+void MemStats_addTask(void *taskHandle, uint32_t stackSize);
+
+/*********************************************************************
+ * @fn      MemStats_get
+ *
+ * @brief   Stack high water marks of the watched tasks, heap
+ *          watermarks and allocation failures since boot
+ *
+ * @param   pStats - filled with the statistics
+ *
+ * @return  none
+ */
+void MemStats_get(MemStats_t *pStats);
+
+/*********************************************************************
+ * @fn      MemStats_serialize
+ *
+ * @brief   Little endian form of the statistics for Characteristic 8
+ *
+ * @param   pBuf - MEM_STATS_SERIAL_LEN bytes
+ *
+ * @return  none
+ */
+void MemStats_serialize(uint8_t *pBuf);
+
+/*********************************************************************
+ * @fn      MemStats_print
+ *
+ * @brief   Print the statistics on the menu
+ *
+ * @return  none
+ */
+void MemStats_print(void);
+
+/*********************************************************************
+ * @fn      MemStats_bmAlloc
+ *
+ * @brief   GATT_bm_alloc that counts the failed allocations
+ *
+ * @param   connHandle - connection handle
+ * @param   opcode - ATT opcode of the message
+ * @param   size - payload size
+ *
+ * @return  payload buffer, NULL if the allocation failed
+ */
+void *MemStats_bmAlloc(uint16_t connHandle, uint8_t opcode, uint16_t size);
+
+/*********************************************************************
+ * @fn      MemStats_malloc
+ *
+ * @brief   ICall_malloc that counts the failed allocations
+ *
+ * @param   size - bytes to allocate
+ *
+ * @return  buffer, NULL if the allocation failed
+ */
+void *MemStats_malloc(uint32_t size);
+#else
+#define MemStats_bmAlloc(connHandle, opcode, size)  GATT_bm_alloc(connHandle, opcode, size, NULL)
+#define MemStats_malloc(size)                       ICall_malloc(size)
+#endif
+
+#if APP_CRYPTO_PROF
+/*********************************************************************
+ * @fn      CryptoProf_getLocalOob
+ *
+ * @brief   GAPBondMgr_SCGetLocalOOBParameters that records its duration
+ *
+ * @param   pLocalOobData - filled with the new local OOB data
+ *
+ * @return  status of GAPBondMgr_SCGetLocalOOBParameters
+ */
+bStatus_t CryptoProf_getLocalOob(gapBondOOBData_t *pLocalOobData);
+
+/*********************************************************************
+ * @fn      CryptoProf_print
+ *
+ * @brief   Print the crypto operation statistics on the menu
+ *
+ * @return  none
+ */
+void CryptoProf_print(void);
+#else
+#define CryptoProf_getLocalOob(pLocalOobData)       GAPBondMgr_SCGetLocalOOBParameters(pLocalOobData)
+#endif
+
+void doAttWriteReq(uint16 connHandle, uint16 handle, const uint8_t *inputValue, uint16_t inputLen);
+
+void doAttWriteNoRsp(uint16 connHandle, uint16 handle, const uint8_t *inputValue, uint16_t inputLen);
 
-void doAttWriteNoRsp(uint16 handle, uint8_t *inputValue, uint16_t inputLen);
+void doAttReadReq(uint16 connHandle, uint16 handle, uint8 charNum);
 
-void doAttReadReq(uint16 handle, uint8 charNum);
+void doAttReadLongReq(uint16 connHandle, uint16 handle, uint8 charNum);
 
-void doAttNotification(uint16 handle, uint8_t *notiVal, uint16_t len);
+void doAttNotification(uint16 connHandle, uint16 handle, const uint8_t *notiVal, uint16_t len);
 
-bStatus_t doAttMtuExchange(uint16 MTUVals);
+bStatus_t doAttMtuExchange(uint16 connHandle, uint16 MTUVals);
 
 #endif /* APP_MAIN_H_ */
@@ -0,0 +1,286 @@
+/******************************************************************************
+
+@file  app_mem_stats.c
+
+@brief This file contains the stack and heap watermark instrumentation
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <icall.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if APP_MEM_STATS
+/*
+ * The kernel fills a new task stack with tskSTACK_FILL_BYTE when the high
+ * water mark API is built in, uxTaskGetStackHighWaterMark then scans for
+ * the first overwritten word. No extra painting is needed here.
+ */
+#if !defined(INCLUDE_uxTaskGetStackHighWaterMark) || (INCLUDE_uxTaskGetStackHighWaterMark == 0)
+#error "APP_MEM_STATS requires INCLUDE_uxTaskGetStackHighWaterMark in FreeRTOSConfig.h"
+#endif
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef struct
+{
+    TaskHandle_t handle;
+    uint32_t     stackSize;     // Bytes
+}MemStats_task_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static MemStats_task_t memStatsTasks[MEM_STATS_MAX_TASKS];
+static uint8_t memStatsNumTasks = 0;
+static uint16_t memStatsBmAllocFailures = 0;
+static uint16_t memStatsMallocFailures = 0;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      MemStats_start
+ *
+ * @brief   Watch the stack of the calling task, the BLEAppUtil task
+ *          when called from the stack init done handler.
+ *
+ * @param   appStackSize - stack size of the calling task in bytes
+ *
+ * @return  none
+ */
+void MemStats_start(uint32_t appStackSize)
+{
+    MemStats_addTask(xTaskGetCurrentTaskHandle(), appStackSize);
+}
+
+/*********************************************************************
+ * @fn      MemStats_addTask
+ *
+ * @brief   Watch the stack of a task. Tasks added twice are kept once.
+ *
+ * @param   taskHandle - FreeRTOS handle of the task
+ * @param   stackSize - stack size of the task in bytes
+ *
+ * @return  none
+ */
+void MemStats_addTask(void *taskHandle, uint32_t stackSize)
+{
+    uint8_t i;
+
+    if (taskHandle == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < memStatsNumTasks; i++)
+    {
+        if (memStatsTasks[i].handle == (TaskHandle_t)taskHandle)
+        {
+            return;
+        }
+    }
+
+    if (memStatsNumTasks < MEM_STATS_MAX_TASKS)
+    {
+        memStatsTasks[memStatsNumTasks].handle = (TaskHandle_t)taskHandle;
+        memStatsTasks[memStatsNumTasks].stackSize = stackSize;
+        memStatsNumTasks++;
+    }
+}
+
+/*********************************************************************
+ * @fn      MemStats_get
+ *
+ * @brief   Stack high water marks of the watched tasks, heap
+ *          watermarks and allocation failures since boot
+ *
+ * @param   pStats - filled with the statistics
+ *
+ * @return  none
+ */
+void MemStats_get(MemStats_t *pStats)
+{
+    uint8_t i;
+    uint32_t freeBytes;
+
+    memset(pStats, 0, sizeof(MemStats_t));
+
+    pStats->numTasks = memStatsNumTasks;
+    for (i = 0; i < memStatsNumTasks; i++)
+    {
+        freeBytes = uxTaskGetStackHighWaterMark(memStatsTasks[i].handle) * sizeof(StackType_t);
+        pStats->tasks[i].stackSize = memStatsTasks[i].stackSize;
+        pStats->tasks[i].stackPeak = (freeBytes < memStatsTasks[i].stackSize) ?
+                                     (memStatsTasks[i].stackSize - freeBytes) : 0;
+    }
+
+    // ICall_malloc and GATT_bm_alloc are served by the kernel heap
+    pStats->heapSize = configTOTAL_HEAP_SIZE;
+    pStats->heapFree = xPortGetFreeHeapSize();
+    pStats->heapMinFree = xPortGetMinimumEverFreeHeapSize();
+    pStats->bmAllocFailures = memStatsBmAllocFailures;
+    pStats->mallocFailures = memStatsMallocFailures;
+}
+
+/*********************************************************************
+ * @fn      MemStats_serialize
+ *
+ * @brief   Little endian form of the statistics for Characteristic 8:
+ *          stack size and peak of each task slot, heap size, free
+ *          and lowest free, GATT_bm_alloc and ICall_malloc failures.
+ *          Unused task slots are zero.
+ *
+ * @param   pBuf - MEM_STATS_SERIAL_LEN bytes
+ *
+ * @return  none
+ */
+void MemStats_serialize(uint8_t *pBuf)
+{
+    MemStats_t stats;
+    uint8_t i;
+
+    MemStats_get(&stats);
+
+    for (i = 0; i < MEM_STATS_MAX_TASKS; i++)
+    {
+        *pBuf++ = LO_UINT16(stats.tasks[i].stackSize);
+        *pBuf++ = HI_UINT16(stats.tasks[i].stackSize);
+        *pBuf++ = LO_UINT16(stats.tasks[i].stackPeak);
+        *pBuf++ = HI_UINT16(stats.tasks[i].stackPeak);
+    }
+    *pBuf++ = LO_UINT16(stats.heapSize);
+    *pBuf++ = HI_UINT16(stats.heapSize);
+    *pBuf++ = LO_UINT16(stats.heapFree);
+    *pBuf++ = HI_UINT16(stats.heapFree);
+    *pBuf++ = LO_UINT16(stats.heapMinFree);
+    *pBuf++ = HI_UINT16(stats.heapMinFree);
+    *pBuf++ = LO_UINT16(stats.bmAllocFailures);
+    *pBuf++ = HI_UINT16(stats.bmAllocFailures);
+    *pBuf++ = LO_UINT16(stats.mallocFailures);
+    *pBuf   = HI_UINT16(stats.mallocFailures);
+}
+
+/*********************************************************************
+ * @fn      MemStats_print
+ *
+ * @brief   Print the statistics on the menu
+ *
+ * @return  none
+ */
+void MemStats_print(void)
+{
+    MemStats_t stats;
+    uint8_t i;
+
+    MemStats_get(&stats);
+
+    for (i = 0; i < stats.numTasks; i++)
+    {
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1 + i, 0, "Stack %s: peak = %d of %d bytes",
+                          pcTaskGetName(memStatsTasks[i].handle),
+                          stats.tasks[i].stackPeak, stats.tasks[i].stackSize);
+    }
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE5, 0, "Heap: peak = %d of %d bytes free = %d - "
+                      "alloc failures: GATT_bm = %d ICall = %d",
+                      stats.heapSize - stats.heapMinFree, stats.heapSize, stats.heapFree,
+                      stats.bmAllocFailures, stats.mallocFailures);
+}
+
+/*********************************************************************
+ * @fn      MemStats_bmAlloc
+ *
+ * @brief   GATT_bm_alloc that counts the failed allocations
+ *
+ * @param   connHandle - connection handle
+ * @param   opcode - ATT opcode of the message
+ * @param   size - payload size
+ *
+ * @return  payload buffer, NULL if the allocation failed
+ */
+void *MemStats_bmAlloc(uint16_t connHandle, uint8_t opcode, uint16_t size)
+{
+    void *pBuf = GATT_bm_alloc(connHandle, opcode, size, NULL);
+
+    if (pBuf == NULL)
+    {
+        memStatsBmAllocFailures++;
+    }
+
+    return pBuf;
+}
+
+/*********************************************************************
+ * @fn      MemStats_malloc
+ *
+ * @brief   ICall_malloc that counts the failed allocations
+ *
+ * @param   size - bytes to allocate
+ *
+ * @return  buffer, NULL if the allocation failed
+ */
+void *MemStats_malloc(uint32_t size)
+{
+    void *pBuf = ICall_malloc(size);
+
+    if (pBuf == NULL)
+    {
+        memStatsMallocFailures++;
+    }
+
+    return pBuf;
+}
+#endif // APP_MEM_STATS
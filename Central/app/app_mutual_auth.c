@@ -0,0 +1,465 @@
+/******************************************************************************
+
+@file  app_mutual_auth.c
+
+@brief This file contains the single round mutual challenge-response
+       functionality
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include <app_nonce_pool.h>
+
+#include <ti/drivers/SHA2.h>
+#include <ti/drivers/ECDSA.h>
+
+#if APP_MUTUAL_AUTH
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Peer characteristic handles used by the central (GATT client)
+#define MUTUAL_AUTH_HELLO_HANDLE    40  // Characteristic 2
+#define MUTUAL_AUTH_FINISH_HANDLE   53  // Characteristic 6
+// Handle the peripheral notifies on (Characteristic 4)
+#define MUTUAL_AUTH_NOTI_HANDLE     46
+
+// Progress of the two flights
+#define MUTUAL_AUTH_HELLO_SENT      BV(0)
+#define MUTUAL_AUTH_PEER_HELLO_OK   BV(1)
+#define MUTUAL_AUTH_FINISH_SENT     BV(2)
+#define MUTUAL_AUTH_PEER_FINISH_OK  BV(3)
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Handshake state of a link
+typedef struct
+{
+    uint16_t connHandle;
+    uint8_t  role;
+    uint8_t  flags;
+    uint8_t  ownNonce[APP_NONCE_LEN];
+    uint8_t  peerNonce[APP_NONCE_LEN];
+    // Public key of the verified peer certificate
+    uint8_t  peerPublicKey[CERT_PUBLIC_KEY_LEN];
+}MutualAuth_link_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static MutualAuth_link_t *MutualAuth_getLink(uint16_t connHandle);
+static void MutualAuth_begin(MutualAuth_link_t *pLink, uint16 handle, uint16_t len);
+static void MutualAuth_end(MutualAuth_link_t *pLink, uint8_t id);
+static void MutualAuth_send(MutualAuth_link_t *pLink, uint16 handle, uint8_t *pMsg, uint16_t len);
+static void MutualAuth_trySendFinish(MutualAuth_link_t *pLink);
+static int_fast16_t MutualAuth_transcriptHash(const uint8_t *first, const uint8_t *second, uint8_t *digest);
+static void MutualAuth_fail(MutualAuth_link_t *pLink, uint8_t reason);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Indexed by the connection context slot of the connection module
+static MutualAuth_link_t mutualAuthLinks[MAX_NUM_BLE_CONNS];
+static MutualAuth_doneCB_t mutualAuthDoneCB = NULL;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      MutualAuth_init
+ *
+ * @brief   Register the callback of the authenticated links.
+ *
+ * @param   doneCB - called when the peer FINISH was verified, may be NULL
+ *
+ * @return  none
+ */
+void MutualAuth_init(MutualAuth_doneCB_t doneCB)
+{
+    mutualAuthDoneCB = doneCB;
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_reset
+ *
+ * @brief   Clear the handshake state, called for every new link.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void MutualAuth_reset(uint16_t connHandle)
+{
+    MutualAuth_link_t *pLink = MutualAuth_getLink(connHandle);
+
+    if (pLink != NULL)
+    {
+        memset(pLink, 0, sizeof(MutualAuth_link_t));
+        pLink->connHandle = connHandle;
+    }
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_start
+ *
+ * @brief   Send the first flight: the device certificate of the
+ *          TA010 key followed by a fresh nonce. Both sides call this
+ *          as soon as the ATT MTU allows it, so both flights run at
+ *          the same time.
+ *
+ * @param   connHandle - connection handle
+ * @param   role - MUTUAL_AUTH_ROLE_CENTRAL or MUTUAL_AUTH_ROLE_PERIPHERAL
+ *
+ * @return  none
+ */
+void MutualAuth_start(uint16_t connHandle, uint8_t role)
+{
+    MutualAuth_link_t *pLink = MutualAuth_getLink(connHandle);
+    uint8_t id = MUTUAL_AUTH_HELLO_ID;
+    uint8_t publicKey[CERT_PUBLIC_KEY_LEN];
+    const uint8_t *pOwnCert;
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    pLink->role = role;
+    if (pLink->flags & MUTUAL_AUTH_HELLO_SENT)
+    {
+        return;
+    }
+
+    // FINISH is signed with the TA010 key, so HELLO carries the device
+    // certificate of that key, whichever device certificates the bundle
+    // holds
+    if (Ta010_getPublicKey(publicKey) != SUCCESS ||
+        (pOwnCert = CertStore_findByPublicKey(CERT_STORE_DEVICE, publicKey)) == NULL)
+    {
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE3, 0, "no device certificate of the TA010 key");
+        MutualAuth_fail(pLink, MUTUAL_AUTH_HELLO_ID);
+        return;
+    }
+
+    if (NoncePool_get(pLink->ownNonce) != NONCE_POOL_SUCCESS)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_HELLO_ID);
+        return;
+    }
+
+    // The certificate goes from flash straight to the stack buffers
+    MutualAuth_begin(pLink, MUTUAL_AUTH_HELLO_HANDLE, MUTUAL_AUTH_HELLO_LEN);
+    Frag_write(&id, 1);
+    Frag_write(pOwnCert, APP_CERT_LEN);
+    Frag_write(pLink->ownNonce, APP_NONCE_LEN);
+    MutualAuth_end(pLink, MUTUAL_AUTH_HELLO_ID);
+    pLink->flags |= MUTUAL_AUTH_HELLO_SENT;
+
+    // The peer HELLO may have arrived before ours was sent
+    MutualAuth_trySendFinish(pLink);
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_processHello
+ *
+ * @brief   Verify the peer certificate of a HELLO message and keep
+ *          the peer nonce and public key for the second flight.
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received HELLO message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processHello(uint16_t connHandle, const uint8_t *pMsg, uint16_t len)
+{
+    MutualAuth_link_t *pLink = MutualAuth_getLink(connHandle);
+    const CertView_t *pCert;
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    if (len < MUTUAL_AUTH_HELLO_LEN)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_HELLO_ID);
+        return;
+    }
+
+    // The certificate is hashed and verified where it was received
+    pCert = CertView_parse(&pMsg[1], len - 1);
+    if (pCert->id != 1)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_HELLO_ID);
+        return;
+    }
+
+    // The peer has its own identity, issued by one of our signers
+    if (CertStore_verifySigned(pCert) != ECDSA_STATUS_SUCCESS)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_HELLO_ID);
+        return;
+    }
+
+    memcpy(pLink->peerPublicKey, pCert->publicKey, sizeof(pCert->publicKey));
+    memcpy(pLink->peerNonce, &pMsg[1 + APP_CERT_LEN], APP_NONCE_LEN);
+    pLink->flags |= MUTUAL_AUTH_PEER_HELLO_OK;
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE3, 0, "peer certificate verify status = %d - connectionHandle = %d",
+                      ECDSA_STATUS_SUCCESS, connHandle);
+
+    MutualAuth_trySendFinish(pLink);
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_processFinish
+ *
+ * @brief   Verify the peer signature over both nonces. The done
+ *          callback runs once the peer is authenticated.
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received FINISH message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processFinish(uint16_t connHandle, uint8_t *pMsg, uint16_t len)
+{
+    MutualAuth_link_t *pLink = MutualAuth_getLink(connHandle);
+    uint8_t shaDigest[CRYPTO_CTX_DIGEST_LEN];
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    // Our nonce is accepted only once, a replayed FINISH is rejected
+    if (len < MUTUAL_AUTH_FINISH_LEN || !(pLink->flags & MUTUAL_AUTH_PEER_HELLO_OK) ||
+        NoncePool_consume(pLink->ownNonce) != NONCE_POOL_SUCCESS)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_FINISH_ID);
+        return;
+    }
+
+    // The peer signed our nonce followed by its own
+    if (MutualAuth_transcriptHash(pLink->ownNonce, pLink->peerNonce, shaDigest) != SHA2_STATUS_SUCCESS ||
+        CryptoCtx_verifyDigest(pLink->peerPublicKey, shaDigest, &pMsg[1]) != ECDSA_STATUS_SUCCESS)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_FINISH_ID);
+        return;
+    }
+
+    pLink->flags |= MUTUAL_AUTH_PEER_FINISH_OK;
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0, "mutual challenge verify status = %d - connectionHandle = %d",
+                      ECDSA_STATUS_SUCCESS, connHandle);
+
+    if (mutualAuthDoneCB != NULL)
+    {
+        mutualAuthDoneCB(connHandle, pLink->role);
+    }
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_getLink
+ *
+ * @brief   Handshake state of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the state, NULL for an unknown link
+ */
+static MutualAuth_link_t *MutualAuth_getLink(uint16_t connHandle)
+{
+    uint16_t connIdx = Connection_getConnIndex(connHandle);
+
+    if (connIdx >= MAX_NUM_BLE_CONNS)
+    {
+        return NULL;
+    }
+
+    return &mutualAuthLinks[connIdx];
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_trySendFinish
+ *
+ * @brief   Send the second flight once our HELLO is out and the peer
+ *          HELLO was verified.
+ *
+ * @param   pLink - handshake state of the link
+ *
+ * @return  none
+ */
+static void MutualAuth_trySendFinish(MutualAuth_link_t *pLink)
+{
+    uint8_t finishMsg[MUTUAL_AUTH_FINISH_LEN];
+    uint8_t shaDigest[CRYPTO_CTX_DIGEST_LEN];
+
+    if ((pLink->flags & (MUTUAL_AUTH_HELLO_SENT | MUTUAL_AUTH_PEER_HELLO_OK)) !=
+        (MUTUAL_AUTH_HELLO_SENT | MUTUAL_AUTH_PEER_HELLO_OK) ||
+        (pLink->flags & MUTUAL_AUTH_FINISH_SENT))
+    {
+        return;
+    }
+
+    // Sign the peer nonce first, so our signature can not be reflected
+    // back to us as the peer's one. The TA010 key is the one of the
+    // certificate of our HELLO, see MutualAuth_start.
+    finishMsg[0] = MUTUAL_AUTH_FINISH_ID;
+    if (MutualAuth_transcriptHash(pLink->peerNonce, pLink->ownNonce, shaDigest) != SHA2_STATUS_SUCCESS ||
+        Ta010_sign(shaDigest, &finishMsg[1]) != SUCCESS)
+    {
+        MutualAuth_fail(pLink, MUTUAL_AUTH_FINISH_ID);
+        return;
+    }
+
+    MutualAuth_send(pLink, MUTUAL_AUTH_FINISH_HANDLE, finishMsg, sizeof(finishMsg));
+    pLink->flags |= MUTUAL_AUTH_FINISH_SENT;
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_begin
+ *
+ * @brief   Start a handshake message, given in parts with Frag_write:
+ *          the central writes the peer characteristic, the peripheral
+ *          notifies.
+ *
+ * @param   pLink - handshake state of the link
+ * @param   handle - peer characteristic handle (central only)
+ * @param   len - length of the message
+ *
+ * @return  none, errors are reported by MutualAuth_end
+ */
+static void MutualAuth_begin(MutualAuth_link_t *pLink, uint16 handle, uint16_t len)
+{
+    if (pLink->role == MUTUAL_AUTH_ROLE_CENTRAL)
+    {
+        Frag_begin(pLink->connHandle, handle, ATT_WRITE_CMD, len);
+    }
+    else
+    {
+        Frag_begin(pLink->connHandle, MUTUAL_AUTH_NOTI_HANDLE, ATT_HANDLE_VALUE_NOTI, len);
+    }
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_end
+ *
+ * @brief   Finish the message started by MutualAuth_begin
+ *
+ * @param   pLink - handshake state of the link
+ * @param   id - message id, reported if the message could not be sent
+ *
+ * @return  none
+ */
+static void MutualAuth_end(MutualAuth_link_t *pLink, uint8_t id)
+{
+    if (Frag_end() != SUCCESS)
+    {
+        MutualAuth_fail(pLink, id);
+    }
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_send
+ *
+ * @brief   Send a handshake message held in a buffer
+ *
+ * @param   pLink - handshake state of the link
+ * @param   handle - peer characteristic handle (central only)
+ * @param   pMsg - message to send
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+static void MutualAuth_send(MutualAuth_link_t *pLink, uint16 handle, uint8_t *pMsg, uint16_t len)
+{
+    MutualAuth_begin(pLink, handle, len);
+    Frag_write(pMsg, len);
+    MutualAuth_end(pLink, pMsg[0]);
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_transcriptHash
+ *
+ * @brief   SHA256 over two concatenated nonces.
+ *
+ * @param   first - nonce hashed first
+ * @param   second - nonce hashed second
+ * @param   digest - CRYPTO_CTX_DIGEST_LEN bytes output, not valid on
+ *                   error
+ *
+ * @return  SHA2_STATUS_SUCCESS or the driver error
+ */
+static int_fast16_t MutualAuth_transcriptHash(const uint8_t *first, const uint8_t *second, uint8_t *digest)
+{
+    uint8_t transcript[2 * APP_NONCE_LEN];
+
+    memcpy(transcript, first, APP_NONCE_LEN);
+    memcpy(&transcript[APP_NONCE_LEN], second, APP_NONCE_LEN);
+
+    return CryptoCtx_hash(transcript, sizeof(transcript), digest);
+}
+
+/*********************************************************************
+ * @fn      MutualAuth_fail
+ *
+ * @brief   Abort the handshake and drop the link.
+ *
+ * @param   pLink - handshake state of the link
+ * @param   reason - id of the message that failed
+ *
+ * @return  none
+ */
+static void MutualAuth_fail(MutualAuth_link_t *pLink, uint8_t reason)
+{
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0, "mutual authentication failed - message 0x%02x - connectionHandle = %d",
+                      reason, pLink->connHandle);
+    pLink->flags = 0;
+    BLEAppUtil_disconnect(pLink->connHandle);
+}
+
+#endif // APP_MUTUAL_AUTH
@@ -0,0 +1,295 @@
+/******************************************************************************
+
+@file  app_nonce_pool.c
+
+@brief This file contains the nonce pool and the replay window of the
+       challenge-response
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <app_nonce_pool.h>
+
+#ifdef NONCE_POOL_HOST
+#include <stdio.h>
+#else
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/drivers/RNG.h>
+#include <app_main.h>
+#endif
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define RNG_INSTANCE 0
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static uint8_t NoncePool_random(uint8_t *pBuf, uint16_t len);
+static uint8_t NoncePool_tagEqual(const uint8_t *a, const uint8_t *b);
+#ifndef NONCE_POOL_HOST
+static void NoncePool_refillCB(char *pData);
+#endif
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static uint8_t noncePool[NONCE_POOL_SIZE][NONCE_POOL_NONCE_LEN];
+static uint8_t noncePoolCount = 0;
+
+// Tags of the last issued nonces, written round robin
+static uint8_t nonceWindowTag[NONCE_POOL_WINDOW_SIZE][NONCE_POOL_TAG_LEN];
+static uint8_t nonceWindowNext = 0;
+// One bit per window entry, set while the nonce is waiting for an answer
+static uint8_t nonceWindowOutstanding = 0;
+#ifndef NONCE_POOL_HOST
+static uint8_t noncePoolRefillPending = 0;
+#endif
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      NoncePool_init
+ *
+ * @brief   Clear the replay window and fill the pool
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_init(void)
+{
+    noncePoolCount = 0;
+    nonceWindowNext = 0;
+    nonceWindowOutstanding = 0;
+    memset(nonceWindowTag, 0, sizeof(nonceWindowTag));
+
+    return NoncePool_fill();
+}
+
+/*********************************************************************
+ * @fn      NoncePool_fill
+ *
+ * @brief   Top up the pool from the random source. Meant to run
+ *          outside of the authentication messages.
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_fill(void)
+{
+    while (noncePoolCount < NONCE_POOL_SIZE)
+    {
+        if (NoncePool_random(noncePool[noncePoolCount], NONCE_POOL_NONCE_LEN) != NONCE_POOL_SUCCESS)
+        {
+            return NONCE_POOL_ERROR;
+        }
+        noncePoolCount++;
+    }
+
+    return NONCE_POOL_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      NoncePool_get
+ *
+ * @brief   Hand out a nonce and remember it in the replay window.
+ *          Falls back to the random source when the pool is empty.
+ *
+ * @param   nonce - buffer of NONCE_POOL_NONCE_LEN bytes
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_get(uint8_t *nonce)
+{
+    if (noncePoolCount > 0)
+    {
+        noncePoolCount--;
+        memcpy(nonce, noncePool[noncePoolCount], NONCE_POOL_NONCE_LEN);
+        // Do not leave a handed out nonce behind in the pool
+        memset(noncePool[noncePoolCount], 0, NONCE_POOL_NONCE_LEN);
+    }
+    else if (NoncePool_random(nonce, NONCE_POOL_NONCE_LEN) != NONCE_POOL_SUCCESS)
+    {
+        return NONCE_POOL_ERROR;
+    }
+
+    memcpy(nonceWindowTag[nonceWindowNext], nonce, NONCE_POOL_TAG_LEN);
+    nonceWindowOutstanding |= (1 << nonceWindowNext);
+    nonceWindowNext = (nonceWindowNext + 1) % NONCE_POOL_WINDOW_SIZE;
+
+#ifndef NONCE_POOL_HOST
+    // Refill once the current message has been handled
+    if (!noncePoolRefillPending)
+    {
+        noncePoolRefillPending = 1;
+        BLEAppUtil_invokeFunctionNoData(NoncePool_refillCB);
+    }
+#endif
+
+    return NONCE_POOL_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      NoncePool_consume
+ *
+ * @brief   Check that a nonce was issued by NoncePool_get and was not
+ *          used yet, then mark it as used.
+ *
+ * @param   nonce - nonce the peer answered to
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_REPLAY
+ */
+uint8_t NoncePool_consume(const uint8_t *nonce)
+{
+    uint8_t match = 0;
+    uint8_t i;
+
+    // Walk the whole window so the time does not depend on the match
+    for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+    {
+        uint8_t hit = NoncePool_tagEqual(nonceWindowTag[i], nonce) &
+                      ((nonceWindowOutstanding >> i) & 1);
+        match |= (uint8_t)(hit << i);
+    }
+
+    if (match == 0)
+    {
+        return NONCE_POOL_REPLAY;
+    }
+
+    nonceWindowOutstanding &= ~match;
+    return NONCE_POOL_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      NoncePool_tagEqual
+ *
+ * @brief   Constant time compare of a window tag with a nonce
+ *
+ * @return  1 if equal, 0 otherwise
+ */
+static uint8_t NoncePool_tagEqual(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    uint8_t i;
+
+    for (i = 0; i < NONCE_POOL_TAG_LEN; i++)
+    {
+        diff |= a[i] ^ b[i];
+    }
+
+    return (uint8_t)(((uint16_t)diff - 1) >> 8) & 1;
+}
+
+#ifdef NONCE_POOL_HOST
+/*********************************************************************
+ * @fn      NoncePool_random
+ *
+ * @brief   Host backend, reads the random bytes from /dev/urandom
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+static uint8_t NoncePool_random(uint8_t *pBuf, uint16_t len)
+{
+    static FILE *pRandom = NULL;
+
+    if (pRandom == NULL)
+    {
+        pRandom = fopen("/dev/urandom", "rb");
+        if (pRandom == NULL)
+        {
+            return NONCE_POOL_ERROR;
+        }
+    }
+
+    return (fread(pBuf, 1, len, pRandom) == len) ? NONCE_POOL_SUCCESS : NONCE_POOL_ERROR;
+}
+#else
+/*********************************************************************
+ * @fn      NoncePool_random
+ *
+ * @brief   Target backend, reads the random bytes from the TRNG or
+ *          from the TA010 Nonce command
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+static uint8_t NoncePool_random(uint8_t *pBuf, uint16_t len)
+{
+#if NONCE_POOL_USE_TA010
+    (void)len;
+    return (Ta010_nonce(pBuf) == SUCCESS) ? NONCE_POOL_SUCCESS : NONCE_POOL_ERROR;
+#else
+    RNG_Handle handle;
+    int_fast16_t result;
+
+    RNG_init();
+    handle = RNG_open(RNG_INSTANCE, NULL);
+    if (handle == NULL)
+    {
+        return NONCE_POOL_ERROR;
+    }
+
+    result = RNG_getRandomBits(handle, pBuf, len * 8);
+    RNG_close(handle);
+
+    return (result == RNG_STATUS_SUCCESS) ? NONCE_POOL_SUCCESS : NONCE_POOL_ERROR;
+#endif // NONCE_POOL_USE_TA010
+}
+
+/*********************************************************************
+ * @fn      NoncePool_refillCB
+ *
+ * @brief   Runs in the BLEAppUtil context after a nonce was taken
+ *
+ * @param   pData - unused
+ *
+ * @return  none
+ */
+static void NoncePool_refillCB(char *pData)
+{
+    (void)pData;
+
+    noncePoolRefillPending = 0;
+    NoncePool_fill();
+}
+#endif // NONCE_POOL_HOST
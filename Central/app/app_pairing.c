@@ -62,10 +62,16 @@ Target Device: cc23xx
 
 void Pairing_passcodeHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+static void Pairing_startNext(void);
 
 //*****************************************************************************
 //! Globals
 //*****************************************************************************
+// Order of the next pairing request, stored in the connection context
+static uint8_t pairingNextSeq = 0;
+// Link being paired
+static uint16_t pairingActiveHandle = LINKDB_CONNHANDLE_INVALID;
+
 BLEAppUtil_EventHandler_t pairingPasscodeHandler =
 {
     .handlerType    = BLEAPPUTIL_PASSCODE_TYPE,
@@ -142,8 +148,6 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
             // The pairing is completed, so update the entry in connection list
             // to the ID address instead of the RP address
             linkDBInfo_t linkInfo;
-            // Get the list of connected devices
-            App_connInfo* connList = Connection_getConnList();
             if (linkDB_GetInfo(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle, &linkInfo) == SUCCESS)
             {
               // If the peer was using private address, update with ID address
@@ -152,17 +156,30 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                    !osal_isbufset(linkInfo.addrPriv, 0, B_ADDR_LEN))
               {
 
-                // Get the index of connection list by connHandle
-                uint8_t connIdx = Connection_getConnIndex(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle);
+                // Get the connection context by connHandle
+                App_connCtx *pCtx = Connection_getCtx(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle);
 
                 // Verify that there is a match of connection handle
-                if (connIdx != LL_INACTIVE_CONNECTIONS)
+                if (pCtx != NULL)
                 {
-                  // Update the connection list with the ID address
-                  memcpy(connList[connIdx].peerAddress, linkInfo.addr, B_ADDR_LEN);
+                  // Update the connection context with the ID address
+                  memcpy(pCtx->peerAddress, linkInfo.addr, B_ADDR_LEN);
                 }
               }
             }
+
+            // The remote OOB data is free for the next link
+            if (((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle == pairingActiveHandle)
+            {
+                App_connCtx *pCtx = Connection_getCtx(pairingActiveHandle);
+
+                if (pCtx != NULL)
+                {
+                    pCtx->pairState = PAIRING_LINK_IDLE;
+                }
+                pairingActiveHandle = LINKDB_CONNHANDLE_INVALID;
+                Pairing_startNext();
+            }
             break;
         }
 
@@ -183,6 +200,13 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                               "status = "MENU_MODULE_COLOR_YELLOW "%d " MENU_MODULE_COLOR_RESET,
                               ((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle,
                               ((BLEAppUtil_PairStateData_t *)pMsgData)->status);
+
+            // The handshake is over, move to the sensor traffic parameters
+            if (((BLEAppUtil_PairStateData_t *)pMsgData)->status == SUCCESS)
+            {
+                Connection_setParamProfile(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle,
+                                           CONN_PARAM_PROFILE_SENSOR);
+            }
             break;
         }
 
@@ -194,6 +218,103 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 
 }
 
+/*********************************************************************
+ * @fn      Pairing_request
+ *
+ * @brief   Pair an authenticated link with the OOB data of its
+ *          connection context. The remote OOB data of the bond manager
+ *          is shared by all links, so one link is paired at a time and
+ *          the other requests wait their turn.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER for an unknown link
+ */
+bStatus_t Pairing_request(uint16_t connHandle)
+{
+    App_connCtx *pCtx = Connection_getCtx(connHandle);
+
+    if (pCtx == NULL)
+    {
+        return INVALIDPARAMETER;
+    }
+
+    pCtx->pairState = PAIRING_LINK_QUEUED;
+    pCtx->pairSeq = pairingNextSeq++;
+
+    if (pairingActiveHandle == LINKDB_CONNHANDLE_INVALID)
+    {
+        Pairing_startNext();
+    }
+
+    return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      Pairing_remove
+ *
+ * @brief   Release the bond manager OOB data held by a terminated
+ *          link. A queued request leaves with the connection context.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Pairing_remove(uint16_t connHandle)
+{
+    if (connHandle == pairingActiveHandle)
+    {
+        pairingActiveHandle = LINKDB_CONNHANDLE_INVALID;
+        Pairing_startNext();
+    }
+}
+
+/*********************************************************************
+ * @fn      Pairing_startNext
+ *
+ * @brief   Load the OOB data of the oldest queued link in the bond
+ *          manager and pair that link
+ *
+ * @return  none
+ */
+static void Pairing_startNext(void)
+{
+    uint8_t oobEnabled = TRUE;
+    App_connCtx *pNext;
+    App_connCtx *pCtx;
+    uint8_t i;
+
+    while (pairingActiveHandle == LINKDB_CONNHANDLE_INVALID)
+    {
+        pNext = NULL;
+        for (i = 0; (pCtx = Connection_getCtxByIndex(i)) != NULL; i++)
+        {
+            // Oldest request first, the sequence number wraps around
+            if (pCtx->pairState == PAIRING_LINK_QUEUED &&
+                (pNext == NULL || (int8_t)(pCtx->pairSeq - pNext->pairSeq) < 0))
+            {
+                pNext = pCtx;
+            }
+        }
+        if (pNext == NULL)
+        {
+            break;
+        }
+
+        GAPBondMgr_SetParameter(GAPBOND_OOB_ENABLED, sizeof(uint8_t), &oobEnabled);
+        GAPBondMgr_SCSetRemoteOOBParameters(&pNext->remoteOob, 1);
+        if (GAPBondMgr_Pair(pNext->connHandle) == SUCCESS)
+        {
+            pNext->pairState = PAIRING_LINK_ACTIVE;
+            pairingActiveHandle = pNext->connHandle;
+        }
+        else
+        {
+            pNext->pairState = PAIRING_LINK_IDLE;
+        }
+    }
+}
+
 /*********************************************************************
  * @fn      Pairing_start
  *
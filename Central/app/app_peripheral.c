@@ -67,16 +67,22 @@ Target Device: cc23xx
 //*****************************************************************************
 //! Includes
 //*****************************************************************************
+#include <string.h>
 #include "ti_ble_config.h"
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
+#include <ti/bleapp/profiles/simple_gatt/simple_gatt_profile.h>
 
 //*****************************************************************************
 //! Prototypes
 //*****************************************************************************
 void Peripheral_AdvEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Peripheral_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+#if APP_OOB_IN_ADV_DATA
+static uint8 Peripheral_buildOobAdData(uint8 *pBuf, uint8 adType, uint8 *pValue,
+                                       const uint8 *pSrc, uint8 srcLen);
+#endif
 
 //*****************************************************************************
 //! Globals
@@ -124,6 +130,14 @@ const BLEAppUtil_AdvStart_t advSetStartParamsSet_1 =
     .durationOrMaxEvents   = 0
 };
 
+#if APP_OOB_IN_ADV_DATA
+// Advertising and scan response buffers holding the OOB values. They replace
+// advData1/scanResData1 once the local OOB data is available, and keep the
+// leading AD structures of the Sysconfig data that still fit.
+static uint8 peripheralOobAdvData[GAP_ADV_DATA_LEN_MAX];
+static uint8 peripheralOobScanRspData[GAP_ADV_DATA_LEN_MAX];
+#endif
+
 //*****************************************************************************
 //! Functions
 //*****************************************************************************
@@ -201,6 +215,10 @@ void Peripheral_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 
         case BLEAPPUTIL_LINK_TERMINATED_EVENT:
         {
+#if APP_OOB_IN_ADV_DATA
+            // Never advertise the OOB data of a finished pairing attempt again
+            Peripheral_updateOobAdvData();
+#endif
             BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsSet_1);
             break;
         }
@@ -212,6 +230,109 @@ void Peripheral_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     }
 }
 
+#if APP_OOB_IN_ADV_DATA
+/*********************************************************************
+ * @fn      Peripheral_buildOobAdData
+ *
+ * @brief   Build an advertising payload that starts with a 16 bytes
+ *          OOB AD structure, followed by the AD structures of pSrc
+ *          that still fit in a legacy advertising PDU.
+ *
+ * @param   pBuf - buffer of GAP_ADV_DATA_LEN_MAX bytes to fill
+ * @param   adType - AD type of the OOB value
+ * @param   pValue - 16 bytes OOB value
+ * @param   pSrc - original advertising data
+ * @param   srcLen - length of the original advertising data
+ *
+ * @return  length of the data written to pBuf
+ */
+static uint8 Peripheral_buildOobAdData(uint8 *pBuf, uint8 adType, uint8 *pValue,
+                                       const uint8 *pSrc, uint8 srcLen)
+{
+    uint8 len = 0;
+    uint8 i = 0;
+
+    pBuf[len++] = KEYLEN + 1;
+    pBuf[len++] = adType;
+    memcpy(&pBuf[len], pValue, KEYLEN);
+    len += KEYLEN;
+
+    // Copy the original AD structures as long as they fit
+    while (i < srcLen && pSrc[i] != 0)
+    {
+        uint8 adLen = pSrc[i] + 1;
+
+        if (i + adLen > srcLen || len + adLen > GAP_ADV_DATA_LEN_MAX)
+        {
+            break;
+        }
+        memcpy(&pBuf[len], &pSrc[i], adLen);
+        len += adLen;
+        i += adLen;
+    }
+
+    return len;
+}
+
+/*********************************************************************
+ * @fn      Peripheral_updateOobAdvData
+ *
+ * @brief   Generate new local OOB data, store it in Characteristic 1
+ *          and load the confirm/random values into the advertising
+ *          and scan response data of the advertise set.
+ *
+ * @return  SUCCESS, errorInfo
+ */
+bStatus_t Peripheral_updateOobAdvData(void)
+{
+    bStatus_t status;
+    uint8 advLen;
+    uint8 scanRspLen;
+    uint8_t charValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
+
+    status = CryptoProf_getLocalOob(&localOobData);
+    if(status != SUCCESS)
+    {
+        return(status);
+    }
+
+    // Keep Characteristic 1 in sync for centrals that still read it
+    memcpy(charValue1, localOobData.confirm, KEYLEN);
+    memcpy(charValue1 + KEYLEN, localOobData.rand, KEYLEN);
+    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR1, SIMPLEGATTPROFILE_CHAR1_LEN,
+                                    charValue1 );
+
+    advLen = Peripheral_buildOobAdData(peripheralOobAdvData, APP_ADTYPE_SC_CONFIRM_VALUE,
+                                       localOobData.confirm, advData1, sizeof(advData1));
+    scanRspLen = Peripheral_buildOobAdData(peripheralOobScanRspData, APP_ADTYPE_SC_RANDOM_VALUE,
+                                           localOobData.rand, scanResData1, sizeof(scanResData1));
+
+    // The Sysconfig buffers are static, the stack must not free them
+    status = GapAdv_prepareLoadByHandle(peripheralAdvHandle_1, GAP_ADV_FREE_OPTION_DONT_FREE);
+    if(status == SUCCESS)
+    {
+        status = GapAdv_loadByHandle(peripheralAdvHandle_1, GAP_ADV_DATA_TYPE_ADV,
+                                     advLen, peripheralOobAdvData);
+    }
+
+    if(status == SUCCESS)
+    {
+        status = GapAdv_prepareLoadByHandle(peripheralAdvHandle_1, GAP_ADV_FREE_OPTION_DONT_FREE);
+    }
+    if(status == SUCCESS)
+    {
+        status = GapAdv_loadByHandle(peripheralAdvHandle_1, GAP_ADV_DATA_TYPE_SCAN_RSP,
+                                     scanRspLen, peripheralOobScanRspData);
+    }
+
+    MenuModule_printf(APP_MENU_ADV_EVENT, 0, "Adv status: OOB data loaded - status: "
+                      MENU_MODULE_COLOR_YELLOW "%d" MENU_MODULE_COLOR_RESET,
+                      status);
+
+    return(status);
+}
+#endif // APP_OOB_IN_ADV_DATA
+
 /*********************************************************************
  * @fn      Peripheral_start
  *
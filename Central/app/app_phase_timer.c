@@ -0,0 +1,177 @@
+/******************************************************************************
+
+@file  app_phase_timer.c
+
+@brief This file contains the handshake phase timers
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_main.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef struct
+{
+    uint32_t startTick;
+    uint32_t stopTick;
+    uint8_t  running;
+}PhaseTimer_t;
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static PhaseTimer_t phaseTimers[APP_PHASE_NUM];
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      PhaseTimer_start
+ *
+ * @brief   Start timing a handshake phase. A phase that is already
+ *          running keeps its start time.
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_start(uint8_t phase)
+{
+    if (phase < APP_PHASE_NUM && !phaseTimers[phase].running)
+    {
+        phaseTimers[phase].startTick = ClockP_getSystemTicks();
+        phaseTimers[phase].stopTick = phaseTimers[phase].startTick;
+        phaseTimers[phase].running = TRUE;
+    }
+}
+
+/*********************************************************************
+ * @fn      PhaseTimer_stop
+ *
+ * @brief   Stop timing a handshake phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_stop(uint8_t phase)
+{
+    if (phase < APP_PHASE_NUM && phaseTimers[phase].running)
+    {
+        phaseTimers[phase].stopTick = ClockP_getSystemTicks();
+        phaseTimers[phase].running = FALSE;
+    }
+}
+
+/*********************************************************************
+ * @fn      PhaseTimer_getUs
+ *
+ * @brief   Duration of the last run of a phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  duration in microseconds
+ */
+uint32_t PhaseTimer_getUs(uint8_t phase)
+{
+    if (phase >= APP_PHASE_NUM)
+    {
+        return 0;
+    }
+
+    return (phaseTimers[phase].stopTick - phaseTimers[phase].startTick) * ClockP_getSystemTickPeriod();
+}
+
+/*********************************************************************
+ * @fn      PhaseTimer_getOverlapUs
+ *
+ * @brief   Time during which two phases were running together
+ *
+ * @param   phaseA - one of App_phases
+ * @param   phaseB - one of App_phases
+ *
+ * @return  overlap in microseconds
+ */
+uint32_t PhaseTimer_getOverlapUs(uint8_t phaseA, uint8_t phaseB)
+{
+    uint32_t start;
+    uint32_t stop;
+
+    if (phaseA >= APP_PHASE_NUM || phaseB >= APP_PHASE_NUM)
+    {
+        return 0;
+    }
+
+    // Compare the ticks relative to phase A, so a tick wrap does not matter
+    start = phaseTimers[phaseB].startTick - phaseTimers[phaseA].startTick;
+    stop = phaseTimers[phaseB].stopTick - phaseTimers[phaseA].startTick;
+    if ((int32_t)start < 0)
+    {
+        start = 0;
+    }
+    if ((int32_t)stop > (int32_t)(phaseTimers[phaseA].stopTick - phaseTimers[phaseA].startTick))
+    {
+        stop = phaseTimers[phaseA].stopTick - phaseTimers[phaseA].startTick;
+    }
+
+    return ((int32_t)stop > (int32_t)start) ? (stop - start) * ClockP_getSystemTickPeriod() : 0;
+}
+
+/*********************************************************************
+ * @fn      PhaseTimer_reset
+ *
+ * @brief   Stop and clear every phase timer, so a phase left running
+ *          by a failed handshake or a lost link restarts on the next
+ *          one instead of reporting its stale start time.
+ *
+ * @return  none
+ */
+void PhaseTimer_reset(void)
+{
+    memset(phaseTimers, 0, sizeof(phaseTimers));
+}
@@ -0,0 +1,529 @@
+/******************************************************************************
+
+@file  app_radio_stats.c
+
+@brief This file contains the per-link radio statistics collector
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+#if APP_RADIO_STATS
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Fractional bits of the rolling averages
+#define RADIO_STATS_FRAC_BITS   8
+#define RADIO_STATS_ONE         (1L << RADIO_STATS_FRAC_BITS)
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef struct
+{
+    uint16_t connHandle;
+    uint16_t lastEvtCounter;    // eventCounter of the last report
+    uint8_t  evtCounterValid;   // lastEvtCounter holds a report
+    uint8_t  phy;               // HCI_PHY_xx of the last report
+    int8_t   lastRssi;          // RSSI of the last received event
+    // Counters of the current sampling period
+    uint16_t evtCount;
+    uint16_t crcCount;
+    uint16_t missCount;
+    uint16_t rssiCount;
+    int32_t  rssiSum;
+    // Rolling averages, scaled by RADIO_STATS_ONE
+    int32_t  avgRssi;
+    uint8_t  avgRssiValid;      // avgRssi holds a sample
+    int32_t  avgCrcPct;
+    int32_t  avgMissPct;
+    int32_t  avgEvtRate;
+    uint32_t avgEvents;         // Events in the averages since the last reset
+    // Totals since the connection
+    uint32_t totalEvents;
+    uint32_t totalCrc;
+    uint32_t totalMissed;
+    uint32_t totalSkipped;
+}RadioStats_link_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+void RadioStats_ConnNotiEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+static RadioStats_link_t *RadioStats_find(uint16_t connHandle);
+static int32_t RadioStats_average(int32_t avg, int32_t sample, uint8_t seeded);
+static void RadioStats_timerCB(uintptr_t arg);
+static void RadioStats_sampleCB(char *pData);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+BLEAppUtil_EventHandler_t radioStatsConnNotiHandler =
+{
+    .handlerType    = BLEAPPUTIL_CONN_NOTI_TYPE,
+    .pEventHandler  = RadioStats_ConnNotiEventHandler,
+    .eventMask      = BLEAPPUTIL_CONN_NOTI_CONN_EVENT_ALL
+};
+
+// Indexed by the connection context slot of the connection module
+static RadioStats_link_t radioStatsList[MAX_NUM_BLE_CONNS];
+static uint8_t radioStatsNumLinks = 0;
+static RadioStats_sampleCB_t radioStatsCB = NULL;
+static ClockP_Struct radioStatsTimer;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      RadioStats_start
+ *
+ * @brief   Clear the collector and subscribe to the connection event
+ *          reports of all the links.
+ *
+ * @param   sampleCB - called for each link at the end of every
+ *                     sampling period, in the BLEAppUtil context.
+ *                     May be NULL.
+ *
+ * @return  SUCCESS or stack call status
+ */
+bStatus_t RadioStats_start(RadioStats_sampleCB_t sampleCB)
+{
+    bStatus_t status;
+    uint8_t i;
+    ClockP_Params clockParams;
+    uint32_t periodTicks = (APP_RADIO_STATS_PERIOD_MS * 1000) / ClockP_getSystemTickPeriod();
+
+    radioStatsCB = sampleCB;
+    radioStatsNumLinks = 0;
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        radioStatsList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+    }
+
+    ClockP_Params_init(&clockParams);
+    clockParams.period = periodTicks;
+    ClockP_construct(&radioStatsTimer, RadioStats_timerCB, periodTicks, &clockParams);
+
+    status = BLEAppUtil_registerEventHandler(&radioStatsConnNotiHandler);
+    if (status != SUCCESS)
+    {
+        return status;
+    }
+
+    return BLEAppUtil_registerConnNotifHandler(LINKDB_CONNHANDLE_ALL);
+}
+
+/*********************************************************************
+ * @fn      RadioStats_add
+ *
+ * @brief   Start collecting the statistics of a new link. The link
+ *          must already be in the connection module.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_add(uint16_t connHandle)
+{
+    uint16_t slot = Connection_getConnIndex(connHandle);
+    RadioStats_link_t *pLink;
+
+    if (slot >= MAX_NUM_BLE_CONNS)
+    {
+        return;
+    }
+
+    pLink = &radioStatsList[slot];
+    if (pLink->connHandle == LINKDB_CONNHANDLE_INVALID)
+    {
+        radioStatsNumLinks++;
+    }
+
+    memset(pLink, 0, sizeof(RadioStats_link_t));
+    pLink->connHandle = connHandle;
+    pLink->phy = HCI_PHY_1_MBPS;
+
+    // Sample only while there is a link
+    if (radioStatsNumLinks == 1)
+    {
+        ClockP_start(ClockP_handle(&radioStatsTimer));
+    }
+}
+
+/*********************************************************************
+ * @fn      RadioStats_remove
+ *
+ * @brief   Stop collecting the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_remove(uint16_t connHandle)
+{
+    RadioStats_link_t *pLink = RadioStats_find(connHandle);
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    pLink->connHandle = LINKDB_CONNHANDLE_INVALID;
+    if (--radioStatsNumLinks == 0)
+    {
+        ClockP_stop(ClockP_handle(&radioStatsTimer));
+    }
+}
+
+/*********************************************************************
+ * @fn      RadioStats_reset
+ *
+ * @brief   Restart the rolling averages of a link, e.g. after a PHY
+ *          or connection parameter change. The totals are kept.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_reset(uint16_t connHandle)
+{
+    RadioStats_link_t *pLink = RadioStats_find(connHandle);
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    pLink->evtCount = 0;
+    pLink->crcCount = 0;
+    pLink->missCount = 0;
+    pLink->rssiCount = 0;
+    pLink->rssiSum = 0;
+    pLink->avgEvents = 0;
+    pLink->avgRssiValid = FALSE;
+}
+
+/*********************************************************************
+ * @fn      RadioStats_get
+ *
+ * @brief   Read the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ * @param   pStats - filled with the statistics
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if the link is unknown
+ */
+bStatus_t RadioStats_get(uint16_t connHandle, RadioStats_t *pStats)
+{
+    RadioStats_link_t *pLink = RadioStats_find(connHandle);
+
+    if (pLink == NULL || pStats == NULL)
+    {
+        return INVALIDPARAMETER;
+    }
+
+    pStats->connHandle = connHandle;
+    pStats->phy = pLink->phy;
+    pStats->lastRssi = pLink->lastRssi;
+    pStats->avgRssi = (int8_t)(pLink->avgRssi / RADIO_STATS_ONE);
+    pStats->crcPct = (uint8_t)(pLink->avgCrcPct / RADIO_STATS_ONE);
+    pStats->missPct = (uint8_t)(pLink->avgMissPct / RADIO_STATS_ONE);
+    pStats->evtRate = (uint16_t)(pLink->avgEvtRate / RADIO_STATS_ONE);
+    pStats->avgEvents = pLink->avgEvents;
+    pStats->totalEvents = pLink->totalEvents;
+    pStats->totalCrc = pLink->totalCrc;
+    pStats->totalMissed = pLink->totalMissed;
+    pStats->totalSkipped = pLink->totalSkipped;
+
+    return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      RadioStats_serialize
+ *
+ * @brief   Write the statistics of a link in the little endian layout
+ *          of the diagnostic characteristic:
+ *          phy(1) lastRssi(1) avgRssi(1) crcPct(1) missPct(1)
+ *          evtRate(2) totalEvents(4) totalCrc(4) totalMissed(4)
+ *
+ * @param   connHandle - connection handle
+ * @param   pBuf - RADIO_STATS_SERIAL_LEN bytes, zeroed if the link
+ *                 is unknown
+ *
+ * @return  none
+ */
+void RadioStats_serialize(uint16_t connHandle, uint8_t *pBuf)
+{
+    RadioStats_t stats;
+
+    memset(pBuf, 0, RADIO_STATS_SERIAL_LEN);
+    if (RadioStats_get(connHandle, &stats) != SUCCESS)
+    {
+        return;
+    }
+
+    pBuf[0] = stats.phy;
+    pBuf[1] = (uint8_t)stats.lastRssi;
+    pBuf[2] = (uint8_t)stats.avgRssi;
+    pBuf[3] = stats.crcPct;
+    pBuf[4] = stats.missPct;
+    pBuf[5] = LO_UINT16(stats.evtRate);
+    pBuf[6] = HI_UINT16(stats.evtRate);
+    pBuf[7] = BREAK_UINT32(stats.totalEvents, 0);
+    pBuf[8] = BREAK_UINT32(stats.totalEvents, 1);
+    pBuf[9] = BREAK_UINT32(stats.totalEvents, 2);
+    pBuf[10] = BREAK_UINT32(stats.totalEvents, 3);
+    pBuf[11] = BREAK_UINT32(stats.totalCrc, 0);
+    pBuf[12] = BREAK_UINT32(stats.totalCrc, 1);
+    pBuf[13] = BREAK_UINT32(stats.totalCrc, 2);
+    pBuf[14] = BREAK_UINT32(stats.totalCrc, 3);
+    pBuf[15] = BREAK_UINT32(stats.totalMissed, 0);
+    pBuf[16] = BREAK_UINT32(stats.totalMissed, 1);
+    pBuf[17] = BREAK_UINT32(stats.totalMissed, 2);
+    pBuf[18] = BREAK_UINT32(stats.totalMissed, 3);
+}
+
+/*********************************************************************
+ * @fn      RadioStats_print
+ *
+ * @brief   Print the statistics of a link on the menu
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_print(uint16_t connHandle)
+{
+    RadioStats_t stats;
+
+    if (RadioStats_get(connHandle, &stats) != SUCCESS)
+    {
+        MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: No radio statistics for connHandle %d",
+                          connHandle);
+        return;
+    }
+
+    MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Radio stats: connHandle = %d PHY = %d "
+                      "RSSI = %d dBm (avg %d) events/period = %d",
+                      connHandle, stats.phy, stats.lastRssi, stats.avgRssi, stats.evtRate);
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE5, 0, "Radio stats: CRC errors = %d%% missed = %d%% - "
+                      "totals: events = %d CRC = %d missed = %d skipped = %d",
+                      stats.crcPct, stats.missPct, stats.totalEvents, stats.totalCrc,
+                      stats.totalMissed, stats.totalSkipped);
+}
+
+/*********************************************************************
+ * @fn      RadioStats_ConnNotiEventHandler
+ *
+ * @brief   Count the connection event reports of a link. A gap in
+ *          the event counter is an event the controller skipped
+ *          (slave latency or a scheduling conflict).
+ *
+ * @param   event - message event.
+ * @param   pMsgData - pointer to message data.
+ *
+ * @return  none
+ */
+void RadioStats_ConnNotiEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
+{
+    Gap_ConnEventRpt_t *pReport = (Gap_ConnEventRpt_t *)pMsgData;
+    RadioStats_link_t *pLink = RadioStats_find(pReport->handle);
+
+    if (pLink == NULL)
+    {
+        return;
+    }
+
+    if (pLink->evtCounterValid)
+    {
+        uint16_t gap = (uint16_t)(pReport->eventCounter - pLink->lastEvtCounter);
+
+        if (gap > 1)
+        {
+            pLink->totalSkipped += gap - 1;
+        }
+    }
+    pLink->lastEvtCounter = pReport->eventCounter;
+    pLink->evtCounterValid = TRUE;
+
+    pLink->phy = pReport->phy;
+    pLink->evtCount++;
+    pLink->totalEvents++;
+
+    if (pReport->status == GAP_CONN_EVT_STAT_MISSED)
+    {
+        // Nothing was received, the RSSI is not valid
+        pLink->missCount++;
+        pLink->totalMissed++;
+        return;
+    }
+
+    if (pReport->status == GAP_CONN_EVT_STAT_CRC_ERROR)
+    {
+        pLink->crcCount++;
+        pLink->totalCrc++;
+    }
+
+    pLink->lastRssi = pReport->lastRssi;
+    pLink->rssiSum += pReport->lastRssi;
+    pLink->rssiCount++;
+}
+
+/*********************************************************************
+ * @fn      RadioStats_find
+ *
+ * @brief   Find the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the link entry, or NULL if the link is unknown
+ */
+static RadioStats_link_t *RadioStats_find(uint16_t connHandle)
+{
+    uint16_t slot = Connection_getConnIndex(connHandle);
+
+    if (slot >= MAX_NUM_BLE_CONNS || radioStatsList[slot].connHandle != connHandle)
+    {
+        return NULL;
+    }
+
+    return &radioStatsList[slot];
+}
+
+/*********************************************************************
+ * @fn      RadioStats_average
+ *
+ * @brief   Fold a sample into an exponential moving average with a
+ *          weight of 1 / 2^APP_RADIO_STATS_AVG_SHIFT
+ *
+ * @param   avg - current average
+ * @param   sample - new sample, same scale as avg
+ * @param   seeded - FALSE if avg holds no sample yet
+ *
+ * @return  the new average
+ */
+static int32_t RadioStats_average(int32_t avg, int32_t sample, uint8_t seeded)
+{
+    if (!seeded)
+    {
+        return sample;
+    }
+
+    return avg + (sample - avg) / (1L << APP_RADIO_STATS_AVG_SHIFT);
+}
+
+/*********************************************************************
+ * @fn      RadioStats_timerCB
+ *
+ * @brief   Sampling period timer, runs in the clock context
+ *
+ * @param   arg - unused
+ *
+ * @return  none
+ */
+static void RadioStats_timerCB(uintptr_t arg)
+{
+    BLEAppUtil_invokeFunctionNoData(RadioStats_sampleCB);
+}
+
+/*********************************************************************
+ * @fn      RadioStats_sampleCB
+ *
+ * @brief   Fold the counters of the period into the rolling averages
+ *          of each link and hand the result to the link policies
+ *
+ * @param   pData - unused
+ *
+ * @return  none
+ */
+static void RadioStats_sampleCB(char *pData)
+{
+    uint8_t i;
+    RadioStats_link_t *pLink;
+    RadioStats_t stats;
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        pLink = &radioStatsList[i];
+        if (pLink->connHandle == LINKDB_CONNHANDLE_INVALID)
+        {
+            continue;
+        }
+
+        pLink->avgEvtRate = RadioStats_average(pLink->avgEvtRate,
+                                               (int32_t)pLink->evtCount * RADIO_STATS_ONE,
+                                               pLink->avgEvents != 0);
+        if (pLink->evtCount != 0)
+        {
+            if (pLink->rssiCount != 0)
+            {
+                pLink->avgRssi = RadioStats_average(pLink->avgRssi,
+                                                    (pLink->rssiSum * RADIO_STATS_ONE) / pLink->rssiCount,
+                                                    pLink->avgRssiValid);
+                pLink->avgRssiValid = TRUE;
+            }
+            pLink->avgCrcPct = RadioStats_average(pLink->avgCrcPct,
+                                                  ((int32_t)pLink->crcCount * 100 * RADIO_STATS_ONE) / pLink->evtCount,
+                                                  pLink->avgEvents != 0);
+            pLink->avgMissPct = RadioStats_average(pLink->avgMissPct,
+                                                   ((int32_t)pLink->missCount * 100 * RADIO_STATS_ONE) / pLink->evtCount,
+                                                   pLink->avgEvents != 0);
+            pLink->avgEvents += pLink->evtCount;
+        }
+
+        pLink->evtCount = 0;
+        pLink->crcCount = 0;
+        pLink->missCount = 0;
+        pLink->rssiCount = 0;
+        pLink->rssiSum = 0;
+
+        if (radioStatsCB != NULL && RadioStats_get(pLink->connHandle, &stats) == SUCCESS)
+        {
+            radioStatsCB(pLink->connHandle, &stats);
+        }
+    }
+}
+#endif // APP_RADIO_STATS
@@ -69,7 +69,7 @@
 /*********************************************************************
  * TYPEDEFS
  */
-void SimpleGattProfile_callback( uint8 paramID  );
+void SimpleGattProfile_callback( uint16 connHandle, uint8 paramID );
 void SimpleGattProfile_invokeFromFWContext( char *pData );
 
 /*********************************************************************
@@ -96,6 +96,16 @@ GATT_BT_UUID(simpleGattProfile_char5UUID, SIMPLEGATTPROFILE_CHAR5_UUID);
 // Characteristic 6 UUID: 0xFFF6
 GATT_BT_UUID(simpleGattProfile_char6UUID, SIMPLEGATTPROFILE_CHAR6_UUID);
 
+#if APP_RADIO_STATS
+// Characteristic 7 UUID: 0xFFF7
+GATT_BT_UUID(simpleGattProfile_char7UUID, SIMPLEGATTPROFILE_CHAR7_UUID);
+#endif
+
+#if APP_MEM_STATS
+// Characteristic 8 UUID: 0xFFF8
+GATT_BT_UUID(simpleGattProfile_char8UUID, SIMPLEGATTPROFILE_CHAR8_UUID);
+#endif
+
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -125,7 +135,7 @@ static uint8 simpleGattProfile_Char1Props = GATT_PROP_READ | GATT_PROP_WRITE | G
 static uint8 simpleGattProfile_Char1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
 
 // Simple GATT Profile Characteristic 1 User Description
-static uint8 simpleGattProfile_Char1UserDesp[17] = "Characteristic 1";
+static CONST uint8 simpleGattProfile_Char1UserDesp[17] = "Characteristic 1";
 
 
 // Simple GATT Profile Characteristic 2 Properties
@@ -135,7 +145,7 @@ static uint8 simpleGattProfile_Char2Props = GATT_PROP_READ | GATT_PROP_WRITE | G
 static uint8 simpleGattProfile_Char2[SIMPLEGATTPROFILE_CHAR2_LEN] = {0};
 
 // Simple Profile Characteristic 2 User Description
-static uint8 simpleGattProfile_Char2UserDesp[17] = "Characteristic 2";
+static CONST uint8 simpleGattProfile_Char2UserDesp[17] = "Characteristic 2";
 
 
 // Simple GATT Profile Characteristic 3 Properties
@@ -145,7 +155,7 @@ static uint8 simpleGattProfile_Char3Props = GATT_PROP_READ | GATT_PROP_WRITE | G
 static uint8 simpleGattProfile_Char3[SIMPLEGATTPROFILE_CHAR3_LEN] = {0};
 
 // Simple GATT Profile Characteristic 3 User Description
-static uint8 simpleGattProfile_Char3UserDesp[17] = "Characteristic 3";
+static CONST uint8 simpleGattProfile_Char3UserDesp[17] = "Characteristic 3";
 
 
 // Simple GATT Profile Characteristic 4 Properties
@@ -161,7 +171,7 @@ static uint8 simpleGattProfile_Char4[SIMPLEGATTPROFILE_CHAR4_LEN] = {0};
 static gattCharCfg_t *simpleGattProfile_Char4Config;
 
 // Simple GATT Profile Characteristic 4 User Description
-static uint8 simpleGattProfile_Char4UserDesp[17] = "Characteristic 4";
+static CONST uint8 simpleGattProfile_Char4UserDesp[17] = "Characteristic 4";
 
 
 // Simple GATT Profile Characteristic 5 Properties
@@ -171,7 +181,7 @@ static uint8 simpleGattProfile_Char5Props = GATT_PROP_READ | GATT_PROP_WRITE | G
 static uint8 simpleGattProfile_Char5[SIMPLEGATTPROFILE_CHAR5_LEN] = {0};
 
 // Simple GATT Profile Characteristic 5 User Description
-static uint8 simpleGattProfile_Char5UserDesp[17] = "Characteristic 5";
+static CONST uint8 simpleGattProfile_Char5UserDesp[17] = "Characteristic 5";
 
 // Simple GATT Profile Characteristic 6 Properties
 static uint8 simpleGattProfile_Char6Props = GATT_PROP_READ | GATT_PROP_WRITE | GATT_PROP_NOTIFY | GATT_PROP_WRITE_NO_RSP;
@@ -180,7 +190,34 @@ static uint8 simpleGattProfile_Char6Props = GATT_PROP_READ | GATT_PROP_WRITE | G
 static uint8 simpleGattProfile_Char6[SIMPLEGATTPROFILE_CHAR6_LEN] = {0};
 
 // Simple GATT Profile Characteristic 6 User Description
-static uint8 simpleGattProfile_Char6UserDesp[17] = "Characteristic 6";
+static CONST uint8 simpleGattProfile_Char6UserDesp[17] = "Characteristic 6";
+
+// Length of the last value written in characteristics 1 to 6, indexed by
+// parameter ID
+static uint16 simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR6 + 1] = {0};
+
+#if APP_RADIO_STATS
+// Simple GATT Profile Characteristic 7 Properties
+static uint8 simpleGattProfile_Char7Props = GATT_PROP_READ;
+
+// Characteristic 7 Value, filled from the radio statistics of the
+// reading link on each read
+static uint8 simpleGattProfile_Char7[SIMPLEGATTPROFILE_CHAR7_LEN] = {0};
+
+// Simple GATT Profile Characteristic 7 User Description
+static CONST uint8 simpleGattProfile_Char7UserDesp[12] = "Radio stats";
+#endif
+
+#if APP_MEM_STATS
+// Simple GATT Profile Characteristic 8 Properties
+static uint8 simpleGattProfile_Char8Props = GATT_PROP_READ;
+
+// Characteristic 8 Value, filled from the memory statistics on each read
+static uint8 simpleGattProfile_Char8[SIMPLEGATTPROFILE_CHAR8_LEN] = {0};
+
+// Simple GATT Profile Characteristic 8 User Description
+static CONST uint8 simpleGattProfile_Char8UserDesp[13] = "Memory stats";
+#endif
 
 /*********************************************************************
  * Profile Attributes - Table
@@ -197,21 +234,21 @@ static gattAttribute_t simpleGattProfile_attrTbl[] =
    // Characteristic Value 1
    GATT_BT_ATT( simpleGattProfile_char1UUID,  GATT_PERMIT_READ | GATT_PERMIT_WRITE,  simpleGattProfile_Char1 ),
    // Characteristic 1 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char1UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char1UserDesp ),
 
    // Characteristic 2 Declaration
    GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char2Props ),
    // Characteristic Value 2
    GATT_BT_ATT( simpleGattProfile_char2UUID,  GATT_PERMIT_READ | GATT_PERMIT_WRITE,  simpleGattProfile_Char2 ),
    // Characteristic 2 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char2UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char2UserDesp ),
 
    // Characteristic 3 Declaration
    GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char3Props ),
    // Characteristic Value 3
    GATT_BT_ATT( simpleGattProfile_char3UUID,  GATT_PERMIT_READ | GATT_PERMIT_WRITE,  simpleGattProfile_Char3 ),
    // Characteristic 3 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char3UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char3UserDesp ),
 
    // Characteristic 4 Declaration
    GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char4Props ),
@@ -220,21 +257,39 @@ static gattAttribute_t simpleGattProfile_attrTbl[] =
    // Characteristic 4 configuration
    GATT_BT_ATT( clientCharCfgUUID,            GATT_PERMIT_READ | GATT_PERMIT_WRITE,  (uint8 *) &simpleGattProfile_Char4Config ),
    // Characteristic 4 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char4UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char4UserDesp ),
 
    // Characteristic 5 Declaration
    GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char5Props ),
    // Characteristic Value 5
    GATT_BT_ATT( simpleGattProfile_char5UUID,  GATT_PERMIT_READ | GATT_PERMIT_WRITE,  simpleGattProfile_Char5 ),
    // Characteristic 5 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char5UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char5UserDesp ),
 
    // Characteristic 6 Declaration
    GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char6Props ),
    // Characteristic Value 6
    GATT_BT_ATT( simpleGattProfile_char6UUID,  GATT_PERMIT_READ | GATT_PERMIT_WRITE,  simpleGattProfile_Char6 ),
    // Characteristic 6 User Description
-   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      simpleGattProfile_Char6UserDesp ),
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char6UserDesp ),
+
+#if APP_RADIO_STATS
+   // Characteristic 7 Declaration
+   GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char7Props ),
+   // Characteristic Value 7
+   GATT_BT_ATT( simpleGattProfile_char7UUID,  GATT_PERMIT_READ,                      simpleGattProfile_Char7 ),
+   // Characteristic 7 User Description
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char7UserDesp ),
+#endif
+
+#if APP_MEM_STATS
+   // Characteristic 8 Declaration
+   GATT_BT_ATT( characterUUID,                GATT_PERMIT_READ,                      &simpleGattProfile_Char8Props ),
+   // Characteristic Value 8
+   GATT_BT_ATT( simpleGattProfile_char8UUID,  GATT_PERMIT_READ,                      simpleGattProfile_Char8 ),
+   // Characteristic 8 User Description
+   GATT_BT_ATT( charUserDescUUID,             GATT_PERMIT_READ,                      (uint8 *) simpleGattProfile_Char8UserDesp ),
+#endif
 };
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -248,6 +303,9 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
                                          gattAttribute_t *pAttr,
                                          uint8_t *pValue, uint16_t len,
                                          uint16_t offset, uint8_t method );
+static uint8 SimpleGattProfile_writeMsg( uint16_t connHandle, gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t len, uint16_t maxLen,
+                                         uint8 param );
 
 /*********************************************************************
  * PROFILE CALLBACKS
@@ -285,8 +343,8 @@ bStatus_t SimpleGattProfile_addService( void )
   uint8 status = SUCCESS;
 
   // Allocate Client Characteristic Configuration table
-  simpleGattProfile_Char4Config = (gattCharCfg_t *)ICall_malloc( sizeof( gattCharCfg_t ) *
-                                                                 MAX_NUM_BLE_CONNS );
+  simpleGattProfile_Char4Config = (gattCharCfg_t *)MemStats_malloc( sizeof( gattCharCfg_t ) *
+                                                                    MAX_NUM_BLE_CONNS );
   if ( simpleGattProfile_Char4Config == NULL )
   {
     return ( bleMemAllocError );
@@ -360,6 +418,7 @@ bStatus_t SimpleGattProfile_setParameter( uint8 param, uint8 len, void *value )
 //        status = bleInvalidRange;
 //      }
         memcpy(simpleGattProfile_Char1, value, SIMPLEGATTPROFILE_CHAR1_LEN);
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR1] = SIMPLEGATTPROFILE_CHAR1_LEN;
       break;
 
     case SIMPLEGATTPROFILE_CHAR2:
@@ -372,6 +431,7 @@ bStatus_t SimpleGattProfile_setParameter( uint8 param, uint8 len, void *value )
 //        status = bleInvalidRange;
 //      }
         memcpy(simpleGattProfile_Char2, value, SIMPLEGATTPROFILE_CHAR2_LEN);
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR2] = SIMPLEGATTPROFILE_CHAR2_LEN;
       break;
 
     case SIMPLEGATTPROFILE_CHAR3:
@@ -384,6 +444,7 @@ bStatus_t SimpleGattProfile_setParameter( uint8 param, uint8 len, void *value )
 //        status = bleInvalidRange;
 //      }
         memcpy(simpleGattProfile_Char3, value, SIMPLEGATTPROFILE_CHAR3_LEN);
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR3] = SIMPLEGATTPROFILE_CHAR3_LEN;
       break;
 
     case SIMPLEGATTPROFILE_CHAR4:
@@ -401,12 +462,14 @@ bStatus_t SimpleGattProfile_setParameter( uint8 param, uint8 len, void *value )
 //        status = bleInvalidRange;
 //      }
         memcpy(simpleGattProfile_Char4, value, SIMPLEGATTPROFILE_CHAR4_LEN);
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR4] = SIMPLEGATTPROFILE_CHAR4_LEN;
       break;
 
     case SIMPLEGATTPROFILE_CHAR5:
       if ( len == SIMPLEGATTPROFILE_CHAR5_LEN )
       {
         VOID memcpy( simpleGattProfile_Char5, value, SIMPLEGATTPROFILE_CHAR5_LEN );
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR5] = SIMPLEGATTPROFILE_CHAR5_LEN;
       }
       else
       {
@@ -417,6 +480,7 @@ bStatus_t SimpleGattProfile_setParameter( uint8 param, uint8 len, void *value )
     case SIMPLEGATTPROFILE_CHAR6:
 
         memcpy(simpleGattProfile_Char6, value, SIMPLEGATTPROFILE_CHAR6_LEN);
+        simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR6] = SIMPLEGATTPROFILE_CHAR6_LEN;
       break;
 
     default:
@@ -483,6 +547,70 @@ bStatus_t SimpleGattProfile_getParameter( uint8 param, void *value )
   return ( status );
 }
 
+/*********************************************************************
+ * @fn      SimpleGattProfile_getValue
+ *
+ * @brief   Get a Simple Profile characteristic value in place, without
+ *          copying it. The value stays valid until the next write of
+ *          the characteristic.
+ *
+ * @param   param - Profile parameter ID
+ * @param   pLen - length of the last value written, 0 before the first
+ *                 write, may be NULL
+ *
+ * @return  the value, or NULL for an unknown parameter ID
+ */
+const uint8 *SimpleGattProfile_getValue( uint8 param, uint16 *pLen )
+{
+  const uint8 *pValue;
+  uint16 len;
+
+  switch ( param )
+  {
+    case SIMPLEGATTPROFILE_CHAR1:
+      pValue = simpleGattProfile_Char1;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR1];
+      break;
+
+    case SIMPLEGATTPROFILE_CHAR2:
+      pValue = simpleGattProfile_Char2;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR2];
+      break;
+
+    case SIMPLEGATTPROFILE_CHAR3:
+      pValue = simpleGattProfile_Char3;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR3];
+      break;
+
+    case SIMPLEGATTPROFILE_CHAR4:
+      pValue = simpleGattProfile_Char4;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR4];
+      break;
+
+    case SIMPLEGATTPROFILE_CHAR5:
+      pValue = simpleGattProfile_Char5;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR5];
+      break;
+
+    case SIMPLEGATTPROFILE_CHAR6:
+      pValue = simpleGattProfile_Char6;
+      len = simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR6];
+      break;
+
+    default:
+      pValue = NULL;
+      len = 0;
+      break;
+  }
+
+  if ( pLen != NULL )
+  {
+    *pLen = len;
+  }
+
+  return ( pValue );
+}
+
 /*********************************************************************
  * @fn          SimpleGattProfile_readAttrCB
  *
@@ -506,8 +634,10 @@ bStatus_t SimpleGattProfile_readAttrCB(uint16_t connHandle,
 {
   bStatus_t status = SUCCESS;
 
-  // Make sure it's not a blob operation (no attributes in the profile are long)
-  if ( offset > 0 )
+  // Make sure it's not a blob operation (only Characteristic 1 is long,
+  // it does not fit in one Read Response when the ATT_MTU is 23)
+  if ( offset > 0 && !( pAttr->type.len == ATT_BT_UUID_SIZE &&
+                        BUILD_UINT16( pAttr->type.uuid[0], pAttr->type.uuid[1] ) == SIMPLEGATTPROFILE_CHAR1_UUID ) )
   {
     return ( ATT_ERR_ATTR_NOT_LONG );
   }
@@ -527,8 +657,14 @@ bStatus_t SimpleGattProfile_readAttrCB(uint16_t connHandle,
       // characteristic 4 does not have read permissions, but because it
       //   can be sent as a notification, it is included here
       case SIMPLEGATTPROFILE_CHAR1_UUID:
-          *pLen = SIMPLEGATTPROFILE_CHAR1_LEN;
-          VOID memcpy( pValue, pAttr->pValue, SIMPLEGATTPROFILE_CHAR1_LEN );
+          if ( offset > SIMPLEGATTPROFILE_CHAR1_LEN )
+          {
+            *pLen = 0;
+            status = ATT_ERR_INVALID_OFFSET;
+            break;
+          }
+          *pLen = MIN( maxLen, SIMPLEGATTPROFILE_CHAR1_LEN - offset );
+          VOID memcpy( pValue, pAttr->pValue + offset, *pLen );
           break;
       case SIMPLEGATTPROFILE_CHAR2_UUID:
           *pLen = SIMPLEGATTPROFILE_CHAR2_LEN;
@@ -555,6 +691,23 @@ bStatus_t SimpleGattProfile_readAttrCB(uint16_t connHandle,
         VOID memcpy( pValue, pAttr->pValue, SIMPLEGATTPROFILE_CHAR6_LEN );
         break;
 
+#if APP_RADIO_STATS
+      case SIMPLEGATTPROFILE_CHAR7_UUID:
+        // Statistics of the link the read came on
+        RadioStats_serialize( connHandle, pAttr->pValue );
+        *pLen = SIMPLEGATTPROFILE_CHAR7_LEN;
+        VOID memcpy( pValue, pAttr->pValue, SIMPLEGATTPROFILE_CHAR7_LEN );
+        break;
+#endif
+
+#if APP_MEM_STATS
+      case SIMPLEGATTPROFILE_CHAR8_UUID:
+        MemStats_serialize( pAttr->pValue );
+        *pLen = SIMPLEGATTPROFILE_CHAR8_LEN;
+        VOID memcpy( pValue, pAttr->pValue, SIMPLEGATTPROFILE_CHAR8_LEN );
+        break;
+#endif
+
       default:
         // Should never get here! (characteristics 3 and 4 do not have read permissions)
         *pLen = 0;
@@ -608,7 +761,7 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           if ( offset == 0 )
           {
 //            if ( len != 1 )
-            if ( len == 1 )
+            if ( len == 1 || len > SIMPLEGATTPROFILE_CHAR1_LEN )
             {
               status = ATT_ERR_INVALID_VALUE_SIZE;
             }
@@ -622,13 +775,11 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           if ( status == SUCCESS )
           {
             uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR1_LEN; i++)
-            {
-                pCurValue[i] = pValue[i];
-            }
+            VOID memcpy( pCurValue, pValue, len );
 //            *pCurValue = pValue[0];
             if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char1 )
             {
+              simpleGattProfile_CharLen[SIMPLEGATTPROFILE_CHAR1] = len;
               notifyApp = SIMPLEGATTPROFILE_CHAR1;
             }
           }
@@ -642,7 +793,7 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           if ( offset == 0 )
           {
 //            if ( len != 1 )
-            if ( len == 1 )
+            if ( len == 1 || len > SIMPLEGATTPROFILE_CHAR2_LEN )
             {
               status = ATT_ERR_INVALID_VALUE_SIZE;
             }
@@ -655,13 +806,15 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           //Write the value
           if ( status == SUCCESS )
           {
-            uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR2_LEN; i++)
+            // The message may come in fragments, reassembled in place
+            uint8 rxStatus = SimpleGattProfile_writeMsg( connHandle, pAttr, pValue, len,
+                                                         SIMPLEGATTPROFILE_CHAR2_LEN,
+                                                         SIMPLEGATTPROFILE_CHAR2 );
+            if ( rxStatus == FRAG_RX_ERROR )
             {
-                pCurValue[i] = pValue[i];
+              status = ATT_ERR_INVALID_VALUE_SIZE;
             }
-//            *pCurValue = pValue[0];
-            if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char2 )
+            else if( rxStatus == FRAG_RX_DONE && pAttr->pValue == (uint8_t *)simpleGattProfile_Char2 )
             {
               notifyApp = SIMPLEGATTPROFILE_CHAR2;
             }
@@ -689,14 +842,15 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           //Write the value
           if ( status == SUCCESS )
           {
-            uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR3_LEN; i++)
+            // The message may come in fragments, reassembled in place
+            uint8 rxStatus = SimpleGattProfile_writeMsg( connHandle, pAttr, pValue, len,
+                                                         SIMPLEGATTPROFILE_CHAR3_LEN,
+                                                         SIMPLEGATTPROFILE_CHAR3 );
+            if ( rxStatus == FRAG_RX_ERROR )
             {
-                pCurValue[i] = pValue[i];
+              status = ATT_ERR_INVALID_VALUE_SIZE;
             }
-//            *pCurValue = pValue[0];
-
-            if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char3 )
+            else if( rxStatus == FRAG_RX_DONE && pAttr->pValue == (uint8_t *)simpleGattProfile_Char3 )
             {
               notifyApp = SIMPLEGATTPROFILE_CHAR3;
             }
@@ -728,13 +882,15 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           //Write the value
           if ( status == SUCCESS )
           {
-            uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR4_LEN; i++)
+            // The message may come in fragments, reassembled in place
+            uint8 rxStatus = SimpleGattProfile_writeMsg( connHandle, pAttr, pValue, len,
+                                                         SIMPLEGATTPROFILE_CHAR4_LEN,
+                                                         SIMPLEGATTPROFILE_CHAR4 );
+            if ( rxStatus == FRAG_RX_ERROR )
             {
-                pCurValue[i] = pValue[i];
+              status = ATT_ERR_INVALID_VALUE_SIZE;
             }
-//            *pCurValue = pValue[0];
-            if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char4 )
+            else if( rxStatus == FRAG_RX_DONE && pAttr->pValue == (uint8_t *)simpleGattProfile_Char4 )
             {
               notifyApp = SIMPLEGATTPROFILE_CHAR4;
             }
@@ -762,13 +918,15 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           //Write the value
           if ( status == SUCCESS )
           {
-            uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR5_LEN; i++)
+            // The message may come in fragments, reassembled in place
+            uint8 rxStatus = SimpleGattProfile_writeMsg( connHandle, pAttr, pValue, len,
+                                                         SIMPLEGATTPROFILE_CHAR5_LEN,
+                                                         SIMPLEGATTPROFILE_CHAR5 );
+            if ( rxStatus == FRAG_RX_ERROR )
             {
-                pCurValue[i] = pValue[i];
+              status = ATT_ERR_INVALID_VALUE_SIZE;
             }
-//            *pCurValue = pValue[0];
-            if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char5 )
+            else if( rxStatus == FRAG_RX_DONE && pAttr->pValue == (uint8_t *)simpleGattProfile_Char5 )
             {
               notifyApp = SIMPLEGATTPROFILE_CHAR5;
             }
@@ -796,13 +954,15 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
           //Write the value
           if ( status == SUCCESS )
           {
-            uint8 *pCurValue = (uint8 *)pAttr->pValue;
-            for (int i = 0; i < SIMPLEGATTPROFILE_CHAR6_LEN; i++)
+            // The message may come in fragments, reassembled in place
+            uint8 rxStatus = SimpleGattProfile_writeMsg( connHandle, pAttr, pValue, len,
+                                                         SIMPLEGATTPROFILE_CHAR6_LEN,
+                                                         SIMPLEGATTPROFILE_CHAR6 );
+            if ( rxStatus == FRAG_RX_ERROR )
             {
-                pCurValue[i] = pValue[i];
+              status = ATT_ERR_INVALID_VALUE_SIZE;
             }
-//            *pCurValue = pValue[0];
-            if( pAttr->pValue == (uint8_t *)simpleGattProfile_Char6 )
+            else if( rxStatus == FRAG_RX_DONE && pAttr->pValue == (uint8_t *)simpleGattProfile_Char6 )
             {
               notifyApp = SIMPLEGATTPROFILE_CHAR6;
             }
@@ -832,13 +992,51 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
   // If a characteristic value changed then callback function to notify application of change
   if ((notifyApp != 0xFF ) && simpleGattProfile_appCBs && simpleGattProfile_appCBs->pfnSimpleGattProfile_Change)
   {
-      SimpleGattProfile_callback( notifyApp );
+      SimpleGattProfile_callback( connHandle, notifyApp );
   }
 
   // Return status value
   return ( status );
 }
 
+/*********************************************************************
+ * @fn      SimpleGattProfile_writeMsg
+ *
+ * @brief   Store a written message in the characteristic value. The
+ *          fragments of a message are reassembled in place. The length
+ *          of a complete message is recorded for
+ *          SimpleGattProfile_getValue.
+ *
+ * @param   connHandle - connection message was received on
+ * @param   pAttr - pointer to attribute
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   maxLen - size of the characteristic value
+ * @param   param - Profile parameter ID of the characteristic
+ *
+ * @return  FRAG_RX_DONE, FRAG_RX_PENDING or FRAG_RX_ERROR
+ */
+static uint8 SimpleGattProfile_writeMsg( uint16_t connHandle, gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t len, uint16_t maxLen,
+                                         uint8 param )
+{
+  uint8 *pCurValue = (uint8 *)pAttr->pValue;
+  uint8 *pMsg = pValue;
+  uint8 rxStatus = Frag_receive( connHandle, &pMsg, &len, pCurValue, maxLen );
+
+  // Not fragmented, the message is still in the PDU
+  if ( rxStatus == FRAG_RX_DONE && pMsg != pCurValue )
+  {
+    VOID memcpy( pCurValue, pMsg, len );
+  }
+  if ( rxStatus == FRAG_RX_DONE )
+  {
+    simpleGattProfile_CharLen[param] = len;
+  }
+
+  return ( rxStatus );
+}
+
 /*********************************************************************
  * @fn      SimpleGattProfile_callback
  *
@@ -846,13 +1044,14 @@ bStatus_t SimpleGattProfile_writeAttrCB( uint16_t connHandle,
  *          context.
  *          Calling the application callback
  *
- * @param   pData - data
+ * @param   connHandle - connection the value was written on
+ * @param   paramID - Profile parameter ID of the characteristic
  *
  * @return  None
  */
-void SimpleGattProfile_callback( uint8 paramID )
+void SimpleGattProfile_callback( uint16 connHandle, uint8 paramID )
 {
-  char *pData = ICall_malloc(sizeof(char));
+  char *pData = MemStats_malloc(3);
 
   if(pData == NULL)
   {
@@ -860,6 +1059,8 @@ void SimpleGattProfile_callback( uint8 paramID )
   }
 
   pData[0] = paramID;
+  pData[1] = LO_UINT16(connHandle);
+  pData[2] = HI_UINT16(connHandle);
 
   BLEAppUtil_invokeFunction(SimpleGattProfile_invokeFromFWContext, pData);
 }
@@ -877,7 +1078,7 @@ void SimpleGattProfile_callback( uint8 paramID )
  */
 void SimpleGattProfile_invokeFromFWContext( char *pData )
 {
-  simpleGattProfile_appCBs->pfnSimpleGattProfile_Change(pData[0]);
+  simpleGattProfile_appCBs->pfnSimpleGattProfile_Change(BUILD_UINT16(pData[1], pData[2]), pData[0]);
 }
 
 /*********************************************************************
@@ -0,0 +1,550 @@
+/******************************************************************************
+
+@file  app_cert_chain.c
+
+@brief This file contains the streaming verification of certificate
+       chains
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+
+#include <ti/drivers/ECDSA.h>
+
+#if APP_CERT_CHAIN
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Peer characteristic the central writes the requests and acknowledgements
+// to (Characteristic 3)
+#define CERT_CHAIN_WRITE_HANDLE     43
+// Handle the peripheral notifies the certificates on (Characteristic 4)
+#define CERT_CHAIN_NOTI_HANDLE      46
+
+#define CERT_CHAIN_INDEX_MASK       0x7F
+
+// Chain state of a link
+#define CERT_CHAIN_IDLE             0
+#define CERT_CHAIN_RECEIVING        1   // Central, waiting for the next certificate
+#define CERT_CHAIN_SENDING          2   // Peripheral, sending its chain
+#define CERT_CHAIN_DONE             3
+#define CERT_CHAIN_FAILED           4
+
+// certChainPathLen before the issuer path of the device is built
+#define CERT_CHAIN_PATH_UNKNOWN     0xFF
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Chain transfer of a link
+typedef struct
+{
+    uint16_t connHandle;
+    uint8_t  state;
+    uint8_t  next;          // Index of the next certificate, received or sent
+    uint8_t  acked;         // Certificates acknowledged by the central
+    uint8_t  count;         // Certificates of the local chain
+    // Key of the last verified certificate: the issuer of the next one,
+    // the peer device key once the chain is verified
+    uint8_t  issuerKey[CERT_PUBLIC_KEY_LEN];
+}CertChain_conn_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static CertChain_conn_t *CertChain_getConn(uint16_t connHandle);
+static void CertChain_buildPath(void);
+static const uint8_t *CertChain_getLocal(CertChain_conn_t *pConn, uint8_t index);
+static void CertChain_sendWindow(CertChain_conn_t *pConn);
+static void CertChain_reply(CertChain_conn_t *pConn, uint8_t id, uint8_t index);
+static void CertChain_fail(CertChain_conn_t *pConn, uint8_t index, int_fast16_t status);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Indexed by the connection context slot of the connection module
+static CertChain_conn_t certChainConns[MAX_NUM_BLE_CONNS];
+static CertChain_doneCB_t certChainDoneCB = NULL;
+// Issuer path of the local device certificate: indices of the signers of
+// the certificate store, root first. The store does not change at run
+// time, the path is built once.
+static uint8_t certChainPath[CERT_CHAIN_MAX_DEPTH - 1];
+static uint8_t certChainPathLen = CERT_CHAIN_PATH_UNKNOWN;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CertChain_init
+ *
+ * @brief   Register the callback of the verified chains.
+ *
+ * @param   doneCB - called when a chain is verified or rejected, may be NULL
+ *
+ * @return  none
+ */
+void CertChain_init(CertChain_doneCB_t doneCB)
+{
+    certChainDoneCB = doneCB;
+}
+
+/*********************************************************************
+ * @fn      CertChain_reset
+ *
+ * @brief   Clear the chain state, called for every new link.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_reset(uint16_t connHandle)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+
+    if (pConn != NULL)
+    {
+        memset(pConn, 0, sizeof(CertChain_conn_t));
+        pConn->connHandle = connHandle;
+    }
+}
+
+/*********************************************************************
+ * @fn      CertChain_request
+ *
+ * @brief   Ask the peripheral for its certificate chain. The
+ *          certificates are verified one by one as they arrive.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_request(uint16_t connHandle)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+
+    if (pConn == NULL)
+    {
+        return;
+    }
+
+    CertChain_reset(connHandle);
+    pConn->state = CERT_CHAIN_RECEIVING;
+    CertChain_reply(pConn, CERT_CHAIN_REQ_ID, 0);
+}
+
+/*********************************************************************
+ * @fn      CertChain_processRequest
+ *
+ * @brief   Start sending the local chain: the issuers of the device
+ *          certificate found in the certificate store, root first,
+ *          then the device certificate. CERT_CHAIN_WINDOW certificates
+ *          are sent ahead, the others as the acknowledgements come.
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processRequest(uint16_t connHandle, const uint8_t *pMsg, uint16_t len)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+
+    if (pConn == NULL || len < 1 || pMsg[0] != CERT_CHAIN_REQ_ID)
+    {
+        return;
+    }
+
+    if (certChainPathLen == CERT_CHAIN_PATH_UNKNOWN)
+    {
+        CertChain_buildPath();
+    }
+
+    CertChain_reset(connHandle);
+    pConn->count = certChainPathLen + 1;
+    pConn->state = CERT_CHAIN_SENDING;
+    CertChain_sendWindow(pConn);
+}
+
+/*********************************************************************
+ * @fn      CertChain_processLink
+ *
+ * @brief   Verify a certificate of the peer chain as soon as it
+ *          arrives: the root against the signers of the certificate
+ *          store, every other certificate against the key of the one
+ *          before it. Only the device certificate ends the chain. The
+ *          first failure aborts the transfer.
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processLink(uint16_t connHandle, const uint8_t *pMsg, uint16_t len)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+    const CertView_t *pCert;
+    uint8_t index;
+    uint8_t last;
+    int_fast16_t status;
+
+    // Certificates already in flight when the chain was aborted are dropped
+    if (pConn == NULL || pConn->state != CERT_CHAIN_RECEIVING)
+    {
+        return;
+    }
+
+    if (len < CERT_CHAIN_LINK_LEN)
+    {
+        CertChain_fail(pConn, pConn->next, ECDSA_STATUS_ERROR);
+        return;
+    }
+
+    index = pMsg[1] & CERT_CHAIN_INDEX_MASK;
+    last = (pMsg[1] & CERT_CHAIN_LAST) != 0;
+    pCert = CertView_parse(&pMsg[2], len - 2);
+
+    if (index != pConn->next || index >= CERT_CHAIN_MAX_DEPTH ||
+        last != (pCert->id == CERT_STORE_DEVICE))
+    {
+        CertChain_fail(pConn, index, ECDSA_STATUS_ERROR);
+        return;
+    }
+
+    if (index == 0)
+    {
+        status = CertStore_verifySigned(pCert);
+    }
+    else
+    {
+        status = CertStore_verifyCert(pCert, pConn->issuerKey);
+    }
+
+    if (status != ECDSA_STATUS_SUCCESS)
+    {
+        CertChain_fail(pConn, index, status);
+        return;
+    }
+
+    // The certificate is not kept, only its key for the next one
+    memcpy(pConn->issuerKey, pCert->publicKey, sizeof(pCert->publicKey));
+    pConn->next++;
+    CertChain_reply(pConn, CERT_CHAIN_ACK_ID, index);
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "chain certificate %d verify status = %d",
+                      index, status);
+
+    if (last)
+    {
+        pConn->state = CERT_CHAIN_DONE;
+        if (certChainDoneCB != NULL)
+        {
+            certChainDoneCB(connHandle, ECDSA_STATUS_SUCCESS);
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      CertChain_processAck
+ *
+ * @brief   Send the next certificate of the window when the central
+ *          acknowledges one, stop sending when it aborts.
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processAck(uint16_t connHandle, const uint8_t *pMsg, uint16_t len)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+
+    if (pConn == NULL || pConn->state != CERT_CHAIN_SENDING || len < 2)
+    {
+        return;
+    }
+
+    if (pMsg[0] == CERT_CHAIN_ABORT_ID)
+    {
+        pConn->state = CERT_CHAIN_FAILED;
+        MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "certificate chain aborted by the peer at %d",
+                          pMsg[1]);
+        return;
+    }
+
+    if (pMsg[0] != CERT_CHAIN_ACK_ID || pMsg[1] != pConn->acked)
+    {
+        return;
+    }
+
+    pConn->acked++;
+    if (pConn->acked == pConn->count)
+    {
+        pConn->state = CERT_CHAIN_DONE;
+        return;
+    }
+
+    CertChain_sendWindow(pConn);
+}
+
+/*********************************************************************
+ * @fn      CertChain_getDeviceKey
+ *
+ * @brief   Public key of the peer device certificate, once its chain
+ *          is verified
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes, or NULL while the chain is not
+ *          verified
+ */
+const uint8_t *CertChain_getDeviceKey(uint16_t connHandle)
+{
+    CertChain_conn_t *pConn = CertChain_getConn(connHandle);
+
+    if (pConn == NULL || pConn->state != CERT_CHAIN_DONE || pConn->next == 0)
+    {
+        return NULL;
+    }
+
+    return pConn->issuerKey;
+}
+
+/*********************************************************************
+ * @fn      CertChain_getConn
+ *
+ * @brief   Chain state of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the state, NULL for an unknown link
+ */
+static CertChain_conn_t *CertChain_getConn(uint16_t connHandle)
+{
+    uint16_t connIdx = Connection_getConnIndex(connHandle);
+
+    if (connIdx >= MAX_NUM_BLE_CONNS)
+    {
+        return NULL;
+    }
+
+    return &certChainConns[connIdx];
+}
+
+/*********************************************************************
+ * @fn      CertChain_buildPath
+ *
+ * @brief   Find the issuer path of the local device certificate. From
+ *          the device certificate up, the issuer of each certificate is
+ *          the signer of the store whose key verifies it. The path ends
+ *          at a self-signed root, at a certificate whose issuer is not
+ *          in the store, which the peer then has to hold, or at
+ *          CERT_CHAIN_MAX_DEPTH. Signers that issued none of them are
+ *          left out.
+ *
+ * @return  none
+ */
+static void CertChain_buildPath(void)
+{
+    const CertView_t *pCert = CertView_parse(CertStore_get(CERT_STORE_DEVICE), APP_CERT_LEN);
+    const CertView_t *pSigner;
+    uint8_t path[CERT_CHAIN_MAX_DEPTH - 1];
+    uint8_t len = 0;
+    uint8_t used;
+    uint8_t i;
+    uint8_t j;
+
+    while (pCert != NULL && len < CERT_CHAIN_MAX_DEPTH - 1 &&
+           CertStore_verifyCert(pCert, pCert->publicKey) != ECDSA_STATUS_SUCCESS)
+    {
+        for (i = 0; (pSigner = CertView_parse(CertStore_getAt(CERT_STORE_SIGNER, i), APP_CERT_LEN)) != NULL; i++)
+        {
+            // A signer already on the path would make a loop
+            for (used = FALSE, j = 0; j < len; j++)
+            {
+                used |= (path[j] == i);
+            }
+            if (!used && CertStore_verifyCert(pCert, pSigner->publicKey) == ECDSA_STATUS_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        if (pSigner == NULL)
+        {
+            break;
+        }
+        path[len++] = i;
+        pCert = pSigner;
+    }
+
+    // Root first
+    for (i = 0; i < len; i++)
+    {
+        certChainPath[i] = path[len - 1 - i];
+    }
+    certChainPathLen = len;
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "local certificate chain depth = %d", len + 1);
+}
+
+/*********************************************************************
+ * @fn      CertChain_getLocal
+ *
+ * @brief   Certificate of the local chain
+ *
+ * @param   pConn - chain state of the link
+ * @param   index - index in the chain, root first
+ *
+ * @return  APP_CERT_LEN bytes in flash
+ */
+static const uint8_t *CertChain_getLocal(CertChain_conn_t *pConn, uint8_t index)
+{
+    if (index == pConn->count - 1)
+    {
+        return CertStore_get(CERT_STORE_DEVICE);
+    }
+
+    return CertStore_getAt(CERT_STORE_SIGNER, certChainPath[index]);
+}
+
+/*********************************************************************
+ * @fn      CertChain_sendWindow
+ *
+ * @brief   Send the certificates of the chain up to CERT_CHAIN_WINDOW
+ *          ahead of the acknowledged ones
+ *
+ * @param   pConn - chain state of the link
+ *
+ * @return  none
+ */
+static void CertChain_sendWindow(CertChain_conn_t *pConn)
+{
+    uint8_t hdr[2];
+    bStatus_t status;
+
+    while (pConn->next < pConn->count && pConn->next < pConn->acked + CERT_CHAIN_WINDOW)
+    {
+        hdr[0] = CERT_CHAIN_LINK_ID;
+        hdr[1] = pConn->next;
+        if (pConn->next == pConn->count - 1)
+        {
+            hdr[1] |= CERT_CHAIN_LAST;
+        }
+
+        // The certificate goes from flash straight to the stack buffers
+        Frag_begin(pConn->connHandle, CERT_CHAIN_NOTI_HANDLE, ATT_HANDLE_VALUE_NOTI, CERT_CHAIN_LINK_LEN);
+        Frag_write(hdr, sizeof(hdr));
+        Frag_write(CertChain_getLocal(pConn, pConn->next), APP_CERT_LEN);
+        status = Frag_end();
+        if (status == bleMemAllocError && pConn->next != pConn->acked)
+        {
+            // The retry queue holds the previous certificate, the next
+            // acknowledgement sends this one
+            return;
+        }
+        if (status != SUCCESS)
+        {
+            pConn->state = CERT_CHAIN_FAILED;
+            MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "certificate chain not sent at %d",
+                              pConn->next);
+            return;
+        }
+        pConn->next++;
+    }
+}
+
+/*********************************************************************
+ * @fn      CertChain_reply
+ *
+ * @brief   Write a request, acknowledgement or abort to the peripheral
+ *
+ * @param   pConn - chain state of the link
+ * @param   id - CERT_CHAIN_REQ_ID, CERT_CHAIN_ACK_ID or CERT_CHAIN_ABORT_ID
+ * @param   index - certificate the message is about
+ *
+ * @return  none
+ */
+static void CertChain_reply(CertChain_conn_t *pConn, uint8_t id, uint8_t index)
+{
+    uint8_t msg[2];
+
+    msg[0] = id;
+    msg[1] = index;
+    if (Frag_send(pConn->connHandle, CERT_CHAIN_WRITE_HANDLE, ATT_WRITE_CMD, msg, sizeof(msg)) != SUCCESS &&
+        id != CERT_CHAIN_ABORT_ID)
+    {
+        CertChain_fail(pConn, index, ECDSA_STATUS_ERROR);
+    }
+}
+
+/*********************************************************************
+ * @fn      CertChain_fail
+ *
+ * @brief   Reject the peer chain and abort its transfer
+ *
+ * @param   pConn - chain state of the link
+ * @param   index - certificate that failed
+ * @param   status - verification status
+ *
+ * @return  none
+ */
+static void CertChain_fail(CertChain_conn_t *pConn, uint8_t index, int_fast16_t status)
+{
+    pConn->state = CERT_CHAIN_FAILED;
+    CertChain_reply(pConn, CERT_CHAIN_ABORT_ID, index);
+
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "chain certificate %d verify status = %d - aborted",
+                      index, status);
+
+    if (certChainDoneCB != NULL)
+    {
+        certChainDoneCB(pConn->connHandle, status);
+    }
+}
+
+#endif // APP_CERT_CHAIN
@@ -66,8 +66,8 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Pairing_ecckeyHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 
-static uint8_t Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr);
-static uint8_t Connection_removeConnInfo(uint16_t connHandle);
+static App_connCtx *Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr);
+static void Connection_removeConnInfo(uint16_t connHandle);
 
 //*****************************************************************************
 //! Globals
@@ -100,11 +100,19 @@ BLEAppUtil_EventHandler_t PairingecckeyHandler =
     .eventMask      = BLEAPPUTIL_GENERATE_ECC_DONE
 };
 
-// Holds the connection handles
-static App_connInfo connectionConnList[MAX_NUM_BLE_CONNS];
+// Connection contexts. A context keeps its slot while the link is up, so
+// the slot index also indexes the per-link tables of the other modules.
+static App_connCtx connectionCtxList[MAX_NUM_BLE_CONNS];
+// Slot of each connection handle, or CONNECTION_SLOT_INVALID
+static uint8_t connectionSlotMap[CONNECTION_HANDLE_MAP_SIZE];
+// Stack of the free slots
+static uint8_t connectionFreeSlots[MAX_NUM_BLE_CONNS];
+static uint8_t connectionNumFree = 0;
+// Slots of the active links, for the connected device list of the menu
+static uint8_t connectionActiveSlots[MAX_NUM_BLE_CONNS];
+static uint8_t connectionNumActive = 0;
 
 gapBondOOBData_t localOobData;
-gapBondOOBData_t remoteOobData;
 //*****************************************************************************
 //! Functions
 //*****************************************************************************
@@ -132,6 +140,21 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
             // Add the connection to the connected device list
             Connection_addConnInfo(gapEstMsg->connectionHandle, gapEstMsg->devAddr);
 
+            // Hold the certificate traffic until the link is configured
+            LinkReady_add(gapEstMsg->connectionHandle);
+#if APP_RADIO_STATS
+            RadioStats_add(gapEstMsg->connectionHandle);
+#endif
+
+            SimpleGatt_resetChallenge();
+
+#if APP_MUTUAL_AUTH
+            MutualAuth_reset(gapEstMsg->connectionHandle);
+#endif
+#if APP_CERT_CHAIN
+            CertChain_reset(gapEstMsg->connectionHandle);
+#endif
+
             /*! Print the peer address and connection handle number */
             MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Established - "
                               "Connected to " MENU_MODULE_COLOR_YELLOW "%s " MENU_MODULE_COLOR_RESET
@@ -144,15 +167,19 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                               linkDB_NumActive());
 
 //            HCI_LE_WriteSuggestedDefaultDataLenCmd(251, 2120);
-            HCI_LE_SetDataLenCmd(0, 251, 2120);
+            HCI_LE_SetDataLenCmd(gapEstMsg->connectionHandle, 251, 2120);
 
-            bStatus_t status = GAPBondMgr_SCGetLocalOOBParameters(&localOobData);
+            // With APP_OOB_IN_ADV_DATA the OOB data was generated before
+            // advertising and must stay valid for this link
+#if !APP_OOB_IN_ADV_DATA
+            bStatus_t status = CryptoProf_getLocalOob(&localOobData);
 
             uint8_t charValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
             memcpy(charValue1, localOobData.confirm, KEYLEN);
             memcpy(charValue1 + KEYLEN, localOobData.rand, KEYLEN);
             SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR1, SIMPLEGATTPROFILE_CHAR1_LEN,
                                           charValue1 );
+#endif
 //            doAttMtuExchange();
 
             break;
@@ -162,8 +189,13 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         {
             gapTerminateLinkEvent_t *gapTermMsg = (gapTerminateLinkEvent_t *)pMsgData;
 
+#if APP_RADIO_STATS
+            RadioStats_remove(gapTermMsg->connectionHandle);
+#endif
+            LinkReady_remove(gapTermMsg->connectionHandle);
             // Remove the connection from the conneted device list
             Connection_removeConnInfo(gapTermMsg->connectionHandle);
+            Frag_reset(gapTermMsg->connectionHandle);
 
             /*! Print the peer address and connection handle number */
             MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Terminated - "
@@ -211,6 +243,10 @@ void Connection_ConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                   MenuModule_printf(APP_MENU_CONN_EVENT, 0, "Conn status: Params update - "
                                     "connectionHandle = " MENU_MODULE_COLOR_YELLOW "%d " MENU_MODULE_COLOR_RESET,
                                     pPkt->connectionHandle);
+#if APP_RADIO_STATS
+                  // The event rate changed with the interval
+                  RadioStats_reset(pPkt->connectionHandle);
+#endif
               }
               else
               {
@@ -237,6 +273,10 @@ void Pairing_ecckeyHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     {
         case BLEAPPUTIL_GENERATE_ECC_DONE:
         {
+#if APP_OOB_IN_ADV_DATA
+            // The local OOB data can only be computed once the ECC keys exist
+            Peripheral_updateOobAdvData();
+#endif
 //            bStatus_t status;
 //
 //            status = GAPBondMgr_SCGetLocalOOBParameters(&localOobData);
@@ -309,6 +349,13 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
         {
             hciEvt_BLEPhyUpdateComplete_t *pPUC = (hciEvt_BLEPhyUpdateComplete_t*) pMsgData;
 
+            if (pPUC->BLEEventCode == HCI_BLE_DATA_LENGTH_CHANGE_EVENT)
+            {
+                hciEvt_BLEDataLengthChange_t *pDLC = (hciEvt_BLEDataLengthChange_t *)pMsgData;
+
+                LinkReady_setDataLen(pDLC->connHandle, pDLC->maxTxOctets, pDLC->maxRxOctets);
+            }
+
             if (pPUC->BLEEventCode == HCI_BLE_PHY_UPDATE_COMPLETE_EVENT)
             {
               if (pPUC->status != SUCCESS)
@@ -327,6 +374,9 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                                     pPUC->connHandle, currPhy);
 #endif // #if !defined(Display_DISABLE_ALL)
               }
+              LinkReady_setPhy(pPUC->connHandle, (pPUC->status != SUCCESS) ? 0 :
+                               (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_2M) ? HCI_PHY_2_MBPS :
+                               (pPUC->rxPhy == PHY_UPDATE_COMPLETE_EVENT_CODED) ? HCI_PHY_CODED : HCI_PHY_1_MBPS);
             }
 
             break;
@@ -343,89 +393,105 @@ void Connection_HciGAPEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 /*********************************************************************
  * @fn      Connection_addConnInfo
  *
- * @brief   Add a device to the connected device list
+ * @brief   Take a free slot for the context of a new connection
+ *
+ * @param   connHandle - connection handle
+ * @param   pAddr - peer address
  *
- * @return  index of the connected device list entry where the new connection
- *          info is put in.
- *          If there is no room, MAX_NUM_BLE_CONNS will be returned.
+ * @return  the new context, or NULL when there is no free slot or the
+ *          handle is out of the handle map
  */
-static uint8_t Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr)
+static App_connCtx *Connection_addConnInfo(uint16_t connHandle, uint8_t *pAddr)
 {
-  uint8_t i = 0;
+  App_connCtx *pCtx;
+  uint8_t slot;
 
-  for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE || connectionNumFree == 0 ||
+      connectionSlotMap[connHandle] != CONNECTION_SLOT_INVALID)
   {
-    if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID)
-    {
-      // Found available entry to put a new connection info in
-      connectionConnList[i].connHandle = connHandle;
-      memcpy(connectionConnList[i].peerAddress, pAddr, B_ADDR_LEN);
-
-      break;
-    }
+    return NULL;
   }
 
-  return i;
+  slot = connectionFreeSlots[--connectionNumFree];
+  pCtx = &connectionCtxList[slot];
+
+  memset(pCtx, 0, sizeof(App_connCtx));
+  pCtx->connHandle = connHandle;
+  memcpy(pCtx->peerAddress, pAddr, B_ADDR_LEN);
+
+  pCtx->activeIdx = connectionNumActive;
+  connectionActiveSlots[connectionNumActive++] = slot;
+  connectionSlotMap[connHandle] = slot;
+
+  return pCtx;
 }
 
 /*********************************************************************
  * @fn      Connection_removeConnInfo
  *
- * @brief   Remove a device from the connected device list
+ * @brief   Release the context slot of a connection. The last active
+ *          link takes the place of the removed one in the list.
+ *
+ * @param   connHandle - connection handle
  *
- * @return  index of the connected device list entry where the new connection
- *          info is removed from.
- *          If connHandle is not found, MAX_NUM_BLE_CONNS will be returned.
+ * @return  none
  */
-static uint8_t Connection_removeConnInfo(uint16_t connHandle)
+static void Connection_removeConnInfo(uint16_t connHandle)
 {
-  uint8_t i = 0;
-  uint8_t index = 0;
-  uint8_t maxNumConn = MAX_NUM_BLE_CONNS;
+  App_connCtx *pCtx = Connection_getCtx(connHandle);
+  uint8_t lastSlot;
 
-  for (i = 0; i < maxNumConn; i++)
+  if (pCtx == NULL)
   {
-    if (connectionConnList[i].connHandle == connHandle)
-    {
-      // Mark the entry as deleted
-      connectionConnList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
-
-      break;
-    }
+    return;
   }
 
-  // Save the index to return
-  index = i;
+  lastSlot = connectionActiveSlots[--connectionNumActive];
+  connectionActiveSlots[pCtx->activeIdx] = lastSlot;
+  connectionCtxList[lastSlot].activeIdx = pCtx->activeIdx;
+
+  connectionFreeSlots[connectionNumFree++] = connectionSlotMap[connHandle];
+  connectionSlotMap[connHandle] = CONNECTION_SLOT_INVALID;
+  pCtx->connHandle = LINKDB_CONNHANDLE_INVALID;
+}
 
-  // Shift the items in the array
-  for(i = 0; i < maxNumConn - 1; i++)
+/*********************************************************************
+ * @fn      Connection_getCtx
+ *
+ * @brief   Find the context of a connection
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  the connection context, or NULL if the link is unknown
+ */
+App_connCtx *Connection_getCtx(uint16_t connHandle)
+{
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE ||
+      connectionSlotMap[connHandle] == CONNECTION_SLOT_INVALID)
   {
-      if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID &&
-          connectionConnList[i + 1].connHandle == LINKDB_CONNHANDLE_INVALID)
-      {
-        break;
-      }
-      if (connectionConnList[i].connHandle == LINKDB_CONNHANDLE_INVALID &&
-          connectionConnList[i + 1].connHandle != LINKDB_CONNHANDLE_INVALID)
-      {
-        memmove(&connectionConnList[i], &connectionConnList[i+1], sizeof(App_connInfo));
-        connectionConnList[i + 1].connHandle = LINKDB_CONNHANDLE_INVALID;
-      }
+    return NULL;
   }
 
-  return index;
+  return &connectionCtxList[connectionSlotMap[connHandle]];
 }
 
 /*********************************************************************
- * @fn      Connection_getConnList
+ * @fn      Connection_getCtxByIndex
+ *
+ * @brief   Get the context of an entry of the connected device list
  *
- * @brief   Get the connection list
+ * @param   index - index in the connected device list
  *
- * @return  connection list
+ * @return  the connection context, or NULL past the last connection
  */
-App_connInfo *Connection_getConnList(void)
+App_connCtx *Connection_getCtxByIndex(uint8_t index)
 {
-  return connectionConnList;
+  if (index >= connectionNumActive)
+  {
+    return NULL;
+  }
+
+  return &connectionCtxList[connectionActiveSlots[index]];
 }
 
 /*********************************************************************
@@ -438,11 +504,12 @@ App_connInfo *Connection_getConnList(void)
  */
 uint16_t Connection_getConnhandle(uint8_t index)
 {
+  App_connCtx *pCtx = Connection_getCtxByIndex(index);
 
-    if (index < MAX_NUM_BLE_CONNS)
-    {
-      return connectionConnList[index].connHandle;
-    }
+  if (pCtx != NULL)
+  {
+    return pCtx->connHandle;
+  }
 
   return MAX_NUM_BLE_CONNS;
 }
@@ -462,11 +529,18 @@ bStatus_t Connection_start()
     bStatus_t status = SUCCESS;
     uint8 i;
 
-    // Initialize the connList handles
+    // All the slots are free
+    for (i = 0; i < CONNECTION_HANDLE_MAP_SIZE; i++)
+    {
+        connectionSlotMap[i] = CONNECTION_SLOT_INVALID;
+    }
     for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
     {
-        connectionConnList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        connectionCtxList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        connectionFreeSlots[i] = MAX_NUM_BLE_CONNS - 1 - i;
     }
+    connectionNumFree = MAX_NUM_BLE_CONNS;
+    connectionNumActive = 0;
 
     status = BLEAppUtil_registerEventHandler(&connectionConnHandler);
     if(status != SUCCESS)
@@ -487,6 +561,14 @@ bStatus_t Connection_start()
         return(status);
     }
 
+#if APP_RADIO_STATS
+    status = RadioStats_start(NULL);
+    if(status != SUCCESS)
+    {
+        return(status);
+    }
+#endif
+
 //    uint8_t oobEnabled = TRUE;
 //    GAPBondMgr_SetParameter(GAPBOND_OOB_ENABLED, sizeof(uint8_t), &oobEnabled);
 //
@@ -498,24 +580,21 @@ bStatus_t Connection_start()
 /*********************************************************************
  * @fn      Connection_getConnIndex
  *
- * @brief   Find index in the connected device list by connHandle
+ * @brief   Find the context slot of a connection. The slot does not
+ *          change while the link is up.
  *
- * @return  the index of the entry that has the given connection handle.
+ * @return  the slot of the given connection handle.
  *          if there is no match, LL_INACTIVE_CONNECTIONS will be returned.
  */
 uint16_t Connection_getConnIndex(uint16_t connHandle)
 {
-  uint8_t i;
-
-  for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+  if (connHandle >= CONNECTION_HANDLE_MAP_SIZE ||
+      connectionSlotMap[connHandle] == CONNECTION_SLOT_INVALID)
   {
-    if (connectionConnList[i].connHandle == connHandle)
-    {
-      return i;
-    }
+    return LL_INACTIVE_CONNECTIONS;
   }
 
-  return LL_INACTIVE_CONNECTIONS;
+  return connectionSlotMap[connHandle];
 }
 
 #endif // ( HOST_CONFIG & (CENTRAL_CFG | PERIPHERAL_CFG) )
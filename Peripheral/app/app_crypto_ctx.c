@@ -0,0 +1,302 @@
+/******************************************************************************
+
+@file  app_crypto_ctx.c
+
+@brief This file contains the shared certificate and signature verification context
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#ifdef CRYPTO_CTX_HOST
+#include <app_crypto_ctx.h>
+#include <app_crypto_prof.h>
+#else
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_main.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
+
+#include <ti/drivers/SHA2.h>
+#include <ti/drivers/ECDSA.h>
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define SHA2_INSTANCE   0
+#define ECDSA_INSTANCE  0
+
+// Uncompressed point prefix of a public key
+#define CRYPTO_CTX_POINT_PREFIX 0x04
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Scratch of a verification. The verifications all run in the BLEAppUtil
+// context one after the other, so one instance serves every call site
+// instead of a copy of the buffers and driver structs on each stack frame.
+typedef struct
+{
+    uint8_t publicKey[1 + CERT_PUBLIC_KEY_LEN]; // 0x04 || X || Y
+    uint8_t digest[CRYPTO_CTX_DIGEST_LEN];
+    CryptoKey key;
+    ECDSA_OperationVerify operation;
+}CryptoCtx_t;
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static CryptoCtx_t cryptoCtx;
+#ifndef CRYPTO_CTX_HOST
+// Owner of the ECDSA driver instance, a verification or a TA010 Sign
+static SemaphoreHandle_t ecdsaMutex = NULL;
+#endif
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      CryptoCtx_hash
+ *
+ * @brief   SHA256 of a buffer
+ *
+ * @param   pData - data to hash
+ * @param   len - length of the data
+ * @param   pDigest - CRYPTO_CTX_DIGEST_LEN bytes output
+ *
+ * @return  SHA2_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_hash(const uint8_t *pData, uint16_t len, uint8_t *pDigest)
+{
+    SHA2_Handle handle;
+    int_fast16_t result;
+#if APP_CRYPTO_PROF
+    uint32_t start;
+#endif
+
+    SHA2_init();
+    handle = SHA2_open(SHA2_INSTANCE, NULL);
+    if (handle == NULL)
+    {
+        return SHA2_STATUS_ERROR;
+    }
+
+#if APP_CRYPTO_PROF
+    start = CryptoProf_start();
+#endif
+    result = SHA2_hashData(handle, pData, len, pDigest);
+#if APP_CRYPTO_PROF
+    CryptoProf_stop(CRYPTO_PROF_SHA2_HASH, start);
+#endif
+    SHA2_close(handle);
+
+    return result;
+}
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyDigest
+ *
+ * @brief   ECDSA P-256 verification of a digest
+ *
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes public key X || Y
+ * @param   pDigest - CRYPTO_CTX_DIGEST_LEN bytes digest
+ * @param   pSignature - 64 bytes signature r || s
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyDigest(const uint8_t *pPublicKey, const uint8_t *pDigest,
+                                    const uint8_t *pSignature)
+{
+    ECDSA_Handle ecdsaHandle;
+    int_fast16_t result;
+#if APP_CRYPTO_PROF
+    uint32_t start;
+#endif
+
+    CryptoCtx_lockEcdsa();
+    ECDSA_init();
+    ecdsaHandle = ECDSA_open(ECDSA_INSTANCE, NULL);
+    if (ecdsaHandle == NULL)
+    {
+        CryptoCtx_unlockEcdsa();
+        return ECDSA_STATUS_ERROR;
+    }
+
+    cryptoCtx.publicKey[0] = CRYPTO_CTX_POINT_PREFIX;
+    memcpy(&cryptoCtx.publicKey[1], pPublicKey, CERT_PUBLIC_KEY_LEN);
+    CryptoKeyPlaintext_initKey(&cryptoCtx.key, cryptoCtx.publicKey, sizeof(cryptoCtx.publicKey));
+
+    ECDSA_OperationVerify_init(&cryptoCtx.operation);
+    cryptoCtx.operation.curve           = &ECCParams_NISTP256;
+    cryptoCtx.operation.theirPublicKey  = &cryptoCtx.key;
+    cryptoCtx.operation.hash            = pDigest;
+    cryptoCtx.operation.r               = pSignature;
+    cryptoCtx.operation.s               = pSignature + CRYPTO_CTX_DIGEST_LEN;
+
+#if APP_CRYPTO_PROF
+    start = CryptoProf_start();
+#endif
+    result = ECDSA_verify(ecdsaHandle, &cryptoCtx.operation);
+#if APP_CRYPTO_PROF
+    CryptoProf_stop(CRYPTO_PROF_ECDSA_VERIFY, start);
+#endif
+    ECDSA_close(ecdsaHandle);
+    CryptoCtx_unlockEcdsa();
+
+    return result;
+}
+
+/*********************************************************************
+ * @fn      CryptoCtx_lockEcdsa
+ *
+ * @brief   Wait until the ECDSA driver is free and hold it. The TA010
+ *          Sign task opens the same driver instance, a verification
+ *          waits for its Sign instead of failing to open the driver.
+ *
+ * @return  none
+ */
+void CryptoCtx_lockEcdsa(void)
+{
+#ifndef CRYPTO_CTX_HOST
+    if (ecdsaMutex == NULL)
+    {
+        // The first two users must not both create it
+        vTaskSuspendAll();
+        if (ecdsaMutex == NULL)
+        {
+            ecdsaMutex = xSemaphoreCreateMutex();
+        }
+        xTaskResumeAll();
+    }
+    if (ecdsaMutex != NULL)
+    {
+        xSemaphoreTake(ecdsaMutex, portMAX_DELAY);
+    }
+#endif
+}
+
+/*********************************************************************
+ * @fn      CryptoCtx_unlockEcdsa
+ *
+ * @brief   Release the ECDSA driver held with CryptoCtx_lockEcdsa
+ *
+ * @return  none
+ */
+void CryptoCtx_unlockEcdsa(void)
+{
+#ifndef CRYPTO_CTX_HOST
+    if (ecdsaMutex != NULL)
+    {
+        xSemaphoreGive(ecdsaMutex);
+    }
+#endif
+}
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyData
+ *
+ * @brief   ECDSA P-256 verification of the SHA256 of a buffer
+ *
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes public key X || Y
+ * @param   pData - signed data
+ * @param   len - length of the data
+ * @param   pSignature - 64 bytes signature r || s
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyData(const uint8_t *pPublicKey, const uint8_t *pData, uint16_t len,
+                                  const uint8_t *pSignature)
+{
+    if (CryptoCtx_hash(pData, len, cryptoCtx.digest) != SHA2_STATUS_SUCCESS)
+    {
+        return ECDSA_STATUS_ERROR;
+    }
+
+    return CryptoCtx_verifyDigest(pPublicKey, cryptoCtx.digest, pSignature);
+}
+
+/*********************************************************************
+ * @fn      CertView_parse
+ *
+ * @brief   View of the certificate at the start of a received buffer,
+ *          nothing is copied
+ *
+ * @param   pBuf - received buffer
+ * @param   len - length of the buffer
+ *
+ * @return  view over pBuf, or NULL when the buffer is shorter than a
+ *          certificate
+ */
+const CertView_t *CertView_parse(const uint8_t *pBuf, uint16_t len)
+{
+    if (pBuf == NULL || len < sizeof(CertView_t))
+    {
+        return NULL;
+    }
+
+    return (const CertView_t *)pBuf;
+}
+
+/*********************************************************************
+ * @fn      CryptoCtx_verifyCert
+ *
+ * @brief   Verify the signature of a certificate over its public key,
+ *          hashed and verified in place
+ *
+ * @param   pCert - certificate
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes key of the signer
+ *
+ * @return  ECDSA_STATUS_SUCCESS or the driver error
+ */
+int_fast16_t CryptoCtx_verifyCert(const CertView_t *pCert, const uint8_t *pPublicKey)
+{
+    if (pCert == NULL)
+    {
+        return ECDSA_STATUS_ERROR;
+    }
+
+    // r and s are contiguous in the view, the driver reads them in place
+    return CryptoCtx_verifyData(pPublicKey, pCert->publicKey, sizeof(pCert->publicKey), pCert->r);
+}
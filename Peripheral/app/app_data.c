@@ -51,6 +51,7 @@ Target Device: cc23xx
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
+#include <app_nonce_pool.h>
 #include <ti/bleapp/profiles/simple_gatt/simple_gatt_profile.h>
 
 #include <ti/drivers/SHA2.h>
@@ -69,10 +70,10 @@ Target Device: cc23xx
 //*****************************************************************************
 //! Globals
 //*****************************************************************************
-gapBondOOBData_t remoteOobData;
-
 static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 static void Challenge_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+static void Data_linkReadyCB(uint16_t connHandle);
+static void Data_setRemoteOob(App_connCtx *pCtx, uint8_t *pValue);
 // Events handlers struct, contains the handlers and event masks
 // of the application data module
 BLEAppUtil_EventHandler_t dataGATTHandler =
@@ -82,6 +83,7 @@ BLEAppUtil_EventHandler_t dataGATTHandler =
     .eventMask      = BLEAPPUTIL_ATT_FLOW_CTRL_VIOLATED_EVENT |
                       BLEAPPUTIL_ATT_MTU_UPDATED_EVENT |
                       BLEAPPUTIL_ATT_READ_RSP |
+                      BLEAPPUTIL_ATT_READ_BLOB_RSP |
                       BLEAPPUTIL_ATT_WRITE_CMD |
                       BLEAPPUTIL_ATT_WRITE_REQ |
                       BLEAPPUTIL_ATT_WRITE_RSP |
@@ -116,6 +118,7 @@ BLEAppUtil_EventHandler_t challengeHandler =
 static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 {
   gattMsgEvent_t *gattMsg = ( gattMsgEvent_t * )pMsgData;
+  App_connCtx *pCtx = Connection_getCtx(gattMsg->connHandle);
   switch ( gattMsg->method )
   {
     case ATT_FLOW_CTRL_VIOLATED_EVENT:
@@ -128,29 +131,16 @@ static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
       {
 //          MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE1, 0, "GATT status: ATT MTU update to %d",
 //                            gattMsg->msg.mtuEvt.MTU);
-          doAttReadReq(37, 1);
+          // The transfers start from Data_linkReadyCB
+          LinkReady_setMtu(gattMsg->connHandle, gattMsg->msg.mtuEvt.MTU);
       }
       break;
 
     case ATT_READ_RSP:
       {
-          if (gattMsg->msg.readRsp.len == 32)
+          if (pCtx != NULL && gattMsg->msg.readRsp.len == SIMPLEGATTPROFILE_CHAR1_LEN)
           {
-              MenuModule_printf(APP_MENU_CONN_EVENT, 0, "OOB data = 0x%02x 0x%02x 0x%02x 0x%02x 0x%02x ",
-                                gattMsg->msg.readRsp.pValue[0], gattMsg->msg.readRsp.pValue[1], gattMsg->msg.readRsp.pValue[2],
-                                gattMsg->msg.readRsp.pValue[3], gattMsg->msg.readRsp.pValue[4]);
-
-              uint8_t oobEnabled = TRUE;
-              GAPBondMgr_SetParameter(GAPBOND_OOB_ENABLED, sizeof(uint8_t), &oobEnabled);
-
-              for (int i = 0; i < 16; i++) {
-                  remoteOobData.confirm[i] = gattMsg->msg.readRsp.pValue[i];
-              }
-
-              for (int i = 0; i < 16; i++) {
-                  remoteOobData.rand[i] = gattMsg->msg.readRsp.pValue[i + 16];
-              }
-              GAPBondMgr_SCSetRemoteOOBParameters(&remoteOobData, 1);
+              Data_setRemoteOob(pCtx, gattMsg->msg.readRsp.pValue);
           }
       }
           break;
@@ -162,6 +152,27 @@ static void GATT_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
 
         break;
 
+    case ATT_READ_BLOB_RSP:
+      {
+          if (pCtx == NULL)
+          {
+              break;
+          }
+          if (gattMsg->hdr.status == bleProcedureComplete)
+          {
+              if (pCtx->remoteOobLen == SIMPLEGATTPROFILE_CHAR1_LEN)
+              {
+                  Data_setRemoteOob(pCtx, pCtx->remoteOobValue);
+              }
+          }
+          else if (pCtx->remoteOobLen + gattMsg->msg.readBlobRsp.len <= SIMPLEGATTPROFILE_CHAR1_LEN)
+          {
+              memcpy(&pCtx->remoteOobValue[pCtx->remoteOobLen], gattMsg->msg.readBlobRsp.pValue, gattMsg->msg.readBlobRsp.len);
+              pCtx->remoteOobLen += gattMsg->msg.readBlobRsp.len;
+          }
+      }
+      break;
+
     case ATT_EXCHANGE_MTU_RSP:
       {
           MenuModule_printf(APP_MENU_PAIRING_EVENT, 0, "MTU max size client = %d MTU max size server = %d",
@@ -205,15 +216,15 @@ static void Challenge_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                      *  Send sign command + gattMsg->msg.handleValueNoti.pValue[1] ~ gattMsg->msg.handleValueNoti.pValue[32] to TA010
                      */
 
-                    // set signature to char 6
-                    uint8_t ta010Signature[64] = {0x60, 0x1E, 0xAF, 0xC6, 0x69, 0xEF, 0x3C, 0xFE, 0x96, 0x49, 0x3A, 0xAC, 0xD0, 0x45, 0xBF, // signature r
+                    // set signature to char 6, a test vector padded to the characteristic length
+                    static const uint8_t ta010Signature[SIMPLEGATTPROFILE_CHAR6_LEN] = {0x60, 0x1E, 0xAF, 0xC6, 0x69, 0xEF, 0x3C, 0xFE, 0x96, 0x49, 0x3A, 0xAC, 0xD0, 0x45, 0xBF, // signature r
                                                   0x74, 0xF8, 0x1B, 0xD6, 0xCE, 0x34, 0x65, 0x8F, 0x79, 0x34, 0x59, 0x3F, 0x74, 0xF2, 0x0C,
                                                   0xA8, 0x3F,
                                                   0xAF, 0x00, 0xFA, 0x71, 0x3B, 0x53, 0xDC, 0x40, 0x25, 0x39, 0x6D, 0xE8, 0xAC, 0x0D, 0x41, // signature s
                                                   0xA2, 0x7C, 0x38, 0x06, 0xCA, 0x7E, 0x04, 0x34, 0x40, 0x3C, 0xAD, 0x8F, 0x48, 0x30, 0xA1,
                                                   0xA9, 0xA7};
                     bStatus_t status = SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR6, SIMPLEGATTPROFILE_CHAR6_LEN,
-                                                                       ta010Signature );
+                                                                       (void *)ta010Signature );
                     if (status == SUCCESS)
                     {
                         MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE4, 0 ,"64 bytes signature set status = %d", status);
@@ -227,6 +238,61 @@ static void Challenge_EventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     }
 }
 
+/*********************************************************************
+ * @fn      Data_setRemoteOob
+ *
+ * @brief   Enable OOB pairing with the confirm and random values read
+ *          from Characteristic 1 of the peer
+ *
+ * @param   pCtx - connection context
+ * @param   pValue - SIMPLEGATTPROFILE_CHAR1_LEN bytes, confirm then random
+ *
+ * @return  none
+ */
+static void Data_setRemoteOob(App_connCtx *pCtx, uint8_t *pValue)
+{
+    MenuModule_printf(APP_MENU_CONN_EVENT, 0, "OOB data = 0x%02x 0x%02x 0x%02x 0x%02x 0x%02x ",
+                      pValue[0], pValue[1], pValue[2], pValue[3], pValue[4]);
+
+    uint8_t oobEnabled = TRUE;
+    GAPBondMgr_SetParameter(GAPBOND_OOB_ENABLED, sizeof(uint8_t), &oobEnabled);
+
+    memcpy(pCtx->remoteOob.confirm, pValue, KEYLEN);
+    memcpy(pCtx->remoteOob.rand, &pValue[KEYLEN], KEYLEN);
+    GAPBondMgr_SCSetRemoteOOBParameters(&pCtx->remoteOob, 1);
+}
+
+/*********************************************************************
+ * @fn      Data_linkReadyCB
+ *
+ * @brief   Called once the MTU and data length of the link are
+ *          negotiated, or the negotiation timed out. Starts the
+ *          OOB and certificate traffic.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+static void Data_linkReadyCB(uint16_t connHandle)
+{
+    App_connCtx *pCtx = Connection_getCtx(connHandle);
+
+    // The OOB data does not fit in one Read Response at small ATT_MTU
+    if (pCtx != NULL && LinkReady_getMtu(connHandle) - 1 < SIMPLEGATTPROFILE_CHAR1_LEN)
+    {
+        pCtx->remoteOobLen = 0;
+        doAttReadLongReq(37, 1);
+    }
+    else
+    {
+        doAttReadReq(37, 1);
+    }
+#if APP_MUTUAL_AUTH
+    // Send our HELLO right away, in parallel with the central one
+    MutualAuth_start(connHandle, MUTUAL_AUTH_ROLE_PERIPHERAL);
+#endif
+}
+
 //xTaskCreate(VerifySignatureTask, "VerifySignature", 1024, NULL, 1, NULL);
 //xTaskCreate(ResponseChallengeSuccessTask, "ChallengeResult", 128, NULL, 2, NULL);
 /*********************************************************************
@@ -243,6 +309,13 @@ bStatus_t Data_start( void )
 {
   bStatus_t status = SUCCESS;
 
+  // Fill the nonce pool before the first challenge
+  NoncePool_init();
+
+  // Start the transfers of a link once it is configured
+  LinkReady_init(Data_linkReadyCB);
+  Frag_init();
+
   // Register the handlers
   status = BLEAppUtil_registerEventHandler( &dataGATTHandler );
   status = BLEAppUtil_registerEventHandler( &challengeHandler );
@@ -0,0 +1,808 @@
+/******************************************************************************
+
+@file  app_frag.c
+
+@brief This file contains the fragmentation layer of the handshake
+       messages, used when the ATT_MTU is too small to carry them
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <ti/bleapp/menu_module/menu_module.h>
+#include <app_main.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Fragment header: fragment mark, last fragment flag and sequence number.
+// Whole messages never start with the mark, so the receiver frames a PDU
+// by its first byte and not by its own view of the ATT_MTU.
+#define FRAG_MARK               0xE0
+#define FRAG_MARK_MASK          0xE0
+#define FRAG_LAST               BV(4)
+#define FRAG_SEQ_MASK           0x0F
+#define FRAG_SEQ_INVALID        0xFF
+
+// ATT opcode + attribute handle of a Write Command or a Notification
+#define FRAG_ATT_HDR_LEN        3
+
+// The largest message still fits in the sequence numbers at the default ATT_MTU
+_Static_assert(APP_FRAG_MSG_MAX_LEN <= (FRAG_SEQ_MASK + 1) * (ATT_MTU_SIZE - FRAG_ATT_HDR_LEN - APP_FRAG_HDR_LEN),
+               "fragment sequence number");
+
+// Room on each link for one whole message waiting for a free stack
+// buffer and for the short messages that go out right behind it: the
+// signer request and the challenge of Data_startAuthentication, or a
+// certificate chain acknowledgement. Their senders take bleMemAllocError
+// as a failed handshake. A second certificate that finds no room is
+// refused with it, the certificate chain then holds its window until the
+// next acknowledgement.
+#define FRAG_TX_SHORT_MSG_LEN   (1 + APP_NONCE_LEN)
+#define FRAG_TX_SHORT_MSGS      2
+#ifndef FRAG_TX_QUEUE_LEN
+#define FRAG_TX_QUEUE_LEN       (MAX_NUM_BLE_CONNS * (sizeof(Frag_txMsg_t) + APP_FRAG_MSG_MAX_LEN + \
+                                 FRAG_TX_SHORT_MSGS * (sizeof(Frag_txMsg_t) + FRAG_TX_SHORT_MSG_LEN)))
+#endif
+
+// Delay before sending the queued fragments again
+#define FRAG_RETRY_MS           5
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Queued message, followed by its len bytes in fragTxQueue
+typedef struct
+{
+    uint16_t connHandle;
+    uint16_t attHandle;
+    uint16_t len;
+    uint16_t offset;        // Bytes already sent
+    uint8_t  method;
+    uint8_t  seq;           // Sequence number of the next fragment
+}Frag_txMsg_t;
+
+typedef struct
+{
+    uint16_t connHandle;
+    uint16_t offset;        // Bytes of the message received so far
+    uint8_t  seq;           // Expected sequence number, FRAG_SEQ_INVALID between messages
+}Frag_rxState_t;
+
+// Message written with Frag_begin / Frag_write / Frag_end
+typedef struct
+{
+    Frag_txMsg_t tx;        // offset: bytes handed to the stack
+    uint16_t written;       // Bytes given by Frag_write
+    uint16_t payloadLen;
+    uint8_t  hdrLen;
+    uint8_t  *pPdu;         // Stack buffer of the fragment being written
+    uint8_t  *pQueued;      // Next byte in fragTxQueue, once the rest is queued
+    bStatus_t status;
+}Frag_builder_t;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static uint16_t Frag_getAttLen(uint16_t connHandle);
+static uint8_t Frag_getHdrLen(Frag_txMsg_t *pTx, uint16_t attLen, uint8_t first);
+static uint16_t Frag_getFragLen(Frag_txMsg_t *pTx, uint16_t payloadLen);
+static uint8_t *Frag_allocPdu(Frag_txMsg_t *pTx, uint8_t hdrLen, uint16_t fragLen);
+static bStatus_t Frag_sendPdu(Frag_txMsg_t *pTx, uint8_t *pPdu, uint16_t pduLen);
+static void Frag_freePdu(uint8_t method, uint8_t *pPdu);
+static bStatus_t Frag_transmit(Frag_txMsg_t *pTx, const uint8_t *pMsg);
+static void Frag_queueRest(void);
+static void Frag_timerCB(uintptr_t arg);
+static void Frag_retryCB(char *pData);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Queued messages are kept as Frag_txMsg_t + data, in sending order
+static uint8_t fragTxQueue[FRAG_TX_QUEUE_LEN];
+static uint16_t fragTxQueueLen = 0;
+static Frag_rxState_t fragRxList[MAX_NUM_BLE_CONNS];
+static ClockP_Struct fragRetryTimer;
+// Only one message is written at a time, from the BLEAppUtil context
+static Frag_builder_t fragBuilder = {.status = INVALIDPARAMETER};
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      Frag_init
+ *
+ * @brief   Clear the fragmentation layer
+ *
+ * @return  none
+ */
+void Frag_init(void)
+{
+    uint8_t i;
+    ClockP_Params clockParams;
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        fragRxList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+        fragRxList[i].seq = FRAG_SEQ_INVALID;
+    }
+    fragTxQueueLen = 0;
+
+    ClockP_Params_init(&clockParams);
+    ClockP_construct(&fragRetryTimer, Frag_timerCB,
+                     (FRAG_RETRY_MS * 1000) / ClockP_getSystemTickPeriod(),
+                     &clockParams);
+}
+
+/*********************************************************************
+ * @fn      Frag_reset
+ *
+ * @brief   Drop the queued and partly received messages of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Frag_reset(uint16_t connHandle)
+{
+    uint8_t i;
+    uint16_t pos = 0;
+    Frag_txMsg_t tx;
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if (fragRxList[i].connHandle == connHandle)
+        {
+            fragRxList[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+            fragRxList[i].seq = FRAG_SEQ_INVALID;
+        }
+    }
+
+    while (pos < fragTxQueueLen)
+    {
+        memcpy(&tx, &fragTxQueue[pos], sizeof(tx));
+        if (tx.connHandle == connHandle)
+        {
+            fragTxQueueLen -= sizeof(tx) + tx.len;
+            memmove(&fragTxQueue[pos], &fragTxQueue[pos + sizeof(tx) + tx.len], fragTxQueueLen - pos);
+        }
+        else
+        {
+            pos += sizeof(tx) + tx.len;
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      Frag_send
+ *
+ * @brief   Send a handshake message. When the ATT_MTU of the link cannot
+ *          carry the message, it is split in fragments
+ *          that are all handed to the stack at once, so they go out in
+ *          as few connection events as the controller allows. Fragments
+ *          that find no free stack buffer are queued and sent later.
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   pMsg - message
+ * @param   len - length of the message
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER or bleMemAllocError
+ */
+bStatus_t Frag_send(uint16_t connHandle, uint16_t attHandle, uint8_t method,
+                    const uint8_t *pMsg, uint16_t len)
+{
+    Frag_begin(connHandle, attHandle, method, len);
+    Frag_write(pMsg, len);
+
+    return Frag_end();
+}
+
+/*********************************************************************
+ * @fn      Frag_begin
+ *
+ * @brief   Start a message that is given in parts with Frag_write, so
+ *          the caller does not assemble it in a buffer of its own. The
+ *          parts are copied straight in the stack buffers of the
+ *          fragments, a fragment is handed to the stack as soon as it
+ *          is full. When the stack runs out of buffers, the rest of the
+ *          message goes to the retry queue instead.
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   len - length of the whole message
+ *
+ * @return  SUCCESS, INVALIDPARAMETER or bleMemAllocError. On error the
+ *          writes are ignored and Frag_end returns the same status.
+ */
+bStatus_t Frag_begin(uint16_t connHandle, uint16_t attHandle, uint8_t method, uint16_t len)
+{
+    Frag_builder_t *pB = &fragBuilder;
+    uint16_t attLen;
+
+    memset(pB, 0, sizeof(Frag_builder_t));
+    if (len == 0 || len > APP_FRAG_MSG_MAX_LEN)
+    {
+        pB->status = INVALIDPARAMETER;
+        return pB->status;
+    }
+
+    pB->tx.connHandle = connHandle;
+    pB->tx.attHandle = attHandle;
+    pB->tx.len = len;
+    pB->tx.method = method;
+    // The first byte is checked by the first Frag_write
+    attLen = Frag_getAttLen(connHandle);
+    pB->hdrLen = Frag_getHdrLen(&pB->tx, attLen, 0);
+    pB->payloadLen = attLen - pB->hdrLen;
+    pB->status = SUCCESS;
+
+    // Messages must not overtake the queued ones
+    if (fragTxQueueLen != 0)
+    {
+        Frag_queueRest();
+    }
+
+    return pB->status;
+}
+
+/*********************************************************************
+ * @fn      Frag_write
+ *
+ * @brief   Append a part to the message started by Frag_begin
+ *
+ * @param   pData - data, may be in flash
+ * @param   len - length of the data
+ *
+ * @return  none
+ */
+void Frag_write(const uint8_t *pData, uint16_t len)
+{
+    Frag_builder_t *pB = &fragBuilder;
+    bStatus_t status;
+    uint16_t fragLen;
+    uint16_t fill;
+    uint16_t n;
+
+    if (pB->status != SUCCESS)
+    {
+        return;
+    }
+    if (len > pB->tx.len - pB->written)
+    {
+        pB->status = INVALIDPARAMETER;
+        return;
+    }
+    if (pB->written == 0 && len > 0 && !pB->hdrLen &&
+        Frag_getHdrLen(&pB->tx, pB->payloadLen, pData[0]))
+    {
+        pB->hdrLen = APP_FRAG_HDR_LEN;
+        pB->payloadLen -= APP_FRAG_HDR_LEN;
+    }
+
+    while (len > 0)
+    {
+        if (pB->pQueued != NULL)
+        {
+            memcpy(pB->pQueued, pData, len);
+            pB->pQueued += len;
+            pB->written += len;
+            return;
+        }
+
+        fragLen = Frag_getFragLen(&pB->tx, pB->payloadLen);
+        if (pB->pPdu == NULL)
+        {
+            pB->pPdu = Frag_allocPdu(&pB->tx, pB->hdrLen, fragLen);
+            if (pB->pPdu == NULL)
+            {
+                Frag_queueRest();
+                if (pB->status != SUCCESS)
+                {
+                    return;
+                }
+                continue;
+            }
+        }
+
+        fill = pB->written - pB->tx.offset;
+        n = (len < fragLen - fill) ? len : fragLen - fill;
+        memcpy(&pB->pPdu[pB->hdrLen + fill], pData, n);
+        pB->written += n;
+        pData += n;
+        len -= n;
+
+        if (fill + n < fragLen)
+        {
+            continue;
+        }
+
+        status = Frag_sendPdu(&pB->tx, pB->pPdu, pB->hdrLen + fragLen);
+        if (status == MSG_BUFFER_NOT_AVAIL || status == blePending)
+        {
+            // The fragment is kept in the queue, its buffer is freed there
+            Frag_queueRest();
+            if (pB->status != SUCCESS)
+            {
+                return;
+            }
+            continue;
+        }
+        if (status != SUCCESS)
+        {
+            Frag_freePdu(pB->tx.method, pB->pPdu);
+            pB->pPdu = NULL;
+            pB->status = status;
+            return;
+        }
+
+        pB->pPdu = NULL;
+        pB->tx.offset += fragLen;
+        pB->tx.seq++;
+    }
+}
+
+/*********************************************************************
+ * @fn      Frag_end
+ *
+ * @brief   Finish the message started by Frag_begin
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER when the parts do
+ *          not add up to the length given to Frag_begin, bleMemAllocError
+ *          or the stack error that dropped the message
+ */
+bStatus_t Frag_end(void)
+{
+    Frag_builder_t *pB = &fragBuilder;
+    Frag_txMsg_t tx;
+    bStatus_t status;
+
+    if (pB->status == SUCCESS && pB->written != pB->tx.len)
+    {
+        pB->status = INVALIDPARAMETER;
+    }
+    if (pB->pPdu != NULL)
+    {
+        Frag_freePdu(pB->tx.method, pB->pPdu);
+        pB->pPdu = NULL;
+    }
+
+    // Commit the queued rest, the sequence number goes on
+    if (pB->status == SUCCESS && pB->pQueued != NULL)
+    {
+        tx = pB->tx;
+        tx.len -= tx.offset;
+        tx.offset = 0;
+        memcpy(&fragTxQueue[fragTxQueueLen], &tx, sizeof(tx));
+        fragTxQueueLen += sizeof(tx) + tx.len;
+
+        ClockP_start(ClockP_handle(&fragRetryTimer));
+    }
+
+    status = pB->status;
+    pB->status = INVALIDPARAMETER;
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      Frag_receive
+ *
+ * @brief   Place a received PDU in the message buffer. A PDU without
+ *          the fragment mark is the message and is not copied.
+ *          Otherwise the payload of each fragment is copied straight
+ *          after the previous one in pBuf, so the message is
+ *          reassembled in place whatever fragment size the peer chose.
+ *
+ * @param   connHandle - connection handle
+ * @param   ppMsg - in: PDU, out: complete message
+ * @param   pLen - in: length of the PDU, out: length of the message
+ * @param   pBuf - buffer the fragments are reassembled in
+ * @param   bufLen - size of pBuf
+ *
+ * @return  one of Frag_rxStatus
+ */
+uint8_t Frag_receive(uint16_t connHandle, uint8_t **ppMsg, uint16_t *pLen,
+                     uint8_t *pBuf, uint16_t bufLen)
+{
+    Frag_rxState_t *pRx = NULL;
+    uint16_t fragLen;
+    uint8_t hdr;
+    uint8_t i;
+
+    if (!Frag_isFragment(*ppMsg, *pLen))
+    {
+        return (*pLen <= bufLen) ? FRAG_RX_DONE : FRAG_RX_ERROR;
+    }
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if (fragRxList[i].connHandle == connHandle)
+        {
+            pRx = &fragRxList[i];
+            break;
+        }
+        if (pRx == NULL && fragRxList[i].connHandle == LINKDB_CONNHANDLE_INVALID)
+        {
+            pRx = &fragRxList[i];
+        }
+    }
+    if (pRx == NULL || pBuf == NULL)
+    {
+        return FRAG_RX_ERROR;
+    }
+    pRx->connHandle = connHandle;
+
+    hdr = (*ppMsg)[0];
+    fragLen = *pLen - APP_FRAG_HDR_LEN;
+
+    // A first fragment drops any message left incomplete
+    if ((hdr & FRAG_SEQ_MASK) == 0)
+    {
+        pRx->seq = 0;
+        pRx->offset = 0;
+    }
+
+    if ((hdr & FRAG_SEQ_MASK) != pRx->seq ||
+        pRx->offset + fragLen > bufLen)
+    {
+        pRx->seq = FRAG_SEQ_INVALID;
+        return FRAG_RX_ERROR;
+    }
+
+    memcpy(&pBuf[pRx->offset], &(*ppMsg)[APP_FRAG_HDR_LEN], fragLen);
+    pRx->offset += fragLen;
+
+    if (!(hdr & FRAG_LAST))
+    {
+        pRx->seq++;
+        return FRAG_RX_PENDING;
+    }
+
+    pRx->seq = FRAG_SEQ_INVALID;
+    *ppMsg = pBuf;
+    *pLen = pRx->offset;
+
+    return FRAG_RX_DONE;
+}
+
+/*********************************************************************
+ * @fn      Frag_isFragment
+ *
+ * @brief   Tell a fragment from a whole message by its first byte
+ *
+ * @param   pPdu - received PDU
+ * @param   len - length of the PDU
+ *
+ * @return  TRUE when the PDU carries a fragment header
+ */
+uint8_t Frag_isFragment(const uint8_t *pPdu, uint16_t len)
+{
+    return (len > APP_FRAG_HDR_LEN && (pPdu[0] & FRAG_MARK_MASK) == FRAG_MARK);
+}
+
+/*********************************************************************
+ * @fn      Frag_getAttLen
+ *
+ * @brief   Bytes of ATT value carried by one PDU of the link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  ATT_MTU - 3
+ */
+static uint16_t Frag_getAttLen(uint16_t connHandle)
+{
+    return LinkReady_getMtu(connHandle) - FRAG_ATT_HDR_LEN;
+}
+
+/*********************************************************************
+ * @fn      Frag_getHdrLen
+ *
+ * @brief   Framing of a message: whole when it fits in one PDU and
+ *          does not start like a fragment, fragments otherwise. The
+ *          rest of a message whose first fragments went out stays in
+ *          fragments.
+ *
+ * @param   pTx - message state
+ * @param   attLen - bytes of ATT value carried by one PDU
+ * @param   first - first byte of the message
+ *
+ * @return  APP_FRAG_HDR_LEN, or 0 when the message is sent whole
+ */
+static uint8_t Frag_getHdrLen(Frag_txMsg_t *pTx, uint16_t attLen, uint8_t first)
+{
+    return (pTx->seq != 0 || pTx->len > attLen ||
+            (first & FRAG_MARK_MASK) == FRAG_MARK) ? APP_FRAG_HDR_LEN : 0;
+}
+
+/*********************************************************************
+ * @fn      Frag_transmit
+ *
+ * @brief   Hand the PDUs of a message to the stack until it is sent or
+ *          the stack runs out of buffers
+ *
+ * @param   pTx - message state, offset and seq are updated
+ * @param   pMsg - message data
+ *
+ * @return  SUCCESS, blePending when the rest must be sent later, or
+ *          the stack error that dropped the message
+ */
+static bStatus_t Frag_transmit(Frag_txMsg_t *pTx, const uint8_t *pMsg)
+{
+    bStatus_t status = SUCCESS;
+    uint16_t attLen = Frag_getAttLen(pTx->connHandle);
+    uint8_t hdrLen = Frag_getHdrLen(pTx, attLen, pMsg[0]);
+    uint16_t payloadLen = attLen - hdrLen;
+    uint16_t fragLen;
+    uint8_t *pPdu;
+
+    while (pTx->offset < pTx->len)
+    {
+        fragLen = Frag_getFragLen(pTx, payloadLen);
+
+        // The fragment is built straight in the stack buffer
+        pPdu = Frag_allocPdu(pTx, hdrLen, fragLen);
+        if (pPdu == NULL)
+        {
+            return blePending;
+        }
+        memcpy(&pPdu[hdrLen], &pMsg[pTx->offset], fragLen);
+
+        status = Frag_sendPdu(pTx, pPdu, hdrLen + fragLen);
+        if (status != SUCCESS)
+        {
+            Frag_freePdu(pTx->method, pPdu);
+        }
+        if (status == MSG_BUFFER_NOT_AVAIL || status == blePending)
+        {
+            return blePending;
+        }
+        if (status != SUCCESS)
+        {
+            return status;
+        }
+
+        pTx->offset += fragLen;
+        pTx->seq++;
+    }
+
+    return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      Frag_getFragLen
+ *
+ * @brief   Message bytes of the next fragment
+ *
+ * @param   pTx - message state
+ * @param   payloadLen - message bytes carried by one PDU of the link
+ *
+ * @return  length of the next fragment, without its header
+ */
+static uint16_t Frag_getFragLen(Frag_txMsg_t *pTx, uint16_t payloadLen)
+{
+    uint16_t fragLen = pTx->len - pTx->offset;
+
+    return (fragLen > payloadLen) ? payloadLen : fragLen;
+}
+
+/*********************************************************************
+ * @fn      Frag_allocPdu
+ *
+ * @brief   Allocate the stack buffer of the next fragment and write its
+ *          header
+ *
+ * @param   pTx - message state
+ * @param   hdrLen - APP_FRAG_HDR_LEN, or 0 when the message is sent whole
+ * @param   fragLen - length of the fragment, without its header
+ *
+ * @return  the buffer, NULL when the stack has none left
+ */
+static uint8_t *Frag_allocPdu(Frag_txMsg_t *pTx, uint8_t hdrLen, uint16_t fragLen)
+{
+    uint8_t *pPdu;
+
+    pPdu = (uint8_t *)MemStats_bmAlloc(pTx->connHandle,
+                                       (pTx->method == ATT_HANDLE_VALUE_NOTI) ? ATT_HANDLE_VALUE_NOTI : ATT_WRITE_REQ,
+                                       hdrLen + fragLen);
+    if (pPdu != NULL && hdrLen)
+    {
+        pPdu[0] = FRAG_MARK | (pTx->seq & FRAG_SEQ_MASK) |
+                  ((pTx->offset + fragLen == pTx->len) ? FRAG_LAST : 0);
+    }
+
+    return pPdu;
+}
+
+/*********************************************************************
+ * @fn      Frag_sendPdu
+ *
+ * @brief   Hand a PDU to the stack. The buffer is owned by the stack on
+ *          success only.
+ *
+ * @param   pTx - message state
+ * @param   pPdu - buffer from Frag_allocPdu
+ * @param   pduLen - length of the PDU, header included
+ *
+ * @return  status of GATT_Notification or GATT_WriteNoRsp
+ */
+static bStatus_t Frag_sendPdu(Frag_txMsg_t *pTx, uint8_t *pPdu, uint16_t pduLen)
+{
+    if (pTx->method == ATT_HANDLE_VALUE_NOTI)
+    {
+        attHandleValueNoti_t noti;
+
+        noti.handle = pTx->attHandle;
+        noti.len = pduLen;
+        noti.pValue = pPdu;
+        return GATT_Notification(pTx->connHandle, &noti, FALSE);
+    }
+    else
+    {
+        attWriteReq_t req;
+
+        req.handle = pTx->attHandle;
+        req.len = pduLen;
+        req.pValue = pPdu;
+        req.sig = 0;
+        req.cmd = 1;
+        return GATT_WriteNoRsp(pTx->connHandle, &req);
+    }
+}
+
+/*********************************************************************
+ * @fn      Frag_freePdu
+ *
+ * @brief   Free a PDU the stack did not take
+ *
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   pPdu - buffer from Frag_allocPdu
+ *
+ * @return  none
+ */
+static void Frag_freePdu(uint8_t method, uint8_t *pPdu)
+{
+    if (method == ATT_HANDLE_VALUE_NOTI)
+    {
+        attHandleValueNoti_t noti;
+
+        noti.pValue = pPdu;
+        GATT_bm_free((gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI);
+    }
+    else
+    {
+        attWriteReq_t req;
+
+        req.pValue = pPdu;
+        GATT_bm_free((gattMsg_t *)&req, ATT_WRITE_REQ);
+    }
+}
+
+/*********************************************************************
+ * @fn      Frag_queueRest
+ *
+ * @brief   Move the part of the message being written that is not with
+ *          the stack to the retry queue: the fragment already written
+ *          in a stack buffer is copied there and the buffer is freed,
+ *          the next writes go straight to the queue. Frag_end commits
+ *          the queued message.
+ *
+ * @return  none, bleMemAllocError is kept in the builder status when
+ *          the queue is full
+ */
+static void Frag_queueRest(void)
+{
+    Frag_builder_t *pB = &fragBuilder;
+    uint16_t pending = pB->written - pB->tx.offset;
+    uint8_t *pData = &fragTxQueue[fragTxQueueLen + sizeof(Frag_txMsg_t)];
+
+    if (fragTxQueueLen + sizeof(Frag_txMsg_t) + (pB->tx.len - pB->tx.offset) > sizeof(fragTxQueue))
+    {
+        pB->status = bleMemAllocError;
+    }
+    else
+    {
+        if (pending)
+        {
+            memcpy(pData, &pB->pPdu[pB->hdrLen], pending);
+        }
+        pB->pQueued = pData + pending;
+    }
+
+    if (pB->pPdu != NULL)
+    {
+        Frag_freePdu(pB->tx.method, pB->pPdu);
+        pB->pPdu = NULL;
+    }
+}
+
+/*********************************************************************
+ * @fn      Frag_timerCB
+ *
+ * @brief   Retry timer expiry, handled in the BLEAppUtil context
+ *
+ * @param   arg - unused
+ *
+ * @return  none
+ */
+static void Frag_timerCB(uintptr_t arg)
+{
+    BLEAppUtil_invokeFunctionNoData(Frag_retryCB);
+}
+
+/*********************************************************************
+ * @fn      Frag_retryCB
+ *
+ * @brief   Send the queued messages in order
+ *
+ * @param   pData - unused
+ *
+ * @return  none
+ */
+static void Frag_retryCB(char *pData)
+{
+    Frag_txMsg_t tx;
+    bStatus_t status;
+
+    while (fragTxQueueLen > 0)
+    {
+        memcpy(&tx, fragTxQueue, sizeof(tx));
+        status = Frag_transmit(&tx, &fragTxQueue[sizeof(tx)]);
+        if (status == blePending)
+        {
+            // Keep the progress for the next try
+            memcpy(fragTxQueue, &tx, sizeof(tx));
+            ClockP_start(ClockP_handle(&fragRetryTimer));
+            return;
+        }
+        if (status != SUCCESS)
+        {
+            MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Fragment send failed = %d", status);
+        }
+
+        fragTxQueueLen -= sizeof(tx) + tx.len;
+        memmove(fragTxQueue, &fragTxQueue[sizeof(tx) + tx.len], fragTxQueueLen);
+    }
+}
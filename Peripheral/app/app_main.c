@@ -53,9 +53,7 @@ Target Device: cc23xx
 #include <app_main.h>
 
 #include <string.h>
-#include <ti/drivers/SHA2.h>
 #include <ti/drivers/ECDSA.h>
-#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
 //*****************************************************************************
 //! Defines
 //*****************************************************************************
@@ -88,7 +86,6 @@ BLEAppUtil_PeriCentParams_t appMainPeriCentParams;
 #endif //#if defined( HOST_CONFIG ) && ( HOST_CONFIG & ( PERIPHERAL_CFG | CENTRAL_CFG ) )
 
 extern gapBondOOBData_t localOobData;
-gapBondOOBData_t remoteOobData;
 
 //*****************************************************************************
 //! Functions
@@ -127,9 +124,17 @@ void App_StackInitDoneHandler(gapDeviceInitDoneEvent_t *deviceInitDoneData)
 {
     bStatus_t status = SUCCESS;
 
+    // Certificates, before any handshake can use them
+    CertStore_init();
+
     // Menu
     Menu_start();
 
+#if APP_MEM_STATS
+    // The init done handler runs in the BLEAppUtil task
+    MemStats_start(appMainParams.taskStackSize);
+#endif
+
     // Print the device ID address
     MenuModule_printf(APP_MENU_DEVICE_ADDRESS, 0, "BLE ID Address: "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_GREEN "%s" MENU_MODULE_COLOR_RESET,
@@ -246,24 +251,11 @@ void App_StackInitDoneHandler(gapDeviceInitDoneEvent_t *deviceInitDoneData)
 //    HCI_EXT_SetMaxDataLenCmd(251, 2120, 251, 2120);
 }
 
-void doAttWriteNoRsp(uint16 handle, uint8_t *inputValue, uint16_t inputLen)
+void doAttWriteNoRsp(uint16 handle, const uint8_t *inputValue, uint16_t inputLen)
 {
-    attWriteReq_t Req;
-    Req.handle = handle;
-    Req.len = inputLen;
-    Req.pValue = GATT_bm_alloc(0, ATT_WRITE_REQ, inputLen, NULL);
-    for (int i = 0; i < inputLen; i++)
-    {
-        Req.pValue[i] = inputValue[i];
-    }
-    Req.sig = 0;
-    Req.cmd = 1;
+    // Split in fragments when the ATT_MTU is too small
+    bStatus_t status = Frag_send(0, handle, ATT_WRITE_CMD, inputValue, inputLen);
 
-    bStatus_t status = GATT_WriteNoRsp(0, &Req);
-    if ( status != SUCCESS )
-    {
-        GATT_bm_free((gattMsg_t *)&Req, ATT_WRITE_REQ);
-    }
     MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttWriteCmd = "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
                       status);
@@ -280,23 +272,25 @@ void doAttReadReq(uint16 handle, uint8 charNum)
                       charNum, status);
 }
 
-void doAttNotification(uint16 handle, uint8_t *notiVal, uint16_t len)
+void doAttReadLongReq(uint16 handle, uint8 charNum)
 {
-    attHandleValueNoti_t req;
+    attReadBlobReq_t req;
+    req.handle = handle;
+    req.offset = 0;
 
-    req.handle = handle; //46
-    req.len = len;
-    req.pValue = (uint8 *)GATT_bm_alloc(0, ATT_HANDLE_VALUE_NOTI, len, NULL);
-    for (int i = 0; i < len; i++)
-    {
-        req.pValue[i] = notiVal[i];
-    }
+    // Read Blob requests until the whole value is read, for values
+    // larger than ATT_MTU - 1
+    bStatus_t status = GATT_ReadLongCharValue(0, &req, BLEAppUtil_getSelfEntity());
+    MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: GATTReadLong char %d = "
+                      MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "0x%02x" MENU_MODULE_COLOR_RESET,
+                      charNum, status);
+}
+
+void doAttNotification(uint16 handle, const uint8_t *notiVal, uint16_t len)
+{
+    // Split in fragments when the ATT_MTU is too small
+    bStatus_t status = Frag_send(0, handle, ATT_HANDLE_VALUE_NOTI, notiVal, len);
 
-    bStatus_t status = GATT_Notification(0, &req, 0);
-    if ( status != SUCCESS )
-    {
-        GATT_bm_free((gattMsg_t *)&req, ATT_HANDLE_VALUE_NOTI);
-    }
     MenuModule_printf(APP_MENU_GENERAL_STATUS_LINE, 0, "Call Status: AttNotification = "
                       MENU_MODULE_COLOR_BOLD MENU_MODULE_COLOR_RED "%d" MENU_MODULE_COLOR_RESET,
                       status);
@@ -312,65 +306,14 @@ bStatus_t doAttMtuExchange(uint8_t MTUVals)
     return status;
 }
 
-int_fast16_t signerCertVerify(uint8_t *signerCert)
+int_fast16_t signerCertVerify(const uint8_t *signerCert)
 {
-    uint8_t signerPublicKeyingMaterial[65] = {0};
-    signerPublicKeyingMaterial[0] = 4;
-    memcpy(&signerPublicKeyingMaterial[1], &signerCert[9], 64);
-
-    uint8_t r[32] = {0};
-    uint8_t s[32] = {0};
-    int_fast16_t shaResult;
-    int_fast16_t verifyResult;
-
-    // SHA256 signer public key
-    SHA2_Params params;
-    SHA2_Handle handle;
-    uint8_t message[64] = {0};
-
-    for (int i = 0; i < 64; i++)
-    {
-        message[i] = signerCert[9 + i];
-    }
-
-    uint8_t shaDigest[32]; // 32 bytes hash values
-    SHA2_init();
-    SHA2_Params_init(&params);
-    handle = SHA2_open(0, NULL);
-
-    shaResult = SHA2_hashData(handle, message, sizeof(message), shaDigest);
-    SHA2_close(handle);
-
-    for (int i = 0; i < 32; i++)
-    {
-        r[i] = signerCert[73 + i];
-        s[i] = signerCert[105 + i];
-    }
-
-    CryptoKey signerPublicKey;
-    ECDSA_Handle ecdsaHandle;
-    ECDSA_Params ecdsaParams;
-    ECDSA_OperationVerify operationVerify;
-
-    ECDSA_init();
-    ECDSA_Params_init(&ecdsaParams);
-    ecdsaHandle = ECDSA_open(0, NULL);
-
-    CryptoKeyPlaintext_initKey(&signerPublicKey,
-                               signerPublicKeyingMaterial,
-                               sizeof(signerPublicKeyingMaterial));
+    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "alive");
 
-    ECDSA_OperationVerify_init(&operationVerify);
-    operationVerify.curve           = &ECCParams_NISTP256;
-    operationVerify.theirPublicKey  = &signerPublicKey;
-    operationVerify.hash            = shaDigest;
-    operationVerify.r               = r;
-    operationVerify.s               = s;
+    const CertView_t *pCert = CertView_parse(signerCert, APP_CERT_LEN);
 
-    MenuModule_printf(APP_MENU_PROFILE_STATUS_LINE2, 0, "alive");
-    verifyResult = ECDSA_verify(ecdsaHandle, &operationVerify);
-    ECDSA_close(ecdsaHandle);
-    return verifyResult;
+    // Self-signed, the key of the certificate checks its own signature
+    return CertStore_verifyCert(pCert, pCert->publicKey);
 }
 
 /*********************************************************************
@@ -49,6 +49,8 @@ Target Device: cc23xx
 //! Includes
 //*****************************************************************************
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_crypto_ctx.h>
+#include <app_crypto_prof.h>
 
 //*****************************************************************************
 //! Defines
@@ -56,7 +58,190 @@ Target Device: cc23xx
 extern uint8_t oobEnabled;
 #define KEYLEN 16
 gapBondOOBData_t localOobData;
-extern gapBondOOBData_t remoteOobData;
+
+// The controller allocates the connection handles from 0, below the
+// maximum number of connections, so they index the connection contexts
+// directly
+#ifndef CONNECTION_HANDLE_MAP_SIZE
+#define CONNECTION_HANDLE_MAP_SIZE  MAX_NUM_BLE_CONNS
+#endif
+#define CONNECTION_SLOT_INVALID     0xFF
+
+// Carry the Peripheral's SC OOB confirm/rand in its advertising data so the
+// Central can set the remote OOB data before the connection completes,
+// instead of reading Characteristic 1 after the MTU exchange.
+// The confirm value is placed in the advertising data and the random value
+// in the scan response, since both do not fit in one 31 byte legacy PDU.
+#ifndef APP_OOB_IN_ADV_DATA
+#define APP_OOB_IN_ADV_DATA 1
+#endif
+
+// AD types for the LE Secure Connections OOB values (Core Spec Supplement)
+#define APP_ADTYPE_SC_CONFIRM_VALUE 0x22
+#define APP_ADTYPE_SC_RANDOM_VALUE  0x23
+
+// Set when remoteOobData was filled from the peer's advertising data
+extern uint8_t remoteOobReady;
+
+// Advertising policy after a disconnection: high duty cycle directed
+// advertising to the last bonded central, then a fast undirected burst,
+// then slow undirected advertising until a central connects.
+// A stage with a zero duration is skipped.
+#ifndef APP_RECONNECT_POLICY
+#define APP_RECONNECT_POLICY 1
+#endif
+
+// High duty cycle directed advertising window, in 10 ms units.
+// The spec limits it to 1.28 s.
+#ifndef APP_RECONNECT_DIRECTED_DURATION
+#define APP_RECONNECT_DIRECTED_DURATION 128
+#endif
+
+// Fast undirected advertising interval, in 0.625 ms units (30 ms)
+#ifndef APP_RECONNECT_FAST_INT
+#define APP_RECONNECT_FAST_INT 48
+#endif
+
+// Fast undirected advertising window, in 10 ms units (30 s)
+#ifndef APP_RECONNECT_FAST_DURATION
+#define APP_RECONNECT_FAST_DURATION 3000
+#endif
+
+// Slow undirected advertising interval, in 0.625 ms units.
+// 0 keeps the Sysconfig interval of advParams1.
+#ifndef APP_RECONNECT_SLOW_INT
+#define APP_RECONNECT_SLOW_INT 0
+#endif
+
+// Per-link radio statistics: RSSI, CRC errors and missed events of the
+// connection event reports, folded every APP_RADIO_STATS_PERIOD_MS into
+// rolling averages for the link policies, the menu and Characteristic 7
+#ifndef APP_RADIO_STATS
+#define APP_RADIO_STATS             1
+#endif
+#ifndef APP_RADIO_STATS_PERIOD_MS
+#define APP_RADIO_STATS_PERIOD_MS   1000
+#endif
+// Weight of a new period in the rolling averages is 1 / 2^shift
+#ifndef APP_RADIO_STATS_AVG_SHIFT
+#define APP_RADIO_STATS_AVG_SHIFT   2
+#endif
+// Size of the serialized statistics of a link
+#define RADIO_STATS_SERIAL_LEN      19
+
+// Stack high water marks of the application tasks, heap watermarks and
+// allocation failures, for the menu and Characteristic 8
+#ifndef APP_MEM_STATS
+#define APP_MEM_STATS               1
+#endif
+// Watched tasks: BLEAppUtil, the TA010 Sign task and a spare slot
+#define MEM_STATS_MAX_TASKS         3
+// Size of the serialized memory statistics
+#define MEM_STATS_SERIAL_LEN        (MEM_STATS_MAX_TASKS * 4 + 10)
+
+// Single round mutual challenge-response: both sides send their device
+// certificate with a fresh TA010 nonce (HELLO) and answer with a signature
+// over both nonces (FINISH), instead of the sequential certificate and
+// challenge phases. Each side verifies the peer certificate against the
+// signers of its certificate store, so the device certificates must come
+// from a bundle whose signer issued them, and each device needs its own
+// TA010 key. HELLO carries the device certificate of the TA010 key, which
+// signs FINISH: a bundle may hold the certificates of several devices.
+#ifndef APP_MUTUAL_AUTH
+#define APP_MUTUAL_AUTH 0
+#endif
+
+// The TA010 Nonce and Sign commands are executed locally on the CPU until
+// the I2C transport is wired in, 0 does not build yet. The emulated Sign
+// shares the CPU with the verifications, so it cannot run alongside them.
+#ifndef TA010_EMULATED
+#define TA010_EMULATED 1
+#endif
+// Test builds only: the emulated Sign uses the private key of the built-in
+// device certificate. That key is public, so an image built with it has no
+// identity of its own and must never ship. Without it the emulated Sign
+// fails and the device cannot answer a challenge.
+#ifndef TA010_TEST_KEY
+#define TA010_TEST_KEY 0
+#endif
+
+#define APP_NONCE_LEN               32
+#define MUTUAL_AUTH_HELLO_ID        0x07
+#define MUTUAL_AUTH_FINISH_ID       0x08
+// id + certificate + nonce
+#define MUTUAL_AUTH_HELLO_LEN       (1 + APP_CERT_LEN + APP_NONCE_LEN)
+// id + signature r + s
+#define MUTUAL_AUTH_FINISH_LEN      (1 + 64)
+
+// Certificates of the certificate store, by certificate id
+typedef enum
+{
+    CERT_STORE_DEVICE = 0x01,
+    CERT_STORE_SIGNER = 0x02
+}CertStore_ids;
+
+// Certificate bundle: the certificates of the store are read in place
+// from a double-buffered bundle at the end of the NVS_SLOT flash region,
+// see app_cert_store.c. The bundle is written with the programmer. Without
+// a valid bundle the certificates built in the image are used.
+#ifndef APP_CERT_BUNDLE
+#define APP_CERT_BUNDLE             1
+#endif
+// Certificates of a bundle, signers and device certificates together
+#ifndef CERT_BUNDLE_MAX_CERTS
+#define CERT_BUNDLE_MAX_CERTS       8
+#endif
+// Fingerprint of a certificate: SHA256 of its APP_CERT_LEN bytes
+#define CERT_FINGERPRINT_LEN        32
+
+// Certificate revocation: fingerprints of rejected certificates are kept
+// in a double-buffered list in NVS_SLOT, with a Bloom filter in front of
+// it, see app_cert_store.c. A revoked certificate is rejected before any
+// signature verification.
+#ifndef APP_CERT_REVOKE
+#define APP_CERT_REVOKE             1
+#endif
+// Revoked certificates the list holds
+#ifndef CERT_REVOKE_MAX_IDS
+#define CERT_REVOKE_MAX_IDS         96
+#endif
+// CertStore_verifyCert status of a revoked certificate, below the ECDSA
+// driver status codes (ECDSA_STATUS_RESERVED is -32)
+#define CERT_STORE_REVOKED_STATUS   (-33)
+
+// Certificate chain: the peripheral sends root -> intermediates -> device,
+// one certificate per message, and the central verifies each one as it
+// arrives, keeping only the key of the current issuer. The first bad
+// certificate aborts the transfer. The certificates built in the image
+// are self-signed and do not form a chain: enable it together with a
+// bundle that holds the issuers of the device certificate, in any order
+// and next to other signers.
+#ifndef APP_CERT_CHAIN
+#define APP_CERT_CHAIN              0
+#endif
+// Certificates of a chain, root and device included
+#ifndef CERT_CHAIN_MAX_DEPTH
+#define CERT_CHAIN_MAX_DEPTH        4
+#endif
+// Certificates sent ahead of the acknowledgements
+#ifndef CERT_CHAIN_WINDOW
+#define CERT_CHAIN_WINDOW           2
+#endif
+#define CERT_CHAIN_REQ_ID           0x09
+#define CERT_CHAIN_LINK_ID          0x0A
+#define CERT_CHAIN_ACK_ID           0x0B
+#define CERT_CHAIN_ABORT_ID         0x0C
+// Index of a chain message, flagged on the device certificate
+#define CERT_CHAIN_LAST             BV(7)
+// id + index + certificate
+#define CERT_CHAIN_LINK_LEN         (2 + APP_CERT_LEN)
+
+// Largest handshake message. A message the ATT_MTU cannot carry in one PDU
+// is sent as fragments of APP_FRAG_HDR_LEN + (ATT_MTU - 3 - APP_FRAG_HDR_LEN)
+// bytes. The fragment header is 0xE0 - 0xFF and handshake message ids stay
+// below it, so each PDU tells the receiver how it is framed.
+#define APP_FRAG_MSG_MAX_LEN        MUTUAL_AUTH_HELLO_LEN
+#define APP_FRAG_HDR_LEN            1
 //*****************************************************************************
 //! Typedefs
 //*****************************************************************************
@@ -78,6 +263,81 @@ typedef enum
     APP_MENU_PROFILE_STATUS_LINE5
 }AppMenu_rows;
 
+// Handshake phases measured by the phase timers
+typedef enum
+{
+    APP_PHASE_VERIFY,       // Peer certificates and challenge verification
+    APP_PHASE_TA010_SIGN,   // TA010 Sign command over the peer nonce
+    APP_PHASE_NUM
+}App_phases;
+
+// Transfer strategy of a message, chosen from the negotiated link values
+typedef enum
+{
+    LINK_XFER_SINGLE_PACKET,    // Fits in one ATT PDU and one LL packet
+    LINK_XFER_LL_FRAGMENTS,     // One ATT PDU split by the LL
+    LINK_XFER_ATT_FRAGMENTS     // Larger than the ATT_MTU
+}LinkReady_strategies;
+
+// Frag_receive status
+typedef enum
+{
+    FRAG_RX_DONE,       // The message is complete
+    FRAG_RX_PENDING,    // More fragments are expected
+    FRAG_RX_ERROR       // Malformed fragment, the message is dropped
+}Frag_rxStatus;
+
+// Called once the link is configured for the large transfers
+typedef void (*LinkReady_readyCB_t)(uint16_t connHandle);
+
+typedef enum
+{
+    MUTUAL_AUTH_ROLE_CENTRAL,
+    MUTUAL_AUTH_ROLE_PERIPHERAL
+}MutualAuth_roles;
+
+// Called once the peer of a link is authenticated
+typedef void (*MutualAuth_doneCB_t)(uint16_t connHandle, uint8_t role);
+
+// Called once the peer certificate chain is verified or rejected
+typedef void (*CertChain_doneCB_t)(uint16_t connHandle, int_fast16_t status);
+
+// Radio statistics of a link
+typedef struct
+{
+  uint16_t  connHandle;
+  uint8_t   phy;                    // HCI_PHY_xx of the last connection event
+  int8_t    lastRssi;               // dBm, last received connection event
+  int8_t    avgRssi;                // dBm, rolling average
+  uint8_t   crcPct;                 // Rolling % of the events with a CRC error
+  uint8_t   missPct;                // Rolling % of the missed events
+  uint16_t  evtRate;                // Rolling connection events per period
+  uint32_t  avgEvents;              // Events in the averages since the last reset
+  uint32_t  totalEvents;            // Totals since the connection
+  uint32_t  totalCrc;
+  uint32_t  totalMissed;
+  uint32_t  totalSkipped;           // Event counter gaps (latency, scheduling)
+}RadioStats_t;
+
+// Called for each link at the end of a sampling period
+typedef void (*RadioStats_sampleCB_t)(uint16_t connHandle, const RadioStats_t *pStats);
+
+// Memory statistics since boot, all sizes in bytes
+typedef struct
+{
+  struct
+  {
+    uint32_t  stackSize;
+    uint32_t  stackPeak;            // Deepest use of the painted stack
+  }tasks[MEM_STATS_MAX_TASKS];
+  uint8_t   numTasks;
+  uint32_t  heapSize;
+  uint32_t  heapFree;
+  uint32_t  heapMinFree;            // Lowest free heap, heapSize - peak use
+  uint16_t  bmAllocFailures;        // Failed GATT_bm_alloc
+  uint16_t  mallocFailures;         // Failed ICall_malloc
+}MemStats_t;
+
 PACKED_ALIGNED_TYPEDEF_STRUCT
 {
   /// Type of TargetA address in the directed advertising PDU
@@ -86,12 +346,16 @@ PACKED_ALIGNED_TYPEDEF_STRUCT
   BLEAppUtil_BDaddr  address;
 }App_scanResults;
 
-// Connected device information
+// Connection context, holds the per-link state of the application
 PACKED_ALIGNED_TYPEDEF_STRUCT
 {
   uint16_t  connHandle;             // Connection Handle
   BLEAppUtil_BDaddr peerAddress;    // The address of the peer device
-} App_connInfo;
+  uint8_t   activeIdx;              // Index in the connected device list
+  gapBondOOBData_t remoteOob;       // OOB data of the central
+  uint8_t   remoteOobValue[2 * KEYLEN]; // Characteristic 1 of the central
+  uint16_t  remoteOobLen;           // Bytes of remoteOobValue read so far
+} App_connCtx;
 
 //*****************************************************************************
 //! Functions
@@ -109,6 +373,32 @@ PACKED_ALIGNED_TYPEDEF_STRUCT
  */
 bStatus_t Peripheral_start(void);
 
+/*********************************************************************
+ * @fn      Peripheral_updateOobAdvData
+ *
+ * @brief   Generate new local OOB data, store it in Characteristic 1
+ *          and load the confirm/random values into the advertising
+ *          and scan response data of the advertise set. Before the
+ *          advertise set exists, only mark the data to be loaded by
+ *          Peripheral_start.
+ *
+ * @return  SUCCESS, bleNotReady before the advertise set exists,
+ *          errorInfo
+ */
+bStatus_t Peripheral_updateOobAdvData(void);
+
+/*********************************************************************
+ * @fn      Peripheral_setReconnectPeer
+ *
+ * @brief   Remember the bonded central of a link as the target of the
+ *          directed advertising stage of the reconnect policy.
+ *
+ * @param   connHandle - connection handle of the bonded central
+ *
+ * @return  SUCCESS, errorInfo
+ */
+bStatus_t Peripheral_setReconnectPeer(uint16_t connHandle);
+
 /*********************************************************************
  * @fn      Broadcaster_start
  *
@@ -203,6 +493,15 @@ bStatus_t DevInfo_start(void);
  */
 bStatus_t SimpleGatt_start(void);
 
+/*********************************************************************
+ * @fn      SimpleGatt_resetChallenge
+ *
+ * @brief   Forget the challenge state of the previous link
+ *
+ * @return  none
+ */
+void SimpleGatt_resetChallenge(void);
+
 /*********************************************************************
  * @fn      OAD_start
  *
@@ -293,13 +592,26 @@ bStatus_t Menu_start(void);
 uint8 Scan_getScanResList(App_scanResults **scanRes);
 
 /*********************************************************************
- * @fn      Connection_getConnList
+ * @fn      Connection_getCtx
  *
- * @brief   Get the connection list
+ * @brief   Find the context of a connection
  *
- * @return  connection list
+ * @param   connHandle - connection handle
+ *
+ * @return  the connection context, or NULL if the link is unknown
  */
-App_connInfo *Connection_getConnList(void);
+App_connCtx *Connection_getCtx(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Connection_getCtxByIndex
+ *
+ * @brief   Get the context of an entry of the connected device list
+ *
+ * @param   index - index in the connected device list
+ *
+ * @return  the connection context, or NULL past the last connection
+ */
+App_connCtx *Connection_getCtxByIndex(uint8_t index);
 
 /*********************************************************************
  * @fn      Connection_getConnhandle
@@ -314,21 +626,796 @@ uint16_t Connection_getConnhandle(uint8_t index);
 /*********************************************************************
  * @fn      Connection_getConnIndex
  *
- * @brief   Find index in the connected device list by connHandle
+ * @brief   Find the context slot of a connection. The slot does not
+ *          change while the link is up.
  *
- * @return  the index of the entry that has the given connection handle.
+ * @return  the slot of the given connection handle.
  *          if there is no match, LL_INACTIVE_CONNECTIONS will be returned.
  */
 uint16_t Connection_getConnIndex(uint16_t connHandle);
 
-void doAttWriteNoRsp(uint16 handle, uint8_t *inputValue, uint16_t inputLen);
+/*********************************************************************
+ * @fn      Ta010_nonce
+ *
+ * @brief   Execute the TA010 Nonce command
+ *
+ * @param   nonce - buffer of APP_NONCE_LEN bytes
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_nonce(uint8_t *nonce);
+
+/*********************************************************************
+ * @fn      Ta010_sign
+ *
+ * @brief   Execute the TA010 Sign command over a SHA256 digest
+ *
+ * @param   digest - 32 bytes digest
+ * @param   signature - buffer of 64 bytes for r + s
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_sign(uint8_t *digest, uint8_t *signature);
+
+/*********************************************************************
+ * @fn      Ta010_getPublicKey
+ *
+ * @brief   Execute the TA010 GenKey command: public key of the slot 0
+ *          private key that Ta010_sign uses
+ *
+ * @param   publicKey - buffer of CERT_PUBLIC_KEY_LEN bytes for X || Y
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_getPublicKey(uint8_t *publicKey);
+
+/*********************************************************************
+ * @fn      Ta010_signAsync
+ *
+ * @brief   Start the TA010 Sign command without waiting for it, or
+ *          right after a discarded one
+ *
+ * @param   digest - 32 bytes digest
+ * @param   doneCB - called in the BLEAppUtil context when done
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_signAsync(uint8_t *digest, InvokeFromBLEAppUtilContext_t doneCB);
+
+/*********************************************************************
+ * @fn      Ta010_getSignResult
+ *
+ * @brief   Take the signature of the last Ta010_signAsync call
+ *
+ * @param   signature - buffer of 64 bytes for r + s
+ *
+ * @return  SUCCESS if a signature was ready, FAILURE otherwise
+ */
+bStatus_t Ta010_getSignResult(uint8_t *signature);
+
+/*********************************************************************
+ * @fn      Ta010_discardSign
+ *
+ * @brief   Drop the result of the pending Sign command
+ *
+ * @return  none
+ */
+void Ta010_discardSign(void);
+
+/*********************************************************************
+ * @fn      PhaseTimer_start
+ *
+ * @brief   Start timing a handshake phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_start(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_stop
+ *
+ * @brief   Stop timing a handshake phase
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  none
+ */
+void PhaseTimer_stop(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_getUs
+ *
+ * @brief   Duration of the last run of a phase in microseconds
+ *
+ * @param   phase - one of App_phases
+ *
+ * @return  duration
+ */
+uint32_t PhaseTimer_getUs(uint8_t phase);
+
+/*********************************************************************
+ * @fn      PhaseTimer_getOverlapUs
+ *
+ * @brief   Time in microseconds during which two phases ran together
+ *
+ * @param   phaseA - one of App_phases
+ * @param   phaseB - one of App_phases
+ *
+ * @return  overlap
+ */
+uint32_t PhaseTimer_getOverlapUs(uint8_t phaseA, uint8_t phaseB);
+
+/*********************************************************************
+ * @fn      PhaseTimer_reset
+ *
+ * @brief   Stop and clear every phase timer, e.g. when the handshake
+ *          failed or the link it was timing is gone
+ *
+ * @return  none
+ */
+void PhaseTimer_reset(void);
+
+/*********************************************************************
+ * @fn      Frag_init
+ *
+ * @brief   Clear the fragmentation layer
+ *
+ * @return  none
+ */
+void Frag_init(void);
+
+/*********************************************************************
+ * @fn      Frag_reset
+ *
+ * @brief   Drop the queued and partly received messages of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void Frag_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      Frag_send
+ *
+ * @brief   Send a handshake message, split in fragments when the
+ *          ATT_MTU of the link is too small
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   pMsg - message
+ * @param   len - length of the message
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER or bleMemAllocError
+ */
+bStatus_t Frag_send(uint16_t connHandle, uint16_t attHandle, uint8_t method,
+                    const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_begin
+ *
+ * @brief   Start a message given in parts with Frag_write. The parts
+ *          are copied straight in the stack buffers of the fragments.
+ *
+ * @param   connHandle - connection handle
+ * @param   attHandle - attribute handle
+ * @param   method - ATT_WRITE_CMD or ATT_HANDLE_VALUE_NOTI
+ * @param   len - length of the whole message
+ *
+ * @return  SUCCESS, INVALIDPARAMETER or bleMemAllocError
+ */
+bStatus_t Frag_begin(uint16_t connHandle, uint16_t attHandle, uint8_t method, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_write
+ *
+ * @brief   Append a part to the message started by Frag_begin
+ *
+ * @param   pData - data, may be in flash
+ * @param   len - length of the data
+ *
+ * @return  none
+ */
+void Frag_write(const uint8_t *pData, uint16_t len);
+
+/*********************************************************************
+ * @fn      Frag_end
+ *
+ * @brief   Finish the message started by Frag_begin
+ *
+ * @return  SUCCESS (sent or queued), INVALIDPARAMETER, bleMemAllocError
+ *          or the stack error that dropped the message
+ */
+bStatus_t Frag_end(void);
+
+/*********************************************************************
+ * @fn      Frag_receive
+ *
+ * @brief   Place a received PDU in the message buffer
+ *
+ * @param   connHandle - connection handle
+ * @param   ppMsg - in: PDU, out: complete message
+ * @param   pLen - in: length of the PDU, out: length of the message
+ * @param   pBuf - buffer the fragments are reassembled in
+ * @param   bufLen - size of pBuf
+ *
+ * @return  one of Frag_rxStatus
+ */
+uint8_t Frag_receive(uint16_t connHandle, uint8_t **ppMsg, uint16_t *pLen,
+                     uint8_t *pBuf, uint16_t bufLen);
+
+/*********************************************************************
+ * @fn      Frag_isFragment
+ *
+ * @brief   Tell a fragment from a whole message by its first byte
+ *
+ * @param   pPdu - received PDU
+ * @param   len - length of the PDU
+ *
+ * @return  TRUE when the PDU carries a fragment header
+ */
+uint8_t Frag_isFragment(const uint8_t *pPdu, uint16_t len);
+
+/*********************************************************************
+ * @fn      MutualAuth_init
+ *
+ * @brief   Register the callback of the authenticated links
+ *
+ * @param   doneCB - called when the peer FINISH was verified, may be NULL
+ *
+ * @return  none
+ */
+void MutualAuth_init(MutualAuth_doneCB_t doneCB);
+
+/*********************************************************************
+ * @fn      MutualAuth_reset
+ *
+ * @brief   Clear the mutual authentication state of the link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void MutualAuth_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      MutualAuth_start
+ *
+ * @brief   Send the HELLO message (certificate + nonce)
+ *
+ * @param   connHandle - connection handle
+ * @param   role - MUTUAL_AUTH_ROLE_CENTRAL or MUTUAL_AUTH_ROLE_PERIPHERAL
+ *
+ * @return  none
+ */
+void MutualAuth_start(uint16_t connHandle, uint8_t role);
+
+/*********************************************************************
+ * @fn      MutualAuth_processHello
+ *
+ * @brief   Verify the peer HELLO message
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processHello(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      MutualAuth_processFinish
+ *
+ * @brief   Verify the peer FINISH message
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void MutualAuth_processFinish(uint16_t connHandle, uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_init
+ *
+ * @brief   Register the callback of the verified chains
+ *
+ * @param   doneCB - called when a chain is verified or rejected, may be NULL
+ *
+ * @return  none
+ */
+void CertChain_init(CertChain_doneCB_t doneCB);
+
+/*********************************************************************
+ * @fn      CertChain_reset
+ *
+ * @brief   Clear the certificate chain state of the link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      CertChain_request
+ *
+ * @brief   Ask the peripheral for its certificate chain (central)
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void CertChain_request(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      CertChain_processRequest
+ *
+ * @brief   Start sending the local certificate chain (peripheral)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processRequest(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_processLink
+ *
+ * @brief   Verify a received certificate of the chain (central)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processLink(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_processAck
+ *
+ * @brief   Handle the acknowledgement or abort of a sent certificate
+ *          (peripheral)
+ *
+ * @param   connHandle - connection handle
+ * @param   pMsg - received message
+ * @param   len - length of the message
+ *
+ * @return  none
+ */
+void CertChain_processAck(uint16_t connHandle, const uint8_t *pMsg, uint16_t len);
+
+/*********************************************************************
+ * @fn      CertChain_getDeviceKey
+ *
+ * @brief   Public key of the peer device certificate, once its chain
+ *          is verified
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes, or NULL while the chain is not
+ *          verified
+ */
+const uint8_t *CertChain_getDeviceKey(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_init
+ *
+ * @brief   Clear the link readiness tracker
+ *
+ * @param   readyCB - called once per link when it is configured
+ *
+ * @return  none
+ */
+void LinkReady_init(LinkReady_readyCB_t readyCB);
+
+/*********************************************************************
+ * @fn      LinkReady_add
+ *
+ * @brief   Start tracking a new link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_add(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_remove
+ *
+ * @brief   Stop tracking a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_remove(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_setMtu
+ *
+ * @brief   Record the negotiated ATT_MTU
+ *
+ * @param   connHandle - connection handle
+ * @param   mtu - new ATT_MTU
+ *
+ * @return  none
+ */
+void LinkReady_setMtu(uint16_t connHandle, uint16_t mtu);
+
+/*********************************************************************
+ * @fn      LinkReady_setDataLen
+ *
+ * @brief   Record the negotiated LL payload sizes
+ *
+ * @param   connHandle - connection handle
+ * @param   txOctets - max LL payload sent
+ * @param   rxOctets - max LL payload received
+ *
+ * @return  none
+ */
+void LinkReady_setDataLen(uint16_t connHandle, uint16_t txOctets, uint16_t rxOctets);
+
+/*********************************************************************
+ * @fn      LinkReady_expectPhy
+ *
+ * @brief   Wait for a requested PHY update before the large transfers
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkReady_expectPhy(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_setPhy
+ *
+ * @brief   Record the PHY of a link
+ *
+ * @param   connHandle - connection handle
+ * @param   phy - HCI_PHY_xx, or 0 when the update failed
+ *
+ * @return  none
+ */
+void LinkReady_setPhy(uint16_t connHandle, uint8_t phy);
+
+/*********************************************************************
+ * @fn      LinkReady_getMtu
+ *
+ * @brief   Negotiated ATT_MTU of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  ATT_MTU
+ */
+uint16_t LinkReady_getMtu(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      LinkReady_getStrategy
+ *
+ * @brief   Transfer strategy of a message on a link
+ *
+ * @param   connHandle - connection handle
+ * @param   msgLen - length of the message
+ *
+ * @return  one of LinkReady_strategies
+ */
+uint8_t LinkReady_getStrategy(uint16_t connHandle, uint16_t msgLen);
+
+/*********************************************************************
+ * @fn      CertStore_init
+ *
+ * @brief   Select the newest valid certificate bundle, and compute the
+ *          fingerprints of the built-in certificates when there is none
+ *
+ * @return  none
+ */
+void CertStore_init(void);
+
+/*********************************************************************
+ * @fn      CertStore_get
+ *
+ * @brief   Get a local certificate, the first one of its id
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL for an unknown id
+ */
+const uint8_t *CertStore_get(uint8_t certId);
+
+/*********************************************************************
+ * @fn      CertStore_getAt
+ *
+ * @brief   Get one of the local certificates of an id, a bundle may
+ *          hold several signers
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL past the last one
+ */
+const uint8_t *CertStore_getAt(uint8_t certId, uint8_t index);
+
+/*********************************************************************
+ * @fn      CertStore_getFingerprint
+ *
+ * @brief   Get the fingerprint of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   index - 0 for the first certificate of the id
+ *
+ * @return  CERT_FINGERPRINT_LEN bytes, or NULL past the last one
+ */
+const uint8_t *CertStore_getFingerprint(uint8_t certId, uint8_t index);
+
+/*********************************************************************
+ * @fn      CertStore_findByFingerprint
+ *
+ * @brief   Find a local certificate from its fingerprint
+ *
+ * @param   pFingerprint - CERT_FINGERPRINT_LEN bytes
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByFingerprint(const uint8_t *pFingerprint);
+
+/*********************************************************************
+ * @fn      CertStore_findByPublicKey
+ *
+ * @brief   Find a local certificate of an id from its public key
+ *
+ * @param   certId - one of CertStore_ids
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes X || Y
+ *
+ * @return  APP_CERT_LEN bytes in flash, or NULL when not in the store
+ */
+const uint8_t *CertStore_findByPublicKey(uint8_t certId, const uint8_t *pPublicKey);
+
+/*********************************************************************
+ * @fn      CertStore_verifySigned
+ *
+ * @brief   Verify a certificate against each signer of the store
+ *
+ * @param   pCert - certificate, see CertView_parse
+ *
+ * @return  ECDSA_STATUS_SUCCESS when a signer signed it,
+ *          CERT_STORE_REVOKED_STATUS, otherwise the error of the last
+ *          verification
+ */
+int_fast16_t CertStore_verifySigned(const CertView_t *pCert);
+
+/*********************************************************************
+ * @fn      CertStore_verifyCert
+ *
+ * @brief   Verify a received certificate against the key of its
+ *          signer, after checking the revocation list
+ *
+ * @param   pCert - certificate, see CertView_parse
+ * @param   pPublicKey - CERT_PUBLIC_KEY_LEN bytes key of the signer
+ *
+ * @return  ECDSA_STATUS_SUCCESS, CERT_STORE_REVOKED_STATUS or the
+ *          error of the verification
+ */
+int_fast16_t CertStore_verifyCert(const CertView_t *pCert, const uint8_t *pPublicKey);
+
+/*********************************************************************
+ * @fn      CertStore_getPublicKey
+ *
+ * @brief   Get the public key of a local certificate
+ *
+ * @param   certId - one of CertStore_ids
+ *
+ * @return  CERT_PUBLIC_KEY_LEN bytes in flash, or NULL for an
+ *          unknown id
+ */
+const uint8_t *CertStore_getPublicKey(uint8_t certId);
+
+/*********************************************************************
+ * @fn      RadioStats_start
+ *
+ * @brief   Start the radio statistics collector
+ *
+ * @param   sampleCB - called for each link every sampling period, or NULL
+ *
+ * @return  SUCCESS or stack call status
+ */
+bStatus_t RadioStats_start(RadioStats_sampleCB_t sampleCB);
+
+/*********************************************************************
+ * @fn      RadioStats_add
+ *
+ * @brief   Start collecting the statistics of a new link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_add(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_remove
+ *
+ * @brief   Stop collecting the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_remove(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_reset
+ *
+ * @brief   Restart the rolling averages of a link
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_reset(uint16_t connHandle);
+
+/*********************************************************************
+ * @fn      RadioStats_get
+ *
+ * @brief   Read the statistics of a link
+ *
+ * @param   connHandle - connection handle
+ * @param   pStats - filled with the statistics
+ *
+ * @return  SUCCESS, or INVALIDPARAMETER if the link is unknown
+ */
+bStatus_t RadioStats_get(uint16_t connHandle, RadioStats_t *pStats);
+
+/*********************************************************************
+ * @fn      RadioStats_serialize
+ *
+ * @brief   Write the statistics of a link for the diagnostic
+ *          characteristic
+ *
+ * @param   connHandle - connection handle
+ * @param   pBuf - RADIO_STATS_SERIAL_LEN bytes
+ *
+ * @return  none
+ */
+void RadioStats_serialize(uint16_t connHandle, uint8_t *pBuf);
+
+/*********************************************************************
+ * @fn      RadioStats_print
+ *
+ * @brief   Print the statistics of a link on the menu
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void RadioStats_print(uint16_t connHandle);
+
+#if APP_MEM_STATS
+/*********************************************************************
+ * @fn      MemStats_start
+ *
+ * @brief   Watch the stack of the calling task, the BLEAppUtil task
+ *          when called from the stack init done handler.
+ *
+ * @param   appStackSize - stack size of the calling task in bytes
+ *
+ * @return  none
+ */
+void MemStats_start(uint32_t appStackSize);
+
+/*********************************************************************
+ * @fn      MemStats_addTask
+ *
+ * @brief   Watch the stack of a task. Tasks added twice are kept once.
+ *
+ * @param   taskHandle - FreeRTOS handle of the task
+ * @param   stackSize - stack size of the task in bytes
+ *
+ * @return  none
+ */
+void MemStats_addTask(void *taskHandle, uint32_t stackSize);
+
+/*********************************************************************
+ * @fn      MemStats_get
+ *
+ * @brief   Stack high water marks of the watched tasks, heap
+ *          watermarks and allocation failures since boot
+ *
+ * @param   pStats - filled with the statistics
+ *
+ * @return  none
+ */
+void MemStats_get(MemStats_t *pStats);
+
+/*********************************************************************
+ * @fn      MemStats_serialize
+ *
+ * @brief   Little endian form of the statistics for Characteristic 8
+ *
+ * @param   pBuf - MEM_STATS_SERIAL_LEN bytes
+ *
+ * @return  none
+ */
+void MemStats_serialize(uint8_t *pBuf);
+
+/*********************************************************************
+ * @fn      MemStats_print
+ *
+ * @brief   Print the statistics on the menu
+ *
+ * @return  none
+ */
+void MemStats_print(void);
+
+/*********************************************************************
+ * @fn      MemStats_bmAlloc
+ *
+ * @brief   GATT_bm_alloc that counts the failed allocations
+ *
+ * @param   connHandle - connection handle
+ * @param   opcode - ATT opcode of the message
+ * @param   size - payload size
+ *
+ * @return  payload buffer, NULL if the allocation failed
+ */
+void *MemStats_bmAlloc(uint16_t connHandle, uint8_t opcode, uint16_t size);
+
+/*********************************************************************
+ * @fn      MemStats_malloc
+ *
+ * @brief   ICall_malloc that counts the failed allocations
+ *
+ * @param   size - bytes to allocate
+ *
+ * @return  buffer, NULL if the allocation failed
+ */
+void *MemStats_malloc(uint32_t size);
+#else
+#define MemStats_bmAlloc(connHandle, opcode, size)  GATT_bm_alloc(connHandle, opcode, size, NULL)
+#define MemStats_malloc(size)                       ICall_malloc(size)
+#endif
+
+#if APP_CRYPTO_PROF
+/*********************************************************************
+ * @fn      CryptoProf_getLocalOob
+ *
+ * @brief   GAPBondMgr_SCGetLocalOOBParameters that records its duration
+ *
+ * @param   pLocalOobData - filled with the new local OOB data
+ *
+ * @return  status of GAPBondMgr_SCGetLocalOOBParameters
+ */
+bStatus_t CryptoProf_getLocalOob(gapBondOOBData_t *pLocalOobData);
+
+/*********************************************************************
+ * @fn      CryptoProf_print
+ *
+ * @brief   Print the crypto operation statistics on the menu
+ *
+ * @return  none
+ */
+void CryptoProf_print(void);
+#else
+#define CryptoProf_getLocalOob(pLocalOobData)       GAPBondMgr_SCGetLocalOOBParameters(pLocalOobData)
+#endif
+
+void doAttWriteNoRsp(uint16 handle, const uint8_t *inputValue, uint16_t inputLen);
 
 void doAttReadReq(uint16 handle, uint8 charNum);
 
-void doAttNotification(uint16 handle, uint8_t *notiVal, uint16_t len);
+void doAttReadLongReq(uint16 handle, uint8 charNum);
+
+void doAttNotification(uint16 handle, const uint8_t *notiVal, uint16_t len);
 
 bStatus_t doAttMtuExchange(uint8_t MTUVals);
 
-int_fast16_t signerCertVerify(uint8_t *signerCert);
+int_fast16_t signerCertVerify(const uint8_t *signerCert);
 
 #endif /* APP_MAIN_H_ */
@@ -79,6 +79,15 @@ extern void Menu_doGattWriteCB(uint8 index);
 void Menu_GattExchangeMTUCB(uint8 index);
 void Menu_GattExchangeMTUValueCB(uint8 index);
 void Menu_doRssiRead(uint8 index);
+#if APP_RADIO_STATS
+void Menu_doRadioStats(uint8 index);
+#endif
+#if APP_MEM_STATS
+void Menu_memStatsCB(uint8 index);
+#endif
+#if APP_CRYPTO_PROF
+void Menu_cryptoProfCB(uint8 index);
+#endif
 extern void Menu_doEnableNotification(uint8 index);
 void Menu_doDisableNotification(uint8 index);
 
@@ -123,6 +132,9 @@ const MenuModule_Menu_t workWithMenu[] =
  {"GATTwrite", &Menu_GattWriteCB, "Write a specific connection's characteristic"},
  {"Change max ATT_MTU", &Menu_GattExchangeMTUValueCB, "set the ATT_MTU to the maximum possible value that can be supported by both devices"},
  {"Start RSSI Reading", &Menu_doRssiRead, "Start reading RSSI value for a specific connection"},
+#if APP_RADIO_STATS
+ {"Radio stats", &Menu_doRadioStats, "RSSI, CRC errors and missed events of a specific connection"},
+#endif
  {"EnableNotification", &Menu_doEnableNotification, "Enable Notification for a specific connection"},
  {"DisableNotification", &Menu_doDisableNotification, "Disable Notification for a specific connection"}
 };
@@ -196,6 +208,12 @@ const MenuModule_Menu_t mainMenu[] =
 #if ( HOST_CONFIG & ( CENTRAL_CFG | PERIPHERAL_CFG ) )
  {"Connection", &Menu_connectionCB, "Connection menu"},
 #endif // #if ( HOST_CONFIG & ( CENTRAL_CFG | PERIPHERAL_CFG ) )
+#if APP_MEM_STATS
+ {"Memory stats", &Menu_memStatsCB, "Stack and heap watermarks since boot"},
+#endif
+#if APP_CRYPTO_PROF
+ {"Crypto profile", &Menu_cryptoProfCB, "Duration of the SHA2, ECDSA, TA010 and OOB operations"},
+#endif
 };
 
 MENU_MODULE_MENU_OBJECT("Basic BLE Menu", mainMenu);
@@ -418,12 +436,12 @@ void Menu_workWithCB(uint8 index)
         static char connAddrsses[MAX_NUM_BLE_CONNS][BLEAPPUTIL_ADDR_STR_SIZE] = {0};
         // Create a static menu that will contain the addresses
         static MenuModule_Menu_t connAddrList[MAX_NUM_BLE_CONNS];
-        // Get the list of connected devices
-        App_connInfo * currConnList = Connection_getConnList();
-        for(i = 0; i < numConns; i++)
+        // Get the contexts of the connected devices
+        App_connCtx *pCtx;
+        for(i = 0; i < numConns && (pCtx = Connection_getCtxByIndex(i)) != NULL; i++)
         {
             // Convert the addresses to strings
-            memcpy(connAddrsses[i], BLEAppUtil_convertBdAddr2Str(currConnList[i].peerAddress), BLEAPPUTIL_ADDR_STR_SIZE);
+            memcpy(connAddrsses[i], BLEAppUtil_convertBdAddr2Str(pCtx->peerAddress), BLEAPPUTIL_ADDR_STR_SIZE);
             connAddrList[i].itemName = connAddrsses[i];
             connAddrList[i].itemCallback = &Menu_selectedDeviceCB;
             connAddrList[i].itemHelp = "";
@@ -432,7 +450,7 @@ void Menu_workWithCB(uint8 index)
         // Create the menu object
         MENU_MODULE_MENU_OBJECT("Connected devices List", connAddrList);
         // Display the list
-        MenuModule_printStringList(&connAddrListObject, numConns);
+        MenuModule_printStringList(&connAddrListObject, i);
     }
 }
 
@@ -695,7 +713,7 @@ void Menu_doGattWriteCB(uint8 index)
 
     uint8_t charVals[4] = { 0x00, 0x02, 0x55, 0xFF };
 
-    req.pValue = GATT_bm_alloc(menuCurrentConnHandle, ATT_WRITE_REQ, 1, NULL); //1
+    req.pValue = MemStats_bmAlloc(menuCurrentConnHandle, ATT_WRITE_REQ, 1); //1
     req.len = 1; // 1
     charVal = charVals[index];
     req.pValue[0] = charVal;
@@ -774,13 +792,67 @@ void Menu_doRssiRead(uint8 index){
                           status);
 }
 
+#if APP_RADIO_STATS
+/*********************************************************************
+ * @fn      Menu_doRadioStats
+ *
+ * @brief   A callback that will be called once the Radio stats item
+ *          in the workWithMenu is selected.
+ *          Prints the radio statistics of menuCurrentConnHandle.
+ *
+ * @param   index - the index in the menu
+ *
+ * @return  none
+ */
+void Menu_doRadioStats(uint8 index)
+{
+    RadioStats_print(menuCurrentConnHandle);
+}
+#endif
+
+#if APP_MEM_STATS
+/*********************************************************************
+ * @fn      Menu_memStatsCB
+ *
+ * @brief   A callback that will be called once the Memory stats item
+ *          in the mainMenu is selected.
+ *          Prints the stack high water marks and heap watermarks.
+ *
+ * @param   index - the index in the menu
+ *
+ * @return  none
+ */
+void Menu_memStatsCB(uint8 index)
+{
+    MemStats_print();
+}
+#endif
+
+#if APP_CRYPTO_PROF
+/*********************************************************************
+ * @fn      Menu_cryptoProfCB
+ *
+ * @brief   A callback that will be called once the Crypto profile item
+ *          in the mainMenu is selected.
+ *          Prints the statistics of the crypto operations.
+ *
+ * @param   index - the index in the menu
+ *
+ * @return  none
+ */
+void Menu_cryptoProfCB(uint8 index)
+{
+    CryptoProf_print();
+}
+#endif
+
 void Menu_doEnableNotification(uint8 index)
 {
     bStatus_t status;
     attWriteReq_t req;
 
     uint8 configData[2] = {0x01,0x00};
-    req.pValue = GATT_bm_alloc(menuCurrentConnHandle, ATT_WRITE_REQ, 2, NULL);
+    req.pValue = MemStats_bmAlloc(menuCurrentConnHandle, ATT_WRITE_REQ, 2);
 
     // Enable notify for outgoing data
     if (req.pValue != NULL)
@@ -804,7 +876,7 @@ void Menu_doDisableNotification(uint8 index){
     attWriteReq_t req;
 
     uint8 configData[2] = {0x00,0x00};
-    req.pValue = GATT_bm_alloc(menuCurrentConnHandle, ATT_WRITE_REQ, 2, NULL);
+    req.pValue = MemStats_bmAlloc(menuCurrentConnHandle, ATT_WRITE_REQ, 2);
 
     // Enable notify for outgoing data
     if (req.pValue != NULL)
@@ -0,0 +1,130 @@
+/******************************************************************************
+
+@file  app_nonce_pool.h
+
+@brief This file contains the nonce pool definitions and prototypes
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef APP_NONCE_POOL_H_
+#define APP_NONCE_POOL_H_
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// The pool does not depend on the BLE stack: build it with NONCE_POOL_HOST
+// defined to run it on a PC, the random bytes then come from /dev/urandom.
+#define NONCE_POOL_NONCE_LEN    32
+// Number of nonces kept ready
+#ifndef NONCE_POOL_SIZE
+#define NONCE_POOL_SIZE         4
+#endif
+// Number of issued nonces remembered for the replay check (max 8)
+#ifndef NONCE_POOL_WINDOW_SIZE
+#define NONCE_POOL_WINDOW_SIZE  8
+#endif
+// The outstanding flags of the window are the bits of a uint8_t
+_Static_assert(NONCE_POOL_WINDOW_SIZE >= 1 && NONCE_POOL_WINDOW_SIZE <= 8, "NONCE_POOL_WINDOW_SIZE must be 1 to 8");
+// Take the nonces from the TA010 instead of the TRNG
+#ifndef NONCE_POOL_USE_TA010
+#define NONCE_POOL_USE_TA010    0
+#endif
+// Bytes of an issued nonce kept in the window
+#define NONCE_POOL_TAG_LEN      8
+
+// Status values
+#define NONCE_POOL_SUCCESS      0
+#define NONCE_POOL_ERROR        1
+#define NONCE_POOL_REPLAY       2
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      NoncePool_init
+ *
+ * @brief   Clear the replay window and fill the pool
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_init(void);
+
+/*********************************************************************
+ * @fn      NoncePool_fill
+ *
+ * @brief   Top up the pool from the random source. Meant to run
+ *          outside of the authentication messages.
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_fill(void);
+
+/*********************************************************************
+ * @fn      NoncePool_get
+ *
+ * @brief   Hand out a nonce and remember it in the replay window.
+ *          Falls back to the random source when the pool is empty.
+ *
+ * @param   nonce - buffer of NONCE_POOL_NONCE_LEN bytes
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_ERROR
+ */
+uint8_t NoncePool_get(uint8_t *nonce);
+
+/*********************************************************************
+ * @fn      NoncePool_consume
+ *
+ * @brief   Check that a nonce was issued by NoncePool_get and was not
+ *          used yet, then mark it as used.
+ *
+ * @param   nonce - nonce the peer answered to
+ *
+ * @return  NONCE_POOL_SUCCESS or NONCE_POOL_REPLAY
+ */
+uint8_t NoncePool_consume(const uint8_t *nonce);
+
+#endif /* APP_NONCE_POOL_H_ */
@@ -140,8 +140,6 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
             // The pairing is completed, so update the entry in connection list
             // to the ID address instead of the RP address
             linkDBInfo_t linkInfo;
-            // Get the list of connected devices
-            App_connInfo* connList = Connection_getConnList();
             if (linkDB_GetInfo(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle, &linkInfo) == SUCCESS)
             {
               // If the peer was using private address, update with ID address
@@ -150,14 +148,14 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                    !osal_isbufset(linkInfo.addrPriv, 0, B_ADDR_LEN))
               {
 
-                // Get the index of connection list by connHandle
-                uint8_t connIdx = Connection_getConnIndex(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle);
+                // Get the connection context by connHandle
+                App_connCtx *pCtx = Connection_getCtx(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle);
 
                 // Verify that there is a match of connection handle
-                if (connIdx != LL_INACTIVE_CONNECTIONS)
+                if (pCtx != NULL)
                 {
-                  // Update the connection list with the ID address
-                  memcpy(connList[connIdx].peerAddress, linkInfo.addr, B_ADDR_LEN);
+                  // Update the connection context with the ID address
+                  memcpy(pCtx->peerAddress, linkInfo.addr, B_ADDR_LEN);
                 }
               }
             }
@@ -181,6 +179,13 @@ void Pairing_pairStateHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
                               "status = "MENU_MODULE_COLOR_YELLOW "%d " MENU_MODULE_COLOR_RESET,
                               ((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle,
                               ((BLEAppUtil_PairStateData_t *)pMsgData)->status);
+#if APP_RECONNECT_POLICY
+            if(((BLEAppUtil_PairStateData_t *)pMsgData)->status == SUCCESS)
+            {
+                // Target this central with directed advertising after a disconnection
+                Peripheral_setReconnectPeer(((BLEAppUtil_PairStateData_t *)pMsgData)->connHandle);
+            }
+#endif
             break;
         }
 
@@ -67,16 +67,75 @@ Target Device: cc23xx
 //*****************************************************************************
 //! Includes
 //*****************************************************************************
+#include <string.h>
 #include "ti_ble_config.h"
 #include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
 #include <ti/bleapp/menu_module/menu_module.h>
 #include <app_main.h>
+#include <ti/bleapp/profiles/simple_gatt/simple_gatt_profile.h>
+#if APP_RECONNECT_POLICY
+#include <ti/drivers/dpl/ClockP.h>
+#endif
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#if APP_RECONNECT_POLICY
+// Stages of the reconnect advertising policy
+#define PERIPHERAL_ADV_STAGE_DIRECTED   0
+#define PERIPHERAL_ADV_STAGE_FAST       1
+#define PERIPHERAL_ADV_STAGE_SLOW       2
+#define PERIPHERAL_ADV_NUM_STAGES       3
+#define PERIPHERAL_ADV_STAGE_IDLE       0xFF
+
+// Radio on time estimate of an advertising event: one PDU on each of the
+// three primary channels, each followed by T_IFS and the listen window
+// for a SCAN_REQ/CONNECT_IND. PDU overhead is preamble, access address,
+// header, CRC and the 6 bytes AdvA, at 8 us per byte on the 1M PHY.
+#define PERIPHERAL_ADV_NUM_CHANNELS     3
+#define PERIPHERAL_ADV_PDU_OVERHEAD     (1 + 4 + 2 + 3 + B_ADDR_LEN)
+#define PERIPHERAL_ADV_US_PER_BYTE      8
+#define PERIPHERAL_ADV_RX_WINDOW_US     230
+// ADV_DIRECT_IND carries the 6 bytes TargetA instead of advertising data
+#define PERIPHERAL_ADV_DIRECT_PDU_LEN   (PERIPHERAL_ADV_PDU_OVERHEAD + B_ADDR_LEN)
+// Longest high duty cycle directed advertising event interval
+#define PERIPHERAL_ADV_HDC_INT_US       3750
+// Mean of the 0-10 ms advDelay added to each undirected advertising event
+#define PERIPHERAL_ADV_DELAY_US         5000
+// Advertising interval in 0.625 ms units to us
+#define PERIPHERAL_ADV_INT_TO_US(x)     ((x) * 625)
+#endif
 
 //*****************************************************************************
 //! Prototypes
 //*****************************************************************************
 void Peripheral_AdvEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
 void Peripheral_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData);
+#if APP_OOB_IN_ADV_DATA
+static uint8 Peripheral_buildOobAdData(uint8 *pBuf, uint8 adType, uint8 *pValue,
+                                       const uint8 *pSrc, uint8 srcLen);
+#endif
+#if APP_RECONNECT_POLICY
+static uint8 Peripheral_stageAdvHandle(uint8 stage);
+static bStatus_t Peripheral_setUndirectedInterval(uint32 interval);
+static bStatus_t Peripheral_startAdvStage(uint8 stage);
+static void Peripheral_endAdvStage(void);
+static void Peripheral_printReconnect(uint8 stage);
+#endif
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+#if APP_RECONNECT_POLICY
+// Statistics of a reconnect policy stage
+typedef struct
+{
+    uint32 timeMs;          // Time spent advertising in the stage
+    uint32 radioOnUs;       // Estimated radio on time of the stage
+    uint32 lastLatencyMs;   // Last disconnection to connection time
+    uint16 numConnects;     // Connections established in the stage
+} Peripheral_stageStats_t;
+#endif
 
 //*****************************************************************************
 //! Globals
@@ -96,11 +155,18 @@ BLEAppUtil_EventHandler_t peripheralAdvHandler =
     .handlerType    = BLEAPPUTIL_GAP_ADV_TYPE,
     .pEventHandler  = Peripheral_AdvEventHandler,
     .eventMask      = BLEAPPUTIL_ADV_START_AFTER_ENABLE |
-                      BLEAPPUTIL_ADV_END_AFTER_DISABLE
+                      BLEAPPUTIL_ADV_END_AFTER_DISABLE |
+                      BLEAPPUTIL_ADV_SET_TERMINATED
 };
 
 //! Store handle needed for each advertise set
 uint8 peripheralAdvHandle_1;
+#if APP_OOB_IN_ADV_DATA
+// The ECC keys can be ready before the advertise set exists, the OOB data
+// is then loaded by Peripheral_start
+static uint8 peripheralAdvSetReady = FALSE;
+static uint8 peripheralOobPending = FALSE;
+#endif
 
 //! Advertise param, needed for each advertise set, Generate by Sysconfig
 const BLEAppUtil_AdvInit_t advSetInitParamsSet_1 =
@@ -124,6 +190,81 @@ const BLEAppUtil_AdvStart_t advSetStartParamsSet_1 =
     .durationOrMaxEvents   = 0
 };
 
+#if APP_RECONNECT_POLICY
+//! Advertise set of the high duty cycle directed stage
+uint8 peripheralAdvHandle_2;
+
+// Directed legacy advertising carries no data. The peer address is set
+// before each start, once a bonded central is known.
+static GapAdv_params_t peripheralDirectedAdvParams =
+{
+    .eventProps   = GAP_ADV_PROP_CONNECTABLE | GAP_ADV_PROP_DIRECTED |
+                    GAP_ADV_PROP_HDC | GAP_ADV_PROP_LEGACY,
+    .primIntMin   = 160,
+    .primIntMax   = 160,
+    .primChanMap  = GAP_ADV_CHAN_ALL,
+    .peerAddrType = PEER_ADDRTYPE_PUBLIC_OR_PUBLIC_ID,
+    .peerAddr     = { 0 },
+    .filterPolicy = GAP_ADV_AL_POLICY_ANY_REQ,
+    .txPower      = GAP_ADV_TX_POWER_NO_PREFERENCE,
+    .primPhy      = GAP_ADV_PRIM_PHY_1_MBPS,
+    .secPhy       = GAP_ADV_SEC_PHY_1_MBPS,
+    .sid          = 1
+};
+
+static uint8 peripheralNoAdvData[1];
+
+const BLEAppUtil_AdvInit_t advSetInitParamsSet_2 =
+{
+    .advDataLen        = 0,
+    .advData           = peripheralNoAdvData,
+
+    .scanRespDataLen   = 0,
+    .scanRespData      = peripheralNoAdvData,
+
+    .advParam          = &peripheralDirectedAdvParams
+};
+
+const BLEAppUtil_AdvStart_t advSetStartParamsDirected =
+{
+    .enableOptions         = GAP_ADV_ENABLE_OPTIONS_USE_DURATION,
+    .durationOrMaxEvents   = APP_RECONNECT_DIRECTED_DURATION
+};
+
+const BLEAppUtil_AdvStart_t advSetStartParamsFast =
+{
+    .enableOptions         = GAP_ADV_ENABLE_OPTIONS_USE_DURATION,
+    .durationOrMaxEvents   = APP_RECONNECT_FAST_DURATION
+};
+
+// Last bonded central, the target of the directed stage
+static uint8 peripheralReconnectAddr[B_ADDR_LEN];
+static uint8 peripheralReconnectAddrType;
+static uint8 peripheralReconnectValid = FALSE;
+
+static uint8 peripheralAdvStage = PERIPHERAL_ADV_STAGE_IDLE;
+// Stage of the last advertise set terminated by a connection
+static uint8 peripheralConnectStage = PERIPHERAL_ADV_STAGE_IDLE;
+static uint32 peripheralStageStartTick;
+// Start of the current policy run, the disconnection time
+static uint32 peripheralPolicyStartTick;
+// Advertising data length of set 1, used by the radio on time estimate
+static uint8 peripheralAdvDataLen = sizeof(advData1);
+static Peripheral_stageStats_t peripheralStageStats[PERIPHERAL_ADV_NUM_STAGES];
+static const char *peripheralStageNames[PERIPHERAL_ADV_NUM_STAGES] =
+{
+    "directed", "fast", "slow"
+};
+#endif
+
+#if APP_OOB_IN_ADV_DATA
+// Advertising and scan response buffers holding the OOB values. They replace
+// advData1/scanResData1 once the local OOB data is available, and keep the
+// leading AD structures of the Sysconfig data that still fit.
+static uint8 peripheralOobAdvData[GAP_ADV_DATA_LEN_MAX];
+static uint8 peripheralOobScanRspData[GAP_ADV_DATA_LEN_MAX];
+#endif
+
 //*****************************************************************************
 //! Functions
 //*****************************************************************************
@@ -157,9 +298,36 @@ void Peripheral_AdvEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
             MenuModule_printf(APP_MENU_ADV_EVENT, 0, "Adv status: Ended - handle: "
                               MENU_MODULE_COLOR_YELLOW "%d" MENU_MODULE_COLOR_RESET,
                               ((BLEAppUtil_AdvEventData_t *)pMsgData)->pBuf->advHandle);
+#if APP_RECONNECT_POLICY
+            // The window of a stage expired, move to the next stage
+            if(peripheralAdvStage != PERIPHERAL_ADV_STAGE_IDLE &&
+               peripheralAdvStage != PERIPHERAL_ADV_STAGE_SLOW &&
+               ((BLEAppUtil_AdvEventData_t *)pMsgData)->pBuf->advHandle ==
+                   Peripheral_stageAdvHandle(peripheralAdvStage) &&
+               linkDB_NumActive() < linkDB_NumConns())
+            {
+                uint8 nextStage = peripheralAdvStage + 1;
+
+                Peripheral_endAdvStage();
+                Peripheral_startAdvStage(nextStage);
+            }
+#endif
             break;
         }
 
+#if APP_RECONNECT_POLICY
+        case BLEAPPUTIL_ADV_SET_TERMINATED:
+        {
+            // A central connected to the advertise set of the current stage
+            if(peripheralAdvStage != PERIPHERAL_ADV_STAGE_IDLE)
+            {
+                peripheralConnectStage = peripheralAdvStage;
+                Peripheral_endAdvStage();
+            }
+            break;
+        }
+#endif
+
         default:
         {
             break;
@@ -185,33 +353,414 @@ void Peripheral_GAPConnEventHandler(uint32 event, BLEAppUtil_msgHdr_t *pMsgData)
     {
         case BLEAPPUTIL_LINK_ESTABLISHED_EVENT:
         {
+#if APP_RECONNECT_POLICY
+            if(((gapEstLinkReqEvent_t *)pMsgData)->hdr.status != SUCCESS)
+            {
+                break;
+            }
+
+            // The set terminated event was not received, the connection
+            // belongs to the stage that was advertising
+            if(peripheralConnectStage == PERIPHERAL_ADV_STAGE_IDLE)
+            {
+                peripheralConnectStage = peripheralAdvStage;
+            }
+            if(peripheralAdvStage != PERIPHERAL_ADV_STAGE_IDLE)
+            {
+                Peripheral_endAdvStage();
+            }
+            if(peripheralConnectStage != PERIPHERAL_ADV_STAGE_IDLE)
+            {
+                Peripheral_printReconnect(peripheralConnectStage);
+                peripheralConnectStage = PERIPHERAL_ADV_STAGE_IDLE;
+            }
+#endif
             /* Check if we reach the maximum allowed number of connections */
             if(linkDB_NumActive() < linkDB_NumConns())
             {
                 /* Start advertising since there is room for more connections */
+#if APP_RECONNECT_POLICY
+                peripheralPolicyStartTick = ClockP_getSystemTicks();
+                Peripheral_startAdvStage(PERIPHERAL_ADV_STAGE_SLOW);
+#else
                 BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsSet_1);
+#endif
             }
             else
             {
                 /* Stop advertising since there is no room for more connections */
                 BLEAppUtil_advStop(peripheralAdvHandle_1);
+#if APP_RECONNECT_POLICY
+                BLEAppUtil_advStop(peripheralAdvHandle_2);
+#endif
             }
             break;
         }
 
         case BLEAPPUTIL_LINK_TERMINATED_EVENT:
         {
+#if APP_OOB_IN_ADV_DATA
+            // Never advertise the OOB data of a finished pairing attempt again
+            Peripheral_updateOobAdvData();
+#endif
+#if APP_RECONNECT_POLICY
+            // Run the policy from the directed stage. A stage that still
+            // advertises for more connections is left running.
+            if(peripheralAdvStage == PERIPHERAL_ADV_STAGE_IDLE)
+            {
+                peripheralPolicyStartTick = ClockP_getSystemTicks();
+                Peripheral_startAdvStage(PERIPHERAL_ADV_STAGE_DIRECTED);
+            }
+#else
             BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsSet_1);
+#endif
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+#if APP_OOB_IN_ADV_DATA
+/*********************************************************************
+ * @fn      Peripheral_buildOobAdData
+ *
+ * @brief   Build an advertising payload that starts with a 16 bytes
+ *          OOB AD structure, followed by the AD structures of pSrc
+ *          that still fit in a legacy advertising PDU.
+ *
+ * @param   pBuf - buffer of GAP_ADV_DATA_LEN_MAX bytes to fill
+ * @param   adType - AD type of the OOB value
+ * @param   pValue - 16 bytes OOB value
+ * @param   pSrc - original advertising data
+ * @param   srcLen - length of the original advertising data
+ *
+ * @return  length of the data written to pBuf
+ */
+static uint8 Peripheral_buildOobAdData(uint8 *pBuf, uint8 adType, uint8 *pValue,
+                                       const uint8 *pSrc, uint8 srcLen)
+{
+    uint8 len = 0;
+    uint8 i = 0;
+
+    pBuf[len++] = KEYLEN + 1;
+    pBuf[len++] = adType;
+    memcpy(&pBuf[len], pValue, KEYLEN);
+    len += KEYLEN;
+
+    // Copy the original AD structures as long as they fit
+    while (i < srcLen && pSrc[i] != 0)
+    {
+        uint8 adLen = pSrc[i] + 1;
+
+        if (i + adLen > srcLen || len + adLen > GAP_ADV_DATA_LEN_MAX)
+        {
+            break;
+        }
+        memcpy(&pBuf[len], &pSrc[i], adLen);
+        len += adLen;
+        i += adLen;
+    }
+
+    return len;
+}
+
+/*********************************************************************
+ * @fn      Peripheral_updateOobAdvData
+ *
+ * @brief   Generate new local OOB data, store it in Characteristic 1
+ *          and load the confirm/random values into the advertising
+ *          and scan response data of the advertise set. Before the
+ *          advertise set exists, only mark the data to be loaded by
+ *          Peripheral_start.
+ *
+ * @return  SUCCESS, bleNotReady before the advertise set exists,
+ *          errorInfo
+ */
+bStatus_t Peripheral_updateOobAdvData(void)
+{
+    bStatus_t status;
+    uint8 advLen;
+    uint8 scanRspLen;
+    uint8_t charValue1[SIMPLEGATTPROFILE_CHAR1_LEN] = {0};
+
+    if(!peripheralAdvSetReady)
+    {
+        peripheralOobPending = TRUE;
+        return(bleNotReady);
+    }
+    peripheralOobPending = FALSE;
+
+    status = CryptoProf_getLocalOob(&localOobData);
+    if(status != SUCCESS)
+    {
+        return(status);
+    }
+
+    // Keep Characteristic 1 in sync for centrals that still read it
+    memcpy(charValue1, localOobData.confirm, KEYLEN);
+    memcpy(charValue1 + KEYLEN, localOobData.rand, KEYLEN);
+    SimpleGattProfile_setParameter( SIMPLEGATTPROFILE_CHAR1, SIMPLEGATTPROFILE_CHAR1_LEN,
+                                    charValue1 );
+
+    advLen = Peripheral_buildOobAdData(peripheralOobAdvData, APP_ADTYPE_SC_CONFIRM_VALUE,
+                                       localOobData.confirm, advData1, sizeof(advData1));
+    scanRspLen = Peripheral_buildOobAdData(peripheralOobScanRspData, APP_ADTYPE_SC_RANDOM_VALUE,
+                                           localOobData.rand, scanResData1, sizeof(scanResData1));
+#if APP_RECONNECT_POLICY
+    peripheralAdvDataLen = advLen;
+#endif
+
+    // The Sysconfig buffers are static, the stack must not free them
+    status = GapAdv_prepareLoadByHandle(peripheralAdvHandle_1, GAP_ADV_FREE_OPTION_DONT_FREE);
+    if(status == SUCCESS)
+    {
+        status = GapAdv_loadByHandle(peripheralAdvHandle_1, GAP_ADV_DATA_TYPE_ADV,
+                                     advLen, peripheralOobAdvData);
+    }
+
+    if(status == SUCCESS)
+    {
+        status = GapAdv_prepareLoadByHandle(peripheralAdvHandle_1, GAP_ADV_FREE_OPTION_DONT_FREE);
+    }
+    if(status == SUCCESS)
+    {
+        status = GapAdv_loadByHandle(peripheralAdvHandle_1, GAP_ADV_DATA_TYPE_SCAN_RSP,
+                                     scanRspLen, peripheralOobScanRspData);
+    }
+
+    MenuModule_printf(APP_MENU_ADV_EVENT, 0, "Adv status: OOB data loaded - status: "
+                      MENU_MODULE_COLOR_YELLOW "%d" MENU_MODULE_COLOR_RESET,
+                      status);
+
+    return(status);
+}
+#endif // APP_OOB_IN_ADV_DATA
+
+#if APP_RECONNECT_POLICY
+/*********************************************************************
+ * @fn      Peripheral_stageAdvHandle
+ *
+ * @brief   Get the advertise set used by a reconnect policy stage.
+ *
+ * @param   stage - PERIPHERAL_ADV_STAGE_DIRECTED/FAST/SLOW
+ *
+ * @return  advertise handle
+ */
+static uint8 Peripheral_stageAdvHandle(uint8 stage)
+{
+    return (stage == PERIPHERAL_ADV_STAGE_DIRECTED) ? peripheralAdvHandle_2 :
+                                                      peripheralAdvHandle_1;
+}
+
+/*********************************************************************
+ * @fn      Peripheral_setUndirectedInterval
+ *
+ * @brief   Set the advertising interval of the undirected set.
+ *          Advertising must be disabled.
+ *
+ * @param   interval - interval in 0.625 ms units
+ *
+ * @return  SUCCESS, errorInfo
+ */
+static bStatus_t Peripheral_setUndirectedInterval(uint32 interval)
+{
+    bStatus_t status;
+
+    status = GapAdv_setParam(peripheralAdvHandle_1, GAP_ADV_PARAM_PRIMARY_INTERVAL_MIN,
+                             &interval);
+    if(status == SUCCESS)
+    {
+        status = GapAdv_setParam(peripheralAdvHandle_1, GAP_ADV_PARAM_PRIMARY_INTERVAL_MAX,
+                                 &interval);
+    }
+
+    return(status);
+}
+
+/*********************************************************************
+ * @fn      Peripheral_startAdvStage
+ *
+ * @brief   Start a stage of the reconnect policy. The directed stage
+ *          is skipped while no bonded central is known, and a stage
+ *          with a zero duration is skipped.
+ *
+ * @param   stage - PERIPHERAL_ADV_STAGE_DIRECTED/FAST/SLOW
+ *
+ * @return  SUCCESS, errorInfo
+ */
+static bStatus_t Peripheral_startAdvStage(uint8 stage)
+{
+    bStatus_t status = SUCCESS;
+
+    if(stage == PERIPHERAL_ADV_STAGE_DIRECTED &&
+       (!peripheralReconnectValid || APP_RECONNECT_DIRECTED_DURATION == 0))
+    {
+        stage = PERIPHERAL_ADV_STAGE_FAST;
+    }
+    if(stage == PERIPHERAL_ADV_STAGE_FAST && APP_RECONNECT_FAST_DURATION == 0)
+    {
+        stage = PERIPHERAL_ADV_STAGE_SLOW;
+    }
+
+    switch(stage)
+    {
+        case PERIPHERAL_ADV_STAGE_DIRECTED:
+        {
+            status = GapAdv_setParam(peripheralAdvHandle_2, GAP_ADV_PARAM_PEER_ADDRESS_TYPE,
+                                     &peripheralReconnectAddrType);
+            if(status == SUCCESS)
+            {
+                status = GapAdv_setParam(peripheralAdvHandle_2, GAP_ADV_PARAM_PEER_ADDRESS,
+                                         peripheralReconnectAddr);
+            }
+            if(status == SUCCESS)
+            {
+                status = BLEAppUtil_advStart(peripheralAdvHandle_2, &advSetStartParamsDirected);
+            }
+            break;
+        }
+
+        case PERIPHERAL_ADV_STAGE_FAST:
+        {
+            status = Peripheral_setUndirectedInterval(APP_RECONNECT_FAST_INT);
+            if(status == SUCCESS)
+            {
+                status = BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsFast);
+            }
             break;
         }
 
         default:
         {
+            stage = PERIPHERAL_ADV_STAGE_SLOW;
+            status = Peripheral_setUndirectedInterval(APP_RECONNECT_SLOW_INT ?
+                                                      APP_RECONNECT_SLOW_INT :
+                                                      advParams1.primIntMax);
+            if(status == SUCCESS)
+            {
+                status = BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsSet_1);
+            }
             break;
         }
     }
+
+    if(status == SUCCESS)
+    {
+        peripheralAdvStage = stage;
+        peripheralStageStartTick = ClockP_getSystemTicks();
+    }
+    else if(stage != PERIPHERAL_ADV_STAGE_SLOW)
+    {
+        // Never stay silent, fall back to the next stage
+        status = Peripheral_startAdvStage(stage + 1);
+    }
+
+    return(status);
+}
+
+/*********************************************************************
+ * @fn      Peripheral_endAdvStage
+ *
+ * @brief   Account the time and estimated radio on time of the
+ *          current stage and mark the policy idle.
+ *
+ * @return  none
+ */
+static void Peripheral_endAdvStage(void)
+{
+    Peripheral_stageStats_t *pStats = &peripheralStageStats[peripheralAdvStage];
+    uint32 elapsedUs = (ClockP_getSystemTicks() - peripheralStageStartTick) *
+                       ClockP_getSystemTickPeriod();
+    uint32 eventUs;
+    uint32 pduLen;
+
+    if(peripheralAdvStage == PERIPHERAL_ADV_STAGE_DIRECTED)
+    {
+        eventUs = PERIPHERAL_ADV_HDC_INT_US;
+        pduLen = PERIPHERAL_ADV_DIRECT_PDU_LEN;
+    }
+    else
+    {
+        uint32 interval = (peripheralAdvStage == PERIPHERAL_ADV_STAGE_FAST) ?
+                          APP_RECONNECT_FAST_INT :
+                          (APP_RECONNECT_SLOW_INT ? APP_RECONNECT_SLOW_INT :
+                                                    advParams1.primIntMax);
+
+        eventUs = PERIPHERAL_ADV_INT_TO_US(interval) + PERIPHERAL_ADV_DELAY_US;
+        pduLen = PERIPHERAL_ADV_PDU_OVERHEAD + peripheralAdvDataLen;
+    }
+
+    pStats->timeMs += elapsedUs / 1000;
+    pStats->radioOnUs += (elapsedUs / eventUs) * PERIPHERAL_ADV_NUM_CHANNELS *
+                         (pduLen * PERIPHERAL_ADV_US_PER_BYTE + PERIPHERAL_ADV_RX_WINDOW_US);
+
+    peripheralAdvStage = PERIPHERAL_ADV_STAGE_IDLE;
 }
 
+/*********************************************************************
+ * @fn      Peripheral_printReconnect
+ *
+ * @brief   Record the reconnect latency of the stage a central
+ *          connected in, and print the per stage statistics.
+ *
+ * @param   stage - stage the central connected in
+ *
+ * @return  none
+ */
+static void Peripheral_printReconnect(uint8 stage)
+{
+    Peripheral_stageStats_t *pStats = &peripheralStageStats[stage];
+
+    pStats->lastLatencyMs = ((ClockP_getSystemTicks() - peripheralPolicyStartTick) *
+                             ClockP_getSystemTickPeriod()) / 1000;
+    pStats->numConnects++;
+
+    MenuModule_printf(APP_MENU_ADV_EVENT, 0, "Adv status: Connected in %s stage after "
+                      MENU_MODULE_COLOR_YELLOW "%u ms" MENU_MODULE_COLOR_RESET
+                      " - radio on ms: directed %u/%u fast %u/%u slow %u/%u",
+                      peripheralStageNames[stage], pStats->lastLatencyMs,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_DIRECTED].radioOnUs / 1000,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_DIRECTED].timeMs,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_FAST].radioOnUs / 1000,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_FAST].timeMs,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_SLOW].radioOnUs / 1000,
+                      peripheralStageStats[PERIPHERAL_ADV_STAGE_SLOW].timeMs);
+}
+
+/*********************************************************************
+ * @fn      Peripheral_setReconnectPeer
+ *
+ * @brief   Remember the bonded central of a link as the target of the
+ *          directed advertising stage of the reconnect policy.
+ *
+ * @param   connHandle - connection handle of the bonded central
+ *
+ * @return  SUCCESS, errorInfo
+ */
+bStatus_t Peripheral_setReconnectPeer(uint16_t connHandle)
+{
+    linkDBInfo_t linkInfo;
+    bStatus_t status;
+
+    status = linkDB_GetInfo(connHandle, &linkInfo);
+    if(status == SUCCESS)
+    {
+        memcpy(peripheralReconnectAddr, linkInfo.addr, B_ADDR_LEN);
+        // Public/random, identity addresses map to the same peer type
+        peripheralReconnectAddrType = (linkInfo.addrType & ADDRTYPE_RANDOM) ?
+                                      PEER_ADDRTYPE_RANDOM_OR_RANDOM_ID :
+                                      PEER_ADDRTYPE_PUBLIC_OR_PUBLIC_ID;
+        peripheralReconnectValid = TRUE;
+    }
+
+    return(status);
+}
+#endif // APP_RECONNECT_POLICY
+
 /*********************************************************************
  * @fn      Peripheral_start
  *
@@ -246,7 +795,28 @@ bStatus_t Peripheral_start()
         return(status);
     }
 
+#if APP_OOB_IN_ADV_DATA
+    // Advertise the OOB data from the start if the ECC keys are ready
+    peripheralAdvSetReady = TRUE;
+    if(peripheralOobPending)
+    {
+        Peripheral_updateOobAdvData();
+    }
+#endif
+
+#if APP_RECONNECT_POLICY
+    status = BLEAppUtil_initAdvSet(&peripheralAdvHandle_2, &advSetInitParamsSet_2);
+    if(status != SUCCESS)
+    {
+        return(status);
+    }
+
+    // No central is bonded yet, the policy starts with the fast stage
+    peripheralPolicyStartTick = ClockP_getSystemTicks();
+    status = Peripheral_startAdvStage(PERIPHERAL_ADV_STAGE_DIRECTED);
+#else
     status = BLEAppUtil_advStart(peripheralAdvHandle_1, &advSetStartParamsSet_1);
+#endif
     if(status != SUCCESS)
     {
         // Return status value
@@ -0,0 +1,400 @@
+/******************************************************************************
+
+@file  app_ta010.c
+
+@brief This file contains the TA010 HSM command functionality
+
+Group: WCS, BTS
+Target Device: cc23xx
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/bleapp/ble_app_util/inc/bleapputil_api.h>
+#include <app_main.h>
+
+#include <ti/drivers/RNG.h>
+#include <ti/drivers/ECDSA.h>
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define RNG_INSTANCE   0
+#define ECDSA_INSTANCE 0
+
+#if !TA010_EMULATED
+// The I2C transport (wake, CRC-16 framing, command execution times) is part
+// of the MPLAB project and not ported yet. Once it is, the Sign task waits
+// on the TA010 and must take priority 2, above the BLEAppUtil task (1).
+#error "The TA010 I2C transport is not part of this project, build with TA010_EMULATED 1"
+#endif
+
+// The emulated Sign computes on the CPU, so it only takes the time the
+// BLEAppUtil task (1) leaves idle, e.g. while the next certificate is on
+// the air, instead of preempting the verifications
+#define TA010_SIGN_TASK_PRIORITY    0
+#define TA010_SIGN_TASK_STACK_SIZE  512
+
+typedef enum
+{
+    TA010_SIGN_IDLE,
+    TA010_SIGN_BUSY,
+    TA010_SIGN_BUSY_DISCARD,
+    TA010_SIGN_BUSY_QUEUED,     // Discarded command running, the next one waits
+    TA010_SIGN_READY
+}Ta010_signStates;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static void Ta010_signTask(void *pvParameters);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+
+#if TA010_TEST_KEY
+/*
+ * The TA010 keeps the device private key in slot 0 and never gives it out.
+ * The emulated Sign of a test build uses the private key of the built-in
+ * device certificate instead, so its signatures verify like the TA010 ones.
+ * Anyone who has this file has the key: see TA010_TEST_KEY.
+ */
+static const uint8_t ta010TestPrivateKey[32] = {0x31, 0xE8, 0xEA, 0xAC, 0x81, 0x44, 0xF8, 0x51, 0xDD, 0xE8,
+                                                0x64, 0x21, 0xCD, 0xFA, 0x97, 0x05, 0x34, 0x6D, 0x27, 0xA9,
+                                                0x0C, 0xF9, 0x24, 0x1D, 0x9D, 0xE5, 0x8C, 0xCE, 0x2A, 0xB5,
+                                                0x2D, 0xC5};
+// Its public key X || Y, the one of the built-in device certificate
+static const uint8_t ta010TestPublicKey[CERT_PUBLIC_KEY_LEN] = {0xBB, 0x12, 0xBF, 0xEF, 0x48, 0xE8, 0xAC, 0x5E, 0x54, 0x07, 0x90,
+                                                                0xA9, 0x58, 0xD0, 0x99, 0xC4, 0xA7, 0xEF, 0x31, 0x58, 0xD4, 0xBD,
+                                                                0xAF, 0x3A, 0x86, 0x8C, 0x33, 0x96, 0x1D, 0x73, 0x45, 0x90,
+                                                                0x74, 0xC2, 0xC9, 0x63, 0xB4, 0xA0, 0xE2, 0xDC, 0xF6, 0x96, 0x02,
+                                                                0xBA, 0xDF, 0xFC, 0x8E, 0x5D, 0x40, 0x7A, 0xEF, 0x61, 0xEE, 0x98,
+                                                                0x61, 0xFB, 0xB1, 0x2A, 0x9C, 0x46, 0xA9, 0x99, 0x50, 0x46};
+#endif
+
+static TaskHandle_t ta010SignTaskHandle = NULL;
+static SemaphoreHandle_t ta010SignSem = NULL;
+static volatile uint8_t ta010SignState = TA010_SIGN_IDLE;
+static bStatus_t ta010SignStatus;
+static uint8_t ta010SignDigest[32];
+static uint8_t ta010SignResult[64];
+static InvokeFromBLEAppUtilContext_t ta010SignDoneCB = NULL;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      Ta010_nonce
+ *
+ * @brief   Execute the TA010 Nonce command and get a 32 bytes
+ *          random number.
+ *
+ * @param   nonce - buffer of APP_NONCE_LEN bytes for the random number
+ *
+ * @return  SUCCESS or FAILURE
+ */
+bStatus_t Ta010_nonce(uint8_t *nonce)
+{
+    RNG_Handle handle;
+    int_fast16_t result;
+#if APP_CRYPTO_PROF
+    uint32_t start;
+#endif
+
+    RNG_init();
+    handle = RNG_open(RNG_INSTANCE, NULL);
+    if (handle == NULL)
+    {
+        return FAILURE;
+    }
+
+#if APP_CRYPTO_PROF
+    start = CryptoProf_start();
+#endif
+    result = RNG_getRandomBits(handle, nonce, APP_NONCE_LEN * 8);
+#if APP_CRYPTO_PROF
+    CryptoProf_stop(CRYPTO_PROF_TA010_NONCE, start);
+#endif
+    RNG_close(handle);
+
+    return (result == RNG_STATUS_SUCCESS) ? SUCCESS : FAILURE;
+}
+
+/*********************************************************************
+ * @fn      Ta010_sign
+ *
+ * @brief   Execute the TA010 Sign command over a 32 bytes message
+ *          digest with the private key of slot 0.
+ *
+ * @param   digest - 32 bytes SHA256 digest to sign
+ * @param   signature - buffer of 64 bytes for the signature r + s
+ *
+ * @return  SUCCESS, or FAILURE also when the image has no key, see
+ *          TA010_TEST_KEY
+ */
+bStatus_t Ta010_sign(uint8_t *digest, uint8_t *signature)
+{
+#if TA010_TEST_KEY
+    CryptoKey privateKey;
+    ECDSA_Handle ecdsaHandle;
+    ECDSA_OperationSign operationSign;
+    int_fast16_t signResult;
+#if APP_CRYPTO_PROF
+    uint32_t start;
+#endif
+
+    // Shared with the verifications of the BLEAppUtil task
+    CryptoCtx_lockEcdsa();
+    ECDSA_init();
+    ecdsaHandle = ECDSA_open(ECDSA_INSTANCE, NULL);
+    if (ecdsaHandle == NULL)
+    {
+        CryptoCtx_unlockEcdsa();
+        return FAILURE;
+    }
+
+    CryptoKeyPlaintext_initKey(&privateKey,
+                               (uint8_t *)ta010TestPrivateKey,
+                               sizeof(ta010TestPrivateKey));
+
+    ECDSA_OperationSign_init(&operationSign);
+    operationSign.curve         = &ECCParams_NISTP256;
+    operationSign.myPrivateKey  = &privateKey;
+    operationSign.hash          = digest;
+    operationSign.r             = signature;
+    operationSign.s             = signature + 32;
+
+#if APP_CRYPTO_PROF
+    start = CryptoProf_start();
+#endif
+    signResult = ECDSA_sign(ecdsaHandle, &operationSign);
+#if APP_CRYPTO_PROF
+    CryptoProf_stop(CRYPTO_PROF_TA010_SIGN, start);
+#endif
+    ECDSA_close(ecdsaHandle);
+    CryptoCtx_unlockEcdsa();
+
+    return (signResult == ECDSA_STATUS_SUCCESS) ? SUCCESS : FAILURE;
+#else
+    return FAILURE;
+#endif
+}
+
+/*********************************************************************
+ * @fn      Ta010_getPublicKey
+ *
+ * @brief   Execute the TA010 GenKey command: get the public key of
+ *          the private key of slot 0, the one Ta010_sign uses.
+ *
+ * @param   publicKey - buffer of CERT_PUBLIC_KEY_LEN bytes for X || Y
+ *
+ * @return  SUCCESS, or FAILURE also when the image has no key, see
+ *          TA010_TEST_KEY
+ */
+bStatus_t Ta010_getPublicKey(uint8_t *publicKey)
+{
+#if TA010_TEST_KEY
+    memcpy(publicKey, ta010TestPublicKey, sizeof(ta010TestPublicKey));
+    return SUCCESS;
+#else
+    return FAILURE;
+#endif
+}
+
+/*********************************************************************
+ * @fn      Ta010_signAsync
+ *
+ * @brief   Start the TA010 Sign command in the Sign task and return
+ *          right away. doneCB is called in the BLEAppUtil context
+ *          once Ta010_getSignResult can be used. A command whose
+ *          result was discarded cannot be stopped, the new one then
+ *          starts as soon as it completed.
+ *
+ * @param   digest - 32 bytes SHA256 digest to sign
+ * @param   doneCB - called when the command completed
+ *
+ * @return  SUCCESS, or FAILURE if a Sign command is running for an
+ *          earlier call
+ */
+bStatus_t Ta010_signAsync(uint8_t *digest, InvokeFromBLEAppUtilContext_t doneCB)
+{
+    uint8_t queued;
+
+    if (ta010SignTaskHandle == NULL)
+    {
+        ta010SignSem = xSemaphoreCreateBinary();
+        if (ta010SignSem == NULL ||
+            xTaskCreate(Ta010_signTask, "Ta010Sign", TA010_SIGN_TASK_STACK_SIZE, NULL,
+                        TA010_SIGN_TASK_PRIORITY, &ta010SignTaskHandle) != pdPASS)
+        {
+            return FAILURE;
+        }
+#if APP_MEM_STATS
+        MemStats_addTask(ta010SignTaskHandle, TA010_SIGN_TASK_STACK_SIZE * sizeof(StackType_t));
+#endif
+    }
+
+    // The Sign task takes the request as soon as it sees the state
+    taskENTER_CRITICAL();
+    if (ta010SignState == TA010_SIGN_BUSY || ta010SignState == TA010_SIGN_BUSY_QUEUED)
+    {
+        taskEXIT_CRITICAL();
+        return FAILURE;
+    }
+    queued = (ta010SignState == TA010_SIGN_BUSY_DISCARD);
+    ta010SignState = queued ? TA010_SIGN_BUSY_QUEUED : TA010_SIGN_BUSY;
+    memcpy(ta010SignDigest, digest, sizeof(ta010SignDigest));
+    ta010SignDoneCB = doneCB;
+    taskEXIT_CRITICAL();
+
+    if (!queued)
+    {
+        xSemaphoreGive(ta010SignSem);
+    }
+
+    return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      Ta010_getSignResult
+ *
+ * @brief   Take the signature of the last Ta010_signAsync call
+ *
+ * @param   signature - buffer of 64 bytes for r + s
+ *
+ * @return  SUCCESS if a signature was ready, FAILURE otherwise
+ */
+bStatus_t Ta010_getSignResult(uint8_t *signature)
+{
+    bStatus_t status = FAILURE;
+
+    taskENTER_CRITICAL();
+    if (ta010SignState == TA010_SIGN_READY)
+    {
+        ta010SignState = TA010_SIGN_IDLE;
+        status = ta010SignStatus;
+    }
+    taskEXIT_CRITICAL();
+
+    if (status == SUCCESS)
+    {
+        memcpy(signature, ta010SignResult, sizeof(ta010SignResult));
+    }
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      Ta010_discardSign
+ *
+ * @brief   Drop the result of the running or completed Sign command,
+ *          e.g. when the link it was meant for is gone.
+ *
+ * @return  none
+ */
+void Ta010_discardSign(void)
+{
+    taskENTER_CRITICAL();
+    if (ta010SignState == TA010_SIGN_BUSY || ta010SignState == TA010_SIGN_BUSY_QUEUED)
+    {
+        ta010SignState = TA010_SIGN_BUSY_DISCARD;
+    }
+    else if (ta010SignState == TA010_SIGN_READY)
+    {
+        ta010SignState = TA010_SIGN_IDLE;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*********************************************************************
+ * @fn      Ta010_signTask
+ *
+ * @brief   Runs the Sign commands outside of the BLEAppUtil task, so
+ *          the application keeps verifying while the TA010 signs.
+ *          The emulated Sign only fills the idle time of the
+ *          application, see TA010_EMULATED.
+ *
+ * @param   pvParameters - unused
+ *
+ * @return  none
+ */
+static void Ta010_signTask(void *pvParameters)
+{
+    uint8_t digest[32];
+    InvokeFromBLEAppUtilContext_t doneCB;
+    uint8_t state;
+
+    for (;;)
+    {
+        xSemaphoreTake(ta010SignSem, portMAX_DELAY);
+
+        do
+        {
+            // Ta010_signAsync may queue the next request while this one runs
+            taskENTER_CRITICAL();
+            memcpy(digest, ta010SignDigest, sizeof(digest));
+            doneCB = ta010SignDoneCB;
+            taskEXIT_CRITICAL();
+
+            ta010SignStatus = Ta010_sign(digest, ta010SignResult);
+
+            taskENTER_CRITICAL();
+            state = ta010SignState;
+            if (state == TA010_SIGN_BUSY_QUEUED)
+            {
+                ta010SignState = TA010_SIGN_BUSY;
+            }
+            else
+            {
+                ta010SignState = (state == TA010_SIGN_BUSY_DISCARD) ? TA010_SIGN_IDLE : TA010_SIGN_READY;
+            }
+            taskEXIT_CRITICAL();
+
+            if (state == TA010_SIGN_BUSY && doneCB != NULL)
+            {
+                BLEAppUtil_invokeFunctionNoData(doneCB);
+            }
+        } while (state == TA010_SIGN_BUSY_QUEUED);
+    }
+}
@@ -67,6 +67,8 @@ extern "C"
 #define SIMPLEGATTPROFILE_CHAR4                   3  // RW uint8 - Profile Characteristic 4 value
 #define SIMPLEGATTPROFILE_CHAR5                   4  // RW uint8 - Profile Characteristic 4 value
 #define SIMPLEGATTPROFILE_CHAR6                   5  // RW uint8 - Profile Characteristic 4 value
+#define SIMPLEGATTPROFILE_CHAR7                   6  // R - Radio statistics of the reading link
+#define SIMPLEGATTPROFILE_CHAR8                   7  // R - Stack and heap watermarks
 
 // Simple Profile Service UUID
 #define SIMPLEGATTPROFILE_SERV_UUID               0xFFF0
@@ -78,6 +80,8 @@ extern "C"
 #define SIMPLEGATTPROFILE_CHAR4_UUID            0xFFF4
 #define SIMPLEGATTPROFILE_CHAR5_UUID            0xFFF5
 #define SIMPLEGATTPROFILE_CHAR6_UUID            0xFFF6
+#define SIMPLEGATTPROFILE_CHAR7_UUID            0xFFF7
+#define SIMPLEGATTPROFILE_CHAR8_UUID            0xFFF8
 
 // Simple Keys Profile Services bit fields
 #define SIMPLEGATTPROFILE_SERVICE               0x00000001
@@ -86,7 +90,8 @@ extern "C"
 #define SIMPLEGATTPROFILE_CHAR1_LEN           32
 
 // Length of Characteristic 2 in bytes
-#define SIMPLEGATTPROFILE_CHAR2_LEN           137
+// Large enough for a mutual authentication HELLO (id + certificate + nonce)
+#define SIMPLEGATTPROFILE_CHAR2_LEN           170
 
 // Length of Characteristic 3 in bytes
 #define SIMPLEGATTPROFILE_CHAR3_LEN           137
@@ -100,6 +105,12 @@ extern "C"
 // Length of Characteristic 6 in bytes
 #define SIMPLEGATTPROFILE_CHAR6_LEN           65
 
+// Length of Characteristic 7 in bytes, RADIO_STATS_SERIAL_LEN
+#define SIMPLEGATTPROFILE_CHAR7_LEN           19
+
+// Length of Characteristic 8 in bytes, MEM_STATS_SERIAL_LEN
+#define SIMPLEGATTPROFILE_CHAR8_LEN           22
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -111,8 +122,9 @@ extern "C"
 /*********************************************************************
  * Profile Callbacks
  */
-// Callback when a characteristic value has changed
-typedef void (*pfnSimpleGattProfile_Change_t)( uint8 paramID );
+// Callback when a characteristic value has changed, with the connection
+// it was written on
+typedef void (*pfnSimpleGattProfile_Change_t)( uint16 connHandle, uint8 paramID );
 
 typedef struct
 {
@@ -176,6 +188,19 @@ bStatus_t myGattProfile_setParameter( uint8 param, uint8 len, void *value );
  */
 bStatus_t SimpleGattProfile_getParameter( uint8 param, void *value );
 
+/*
+ * @fn      SimpleGattProfile_getValue
+ *
+ * @brief   Get a Simple GATT Profile characteristic value in place,
+ *          without copying it.
+ *
+ * @param   param - Profile parameter ID
+ * @param   pLen - length of the last value written, may be NULL
+ *
+ * @return  the value, or NULL for an unknown parameter ID
+ */
+const uint8 *SimpleGattProfile_getValue( uint8 param, uint16 *pLen );
+
 /*********************************************************************
 *********************************************************************/
 
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+Build a certificate bundle image for the NVS_SLOT banks of app_cert_store.c.
+
+Layout, little endian, offsets from the start of the bundle:
+
+    header      magic "CBND" (u32), version (u8), count (u8), len (u16),
+                generation (u32), crc (u32)                     16 bytes
+    index       cert id (u8), reserved (u8), offset (u16),
+                fingerprint SHA-256 of the certificate          36 bytes each
+    certs       137 bytes each
+
+The CRC-32 (zlib.crc32) covers the bytes after the header. The device uses
+the valid bank with the highest generation. The bundle is not signed, so
+the device never writes it: it is flashed with the programmer. To replace
+a bundle, pass the HEX image of the one in use with --previous: the new
+one goes to the other bank with the next generation, and the old one
+stays in use if programming is interrupted.
+
+A certificate file holds the 137 bytes of a certificate, either binary or
+as hex text ("0x3E, 0x12, ..." or "3E12...", // comments are ignored). Its
+first byte is the certificate id: 1 device, 2 signer.
+
+Usage:
+    make_bundle.py CERT [CERT ...] [-o BUNDLE.bin] [--hex BUNDLE.hex]
+                   [--bank a|b | --previous OLD.hex]
+
+    -o          binary image
+    --hex       Intel HEX image at the address of the bank, for the programmer
+    --bank      bank of the HEX image (default a)
+    --previous  HEX image of the bundle in use, the new one takes the other
+                bank and the next generation
+
+Example:
+    tools/cert_bundle/make_bundle.py device.txt signer1.txt signer2.txt \\
+        --hex bundle.hex
+    tools/cert_bundle/make_bundle.py device.txt signer1.txt signer3.txt \\
+        --previous bundle.hex --hex bundle2.hex
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = 0x444E4243          # "CBND"
+VERSION = 1
+CERT_LEN = 137
+MAX_CERTS = 8
+HDR_LEN = 16
+ENTRY_LEN = 36
+BANK_SIZE = 0x800
+# NVS_SLOT region of basic_ble.syscfg, the banks are its two last sectors
+NVS_BASE = 0x7C000
+NVS_SIZE = 0x4000
+BANKS = {"a": NVS_BASE + NVS_SIZE - 2 * BANK_SIZE,
+         "b": NVS_BASE + NVS_SIZE - BANK_SIZE}
+CERT_IDS = (1, 2)
+
+
+def read_cert(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) == CERT_LEN:
+        return data
+    text = re.sub(r"//[^\n]*", "", data.decode("ascii", errors="replace"))
+    text = re.sub(r"0[xX]", "", text)
+    digits = re.sub(r"[^0-9a-fA-F]", "", text)
+    cert = bytes.fromhex(digits) if len(digits) % 2 == 0 else b""
+    if len(cert) != CERT_LEN:
+        raise ValueError("%s: %d bytes, a certificate has %d" % (path, len(cert), CERT_LEN))
+    return cert
+
+
+def read_previous(path, banks, magic):
+    """Image written by intel_hex at the address of one of the banks, as a
+    tuple (bank name, image). The CRC of the image is checked."""
+    data = {}
+    base = 0
+    with open(path, errors="replace") as f:
+        for line in f:
+            try:
+                rec = bytes.fromhex(line.strip()[1:])
+                length, addr, rtype = struct.unpack_from(">BHB", rec)
+                if rtype == 4:
+                    base = struct.unpack_from(">H", rec, 4)[0] << 16
+                elif rtype == 0:
+                    for i in range(length):
+                        data[base + addr + i] = rec[4 + i]
+            except (ValueError, IndexError, struct.error):
+                raise ValueError("%s: not an Intel HEX image" % path)
+    for name, address in banks.items():
+        header = bytes(data.get(address + i, 0xFF) for i in range(HDR_LEN))
+        hdr_magic, version, count, length, generation, crc = struct.unpack("<IBBHII", header)
+        if hdr_magic == magic:
+            image = bytes(data.get(address + i, 0xFF) for i in range(min(length, BANK_SIZE)))
+            if length < HDR_LEN or zlib.crc32(image[HDR_LEN:]) != crc:
+                raise ValueError("%s: bad CRC" % path)
+            return name, image
+    raise ValueError("%s: no image at the address of a bank" % path)
+
+
+def next_generation(image):
+    return (struct.unpack_from("<I", image, 8)[0] + 1) & 0xFFFFFFFF
+
+
+def build(certs, generation=1):
+    if not certs or len(certs) > MAX_CERTS:
+        raise ValueError("a bundle holds 1 to %d certificates" % MAX_CERTS)
+    certs_offset = HDR_LEN + ENTRY_LEN * len(certs)
+    index = b""
+    for i, cert in enumerate(certs):
+        if cert[0] not in CERT_IDS:
+            raise ValueError("certificate %d: unknown id %d" % (i, cert[0]))
+        index += struct.pack("<BBH", cert[0], 0, certs_offset + i * CERT_LEN)
+        index += hashlib.sha256(cert).digest()
+    body = index + b"".join(certs)
+    length = HDR_LEN + len(body)
+    if length > BANK_SIZE:
+        raise ValueError("%d bytes, a bank has %d" % (length, BANK_SIZE))
+    header = struct.pack("<IBBHII", MAGIC, VERSION, len(certs), length, generation, zlib.crc32(body))
+    return header + body
+
+
+def intel_hex(data, address):
+    lines = []
+
+    def record(rtype, addr, payload):
+        rec = struct.pack(">BHB", len(payload), addr & 0xFFFF, rtype) + payload
+        lines.append(":%s%02X" % (rec.hex().upper(), (-sum(rec)) & 0xFF))
+
+    record(4, 0, struct.pack(">H", address >> 16))
+    for pos in range(0, len(data), 16):
+        record(0, address + pos, data[pos:pos + 16])
+    record(1, 0, b"")
+    return "\n".join(lines) + "\n"
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Build a certificate bundle image")
+    parser.add_argument("certs", nargs="+", help="certificate files, binary or hex text")
+    parser.add_argument("-o", "--output", help="binary image")
+    parser.add_argument("--hex", help="Intel HEX image at the address of the bank")
+    bank = parser.add_mutually_exclusive_group()
+    bank.add_argument("--bank", choices=sorted(BANKS), default="a", help="bank of the HEX image")
+    bank.add_argument("--previous", help="HEX image of the bundle in use")
+    args = parser.parse_args(argv)
+
+    try:
+        generation = 1
+        if args.previous:
+            previous, image = read_previous(args.previous, BANKS, MAGIC)
+            args.bank = "b" if previous == "a" else "a"
+            generation = next_generation(image)
+        bundle = build([read_cert(p) for p in args.certs], generation)
+    except (OSError, ValueError) as e:
+        print("make_bundle: %s" % e, file=sys.stderr)
+        return 1
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(bundle)
+    if args.hex:
+        with open(args.hex, "w") as f:
+            f.write(intel_hex(bundle, BANKS[args.bank]))
+
+    print("%d certificates, %d bytes, bank %s, generation %d" % (len(args.certs), len(bundle), args.bank, generation))
+    for i in range(len(args.certs)):
+        cert_id, _, offset = struct.unpack_from("<BBH", bundle, HDR_LEN + i * ENTRY_LEN)
+        fingerprint = bundle[HDR_LEN + i * ENTRY_LEN + 4:HDR_LEN + (i + 1) * ENTRY_LEN]
+        print("  id %d at %4d  %s" % (cert_id, offset, fingerprint.hex()))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
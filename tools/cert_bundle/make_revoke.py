@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Build a certificate revocation list image for the NVS_SLOT banks of
+app_cert_store.c.
+
+Layout, little endian, offsets from the start of the bank:
+
+    header      magic "CRVK" (u32), version (u8), count (u8), len (u16),
+                generation (u32), crc (u32)                     16 bytes
+    filter      Bloom filter of the ids, bits inverted         256 bytes
+    ids         first 16 bytes of the certificate fingerprints, sorted
+
+The bits of an id in the filter are its first three 16-bit words, little
+endian, modulo the 2048 bits of the filter. The CRC-32 (zlib.crc32)
+covers the bytes after the header.
+
+A revoked certificate is given either as a certificate file, like
+make_bundle.py takes, or as the 64 hex digits of its SHA-256 fingerprint,
+as make_bundle.py prints them.
+
+The list is not signed, so the device never writes it: it is flashed with
+the programmer, like the bundle. To revoke more certificates, pass the HEX
+image of the list in use with --previous: its ids are kept, and the new
+list goes to the other bank with the next generation, so the old one stays
+in use if programming is interrupted.
+
+Usage:
+    make_revoke.py CERT|FINGERPRINT [...] [-o LIST.bin] [--hex LIST.hex]
+                   [--bank a|b | --previous OLD.hex]
+
+    -o          binary image
+    --hex       Intel HEX image of the list at the address of the bank, for
+                the programmer
+    --bank      bank of the HEX image (default a)
+    --previous  HEX image of the list in use, its ids are kept and the new
+                list takes the other bank and the next generation
+
+Example:
+    tools/cert_bundle/make_revoke.py lost_device.txt --hex revoke.hex
+    tools/cert_bundle/make_revoke.py 3f1c...e0 --previous revoke.hex \\
+        --hex revoke2.hex
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+import zlib
+
+from make_bundle import (BANK_SIZE, HDR_LEN, NVS_BASE, NVS_SIZE, intel_hex, next_generation,
+                         read_cert, read_previous)
+
+MAGIC = 0x4B565243          # "CRVK"
+VERSION = 1
+FILTER_LEN = 256
+HASHES = 3
+ID_LEN = 16
+# CERT_REVOKE_MAX_IDS of app_main.h
+MAX_IDS = 96
+# The two sectors before the certificate bundle banks
+BANKS = {"a": NVS_BASE + NVS_SIZE - 4 * BANK_SIZE,
+         "b": NVS_BASE + NVS_SIZE - 3 * BANK_SIZE}
+
+
+def read_fingerprint(arg):
+    if re.fullmatch(r"[0-9a-fA-F]{64}", arg):
+        return bytes.fromhex(arg)
+    return hashlib.sha256(read_cert(arg)).digest()
+
+
+def previous_ids(image):
+    count = image[5]
+    offset = HDR_LEN + FILTER_LEN
+    return [image[offset + i * ID_LEN:offset + (i + 1) * ID_LEN] for i in range(count)]
+
+
+def build(fingerprints, kept=(), generation=1):
+    ids = sorted(set(fp[:ID_LEN] for fp in fingerprints) | set(kept))
+    if len(ids) > MAX_IDS:
+        raise ValueError("%d ids, a list holds %d" % (len(ids), MAX_IDS))
+    bits = bytearray(FILTER_LEN)
+    for i in ids:
+        for k in range(HASHES):
+            bit = struct.unpack_from("<H", i, 2 * k)[0] & (FILTER_LEN * 8 - 1)
+            bits[bit >> 3] |= 1 << (bit & 7)
+    body = bytes(b ^ 0xFF for b in bits) + b"".join(ids)
+    header = struct.pack("<IBBHII", MAGIC, VERSION, len(ids), HDR_LEN + len(body), generation, zlib.crc32(body))
+    return header + body
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Build a certificate revocation list image")
+    parser.add_argument("revoked", nargs="+", help="certificate files or SHA-256 fingerprints")
+    parser.add_argument("-o", "--output", help="binary image")
+    parser.add_argument("--hex", help="Intel HEX image at the address of the bank")
+    bank = parser.add_mutually_exclusive_group()
+    bank.add_argument("--bank", choices=sorted(BANKS), default="a", help="bank of the HEX image")
+    bank.add_argument("--previous", help="HEX image of the list in use")
+    args = parser.parse_args(argv)
+
+    try:
+        kept = []
+        generation = 1
+        if args.previous:
+            previous, old = read_previous(args.previous, BANKS, MAGIC)
+            args.bank = "b" if previous == "a" else "a"
+            kept = previous_ids(old)
+            generation = next_generation(old)
+        fingerprints = [read_fingerprint(a) for a in args.revoked]
+        image = build(fingerprints, kept, generation)
+    except (OSError, ValueError) as e:
+        print("make_revoke: %s" % e, file=sys.stderr)
+        return 1
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(image)
+    if args.hex:
+        with open(args.hex, "w") as f:
+            f.write(intel_hex(image, BANKS[args.bank]))
+
+    print("%d revoked ids, %d bytes, bank %s, generation %d" % (image[5], len(image), args.bank, generation))
+    for fp in fingerprints:
+        print("  %s" % fp.hex())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
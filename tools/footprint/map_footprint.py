@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+"""
+Flash and SRAM footprint of a TI ARM Clang linker map, per object and per
+symbol, with deltas against a stored baseline.
+
+The SECTION ALLOCATION MAP lists every input section with its address and
+length. Each input section is charged to the memory region (FLASH, SRAM...)
+its address falls in, so .data counts as SRAM and its load image as part of
+the linker generated .cinit. Library members are reported as lib.a(obj).
+
+Usage:
+    map_footprint.py MAP [--baseline FILE] [--save-baseline FILE]
+                         [--objects PATTERNS] [--all] [--symbols] [--top N]
+
+    --objects   comma separated fnmatch patterns of the objects to report,
+                e.g. "app_*.o,simple_gatt_profile.o". Default: the objects
+                of the project, without the library members.
+    --all       report the library members too
+    --symbols   also list the symbols of the reported objects
+    --top N     symbols listed per object (default 15, 0 for all)
+
+Example:
+    tools/footprint/map_footprint.py Central/Release/*.map \\
+        --baseline tools/footprint/central_baseline.json --symbols
+"""
+
+import argparse
+import fnmatch
+import json
+import re
+import sys
+
+# Regions reported as columns, in this order when present in the map
+REGION_ORDER = ["FLASH", "SRAM"]
+
+MEMORY_RE = re.compile(r"^\s+(\S+)\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})")
+INPUT_RE = re.compile(r"^\s{10,}([0-9a-f]{8})\s+([0-9a-f]{8})\s+(.*?)\s*$")
+OUTPUT_RE = re.compile(r"^(\S+)")
+
+# Kind of an input section, from its name
+KINDS = (".text", ".rodata", ".data", ".bss", ".cinit")
+
+
+def parse_memory(lines):
+    """Memory regions of the MEMORY CONFIGURATION table."""
+    regions = []
+    in_table = False
+    for line in lines:
+        if line.startswith("MEMORY CONFIGURATION"):
+            in_table = True
+            continue
+        if in_table:
+            if line.startswith("SEGMENT ALLOCATION MAP"):
+                break
+            m = MEMORY_RE.match(line)
+            if m:
+                regions.append({"name": m.group(1),
+                                "origin": int(m.group(2), 16),
+                                "length": int(m.group(3), 16),
+                                "used": int(m.group(4), 16)})
+    return regions
+
+
+def region_of(regions, address):
+    for r in regions:
+        if r["origin"] <= address < r["origin"] + r["length"]:
+            return r["name"]
+    return None
+
+
+def split_input(rest, lib):
+    """Object and input section name of an input section line.
+
+    Returns (object, section, lib). Continuation lines of a library start
+    with ':' and reuse the library of the previous line.
+    """
+    m = re.match(r"^(?:(\S+\.a)\s+)?(?::\s+)?(\S+)?\s*\(([^)]*)\)", rest)
+    if not m:
+        return None, None, lib
+    if m.group(1):
+        lib = m.group(1)
+    elif m.group(2) and not rest.startswith(":"):
+        # A plain object ends the library run, .common lines do not
+        lib = None
+    obj = m.group(2)
+    section = m.group(3)
+    if obj is None:
+        obj = "(common)" if section.startswith(".common:") else "(linker)"
+    elif lib:
+        obj = "%s(%s)" % (lib, obj)
+    return obj, section, lib
+
+
+def symbol_of(section):
+    """Kind and readable symbol name of an input section."""
+    if section.startswith(".common:"):
+        return ".bss", section[len(".common:"):]
+    for kind in KINDS:
+        if section == kind:
+            return kind, "<%s>" % kind[1:]
+        if section.startswith(kind + "."):
+            name = section[len(kind) + 1:]
+            if re.match(r"^str\d+\.", name):
+                return kind, "<strings>"
+            if re.match(r"^cst\d+", name):
+                return kind, "<constants>"
+            if name.startswith(".L__const."):
+                return kind, name[len(".L__const."):]
+            if name.startswith(".L_MergedGlobals"):
+                return kind, "<merged globals>"
+            return kind, name
+    return "", section
+
+
+def parse_map(path):
+    """Footprint of a linker map.
+
+    Returns {"regions": {name: {"length", "used"}},
+             "objects": {obj: {region: bytes}},
+             "symbols": {obj: {symbol: {region: bytes}}}}
+    """
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+
+    regions = parse_memory(lines)
+    objects = {}
+    symbols = {}
+
+    in_sections = False
+    skip_output = False
+    lib = None
+    for line in lines:
+        if line.startswith("SECTION ALLOCATION MAP"):
+            in_sections = True
+            continue
+        if not in_sections:
+            continue
+        if line.startswith("MODULE SUMMARY") or line.startswith("LINKER GENERATED"):
+            break
+
+        if line and not line[0].isspace():
+            if OUTPUT_RE.match(line) and not line.startswith("*"):
+                # Copy sections are not loaded on the target
+                skip_output = "COPY SECTION" in line
+            elif "COPY SECTION" in line:
+                skip_output = True
+            continue
+
+        m = INPUT_RE.match(line)
+        if not m or skip_output:
+            continue
+        address = int(m.group(1), 16)
+        length = int(m.group(2), 16)
+        rest = m.group(3)
+        if rest.startswith("--HOLE--") or length == 0:
+            continue
+
+        obj, section, lib = split_input(rest, lib)
+        if obj is None:
+            continue
+        region = region_of(regions, address)
+        if region is None:
+            continue
+
+        kind, name = symbol_of(section)
+        objects.setdefault(obj, {}).setdefault(region, 0)
+        objects[obj][region] += length
+        sym = symbols.setdefault(obj, {}).setdefault(name, {})
+        sym[region] = sym.get(region, 0) + length
+
+    return {"regions": {r["name"]: {"length": r["length"], "used": r["used"]} for r in regions},
+            "objects": objects,
+            "symbols": symbols}
+
+
+def is_library(obj):
+    return ".a(" in obj or obj.startswith("(")
+
+
+def selected(obj, patterns, include_libs):
+    if patterns:
+        return any(fnmatch.fnmatch(obj, p) for p in patterns)
+    return include_libs or not is_library(obj)
+
+
+def columns(footprint, rows, base_rows):
+    """FLASH and SRAM, then the other regions the reported objects use."""
+    cols = [r for r in REGION_ORDER if r in footprint["regions"]]
+    used = set()
+    for sizes in list(rows.values()) + list(base_rows.values()):
+        used |= set(r for r, size in sizes.items() if size)
+    cols += sorted(r for r in used if r not in cols)
+    return cols
+
+
+def fmt_delta(new, old):
+    if old is None:
+        return "new"
+    if new is None:
+        return "gone"
+    d = new - old
+    return "%+d" % d if d else "0"
+
+
+def print_regions(footprint, baseline):
+    print("%-12s %10s %10s %10s%s" % ("Region", "Length", "Used", "Free", "   dUsed" if baseline else ""))
+    for name, r in footprint["regions"].items():
+        line = "%-12s %10d %10d %10d" % (name, r["length"], r["used"], r["length"] - r["used"])
+        if baseline:
+            b = baseline["regions"].get(name)
+            line += " %8s" % fmt_delta(r["used"], b["used"] if b else None)
+        print(line)
+    print("")
+
+
+def print_table(title, rows, cols, baseline_rows, has_baseline, total="Total"):
+    """rows / baseline_rows: {key: {region: bytes}}"""
+    width = max([len(title)] + [len(k) for k in rows] + [len(k) for k in baseline_rows]) + 2
+    header = "%-*s" % (width, title) + "".join("%10s" % c for c in cols)
+    if has_baseline:
+        header += "".join("%10s" % ("d" + c) for c in cols)
+    print(header)
+
+    keys = set(rows) | set(baseline_rows)
+    order = sorted(keys, key=lambda k: (-sum(rows.get(k, {}).values()), k))
+    totals = dict((c, 0) for c in cols)
+    base_totals = dict((c, 0) for c in cols)
+    for key in order:
+        new = rows.get(key)
+        old = baseline_rows.get(key)
+        line = "%-*s" % (width, key)
+        line += "".join("%10d" % (new or {}).get(c, 0) for c in cols)
+        for c in cols:
+            totals[c] += (new or {}).get(c, 0)
+            base_totals[c] += (old or {}).get(c, 0)
+        if has_baseline:
+            for c in cols:
+                n = None if new is None else new.get(c, 0)
+                o = None if old is None else old.get(c, 0)
+                line += "%10s" % fmt_delta(n, o)
+        print(line)
+
+    line = "%-*s" % (width, total) + "".join("%10d" % totals[c] for c in cols)
+    if has_baseline:
+        line += "".join("%10s" % fmt_delta(totals[c], base_totals[c]) for c in cols)
+    print(line)
+    print("")
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Per object and per symbol footprint of a TI linker map")
+    parser.add_argument("map")
+    parser.add_argument("--baseline", help="JSON footprint to compare against")
+    parser.add_argument("--save-baseline", help="write the footprint of MAP as a baseline")
+    parser.add_argument("--objects", help="comma separated fnmatch patterns of the objects to report")
+    parser.add_argument("--all", action="store_true", help="report the library members too")
+    parser.add_argument("--symbols", action="store_true", help="list the symbols of the reported objects")
+    parser.add_argument("--top", type=int, default=15, help="symbols listed per object, 0 for all")
+    args = parser.parse_args(argv)
+
+    footprint = parse_map(args.map)
+
+    if args.save_baseline:
+        # Symbols of the library members are not kept, they only change
+        # with the SDK
+        saved = dict(footprint)
+        saved["symbols"] = dict((o, s) for o, s in footprint["symbols"].items() if not is_library(o))
+        with open(args.save_baseline, "w") as f:
+            json.dump(saved, f, indent=1, sort_keys=True)
+            f.write("\n")
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    patterns = [p.strip() for p in args.objects.split(",")] if args.objects else None
+    rows = dict((o, s) for o, s in footprint["objects"].items() if selected(o, patterns, args.all))
+    base_rows = {}
+    if baseline:
+        base_rows = dict((o, s) for o, s in baseline["objects"].items() if selected(o, patterns, args.all))
+    cols = columns(footprint, rows, base_rows)
+
+    print_regions(footprint, baseline)
+    print_table("Object", rows, cols, base_rows, baseline is not None)
+
+    if args.symbols:
+        for obj in sorted(set(rows) | set(base_rows), key=lambda o: (-sum(rows.get(o, {}).values()), o)):
+            syms = footprint["symbols"].get(obj, {})
+            base_syms = baseline["symbols"].get(obj, {}) if baseline else {}
+            total = "Total"
+            if args.top and len(set(syms) | set(base_syms)) > args.top:
+                total = "Total of the %d largest" % args.top
+                keep = sorted(set(syms) | set(base_syms),
+                              key=lambda s: (-max(sum(syms.get(s, {}).values()),
+                                                  sum(base_syms.get(s, {}).values())), s))[:args.top]
+                syms = dict((s, syms[s]) for s in keep if s in syms)
+                base_syms = dict((s, base_syms[s]) for s in keep if s in base_syms)
+            print_table(obj, syms, cols, base_syms, baseline is not None, total)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
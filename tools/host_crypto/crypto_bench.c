@@ -0,0 +1,356 @@
+/******************************************************************************
+
+@file  crypto_bench.c
+
+@brief This file contains the known answer tests and the benchmark of
+       the host SHA2 and ECDSA backend
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+/*
+ * Known answer tests and throughput of the host SHA2 / ECDSA backend,
+ * through the verification context of the application:
+ *
+ *   cc -O2 -DCRYPTO_CTX_HOST -Itools/host_crypto/include -ICentral/app \
+ *      tools/host_crypto/sha2_host.c tools/host_crypto/ecdsa_host.c \
+ *      tools/host_crypto/crypto_bench.c Central/app/app_crypto_ctx.c \
+ *      Central/app/app_crypto_prof.c -o crypto_bench
+ *   ./crypto_bench [seconds per benchmark]
+ *
+ * The crypto operation profiler of the application records every driver
+ * call on the way, its statistics close the report.
+ *
+ * The exit status is 1 when a known answer test fails.
+ */
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ti/drivers/SHA2.h>
+#include <ti/drivers/ECDSA.h>
+#include <app_crypto_ctx.h>
+#include <app_crypto_prof.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define BENCH_BUF_LEN           4096
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static double Bench_now(void);
+static int Bench_check(const char *pName, int ok);
+static void Bench_printProfile(void);
+static void Bench_hash(const char *pName, uint16_t len, double seconds);
+static void Bench_verifyCert(double seconds);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+// Copies of the built-in certificates of app_cert_store.c, both self-signed
+static const uint8_t benchSignerCert[APP_CERT_LEN] =
+{
+
+    0x02,
+    0x3E, 0x12, 0xCB, 0x3D, 0x01, 0x32, 0x36, 0x6F, // 8 bytes data
+    0xC4, 0xBC, 0x58, 0x1D, 0xAE, 0xA6, 0xB6, 0x44, 0x15, 0xBE, 0x3E, // public key X
+    0x1F, 0x59, 0x8B, 0x83, 0xBA, 0x17, 0x57, 0xD6, 0x1A, 0x81, 0xB9,
+    0xD1, 0xD6, 0xAB, 0xF6, 0xDF, 0x6D, 0xFD, 0xEE, 0x89, 0x24,
+    0x2F, 0xB7, 0x2B, 0x22, 0x54, 0xDF, 0x99, 0x1E, 0x7D, 0xF3, 0xAD, // public key Y
+    0x88, 0xA5, 0x99, 0x51, 0x4D, 0xF7, 0x4C, 0x91, 0x09, 0x06, 0x47,
+    0x20, 0x77, 0x4B, 0x7E, 0x3A, 0xB4, 0x2D, 0xC0, 0x08, 0xBA,
+    0x84, 0xE6, 0x0D, 0x13, 0x37, 0xAB, 0x47, 0xDA, 0xA9, 0x5E, 0x2D, // signature R + S
+    0xBA, 0x80, 0x7A, 0x10, 0x99, 0x9A, 0x15, 0xAF, 0x92, 0x22, 0x1C,
+    0xC1, 0x3B, 0xE7, 0x22, 0x6F, 0x74, 0xAF, 0x69, 0x67, 0x00, 0x5B,
+    0x84, 0xD9, 0x8F, 0x0B, 0x30, 0x3F, 0xEC, 0xD0, 0x4D, 0xA4, 0x05,
+    0x15, 0x43, 0x87, 0xC9, 0xEF, 0x01, 0xBB, 0x8E, 0x87, 0x39, 0x20,
+    0x57, 0x84, 0x50, 0x9D, 0x63, 0xC6, 0x2C, 0x87, 0x56
+};
+
+static const uint8_t benchDeviceCert[APP_CERT_LEN] =
+{
+
+    0x01,
+    0x74, 0x79, 0x41, 0x3A, 0x50, 0xEF, 0x4B, 0x34, // 8 bytes data
+    0xBB, 0x12, 0xBF, 0xEF, 0x48, 0xE8, 0xAC, 0x5E, 0x54, 0x07, 0x90, // public key X
+    0xA9, 0x58, 0xD0, 0x99, 0xC4, 0xA7, 0xEF, 0x31, 0x58, 0xD4, 0xBD,
+    0xAF, 0x3A, 0x86, 0x8C, 0x33, 0x96, 0x1D, 0x73, 0x45, 0x90,
+    0x74, 0xC2, 0xC9, 0x63, 0xB4, 0xA0, 0xE2, 0xDC, 0xF6, 0x96, 0x02, // public key Y
+    0xBA, 0xDF, 0xFC, 0x8E, 0x5D, 0x40, 0x7A, 0xEF, 0x61, 0xEE, 0x98,
+    0x61, 0xFB, 0xB1, 0x2A, 0x9C, 0x46, 0xA9, 0x99, 0x50, 0x46,
+    0x1F, 0x2A, 0x03, 0x4A, 0x0C, 0xCE, 0xDC, 0x97, 0xC8, 0x83, 0x55, // signature R + S
+    0x3D, 0x08, 0x4D, 0x4C, 0x5D, 0xDA, 0x46, 0x44, 0x65, 0xBB, 0x47,
+    0x37, 0x49, 0x4A, 0xE4, 0xE2, 0x09, 0x5D, 0xA5, 0x0F, 0x52, 0x91,
+    0x29, 0xCD, 0xD4, 0xD1, 0xEA, 0xE3, 0xFC, 0x1B, 0xBC, 0xA7, 0x37,
+    0xC7, 0xA9, 0x15, 0xB6, 0x79, 0xC6, 0xB6, 0x9F, 0x18, 0xE6, 0x15,
+    0x59, 0xAB, 0x02, 0xD2, 0xF5, 0xE6, 0xDB, 0x16, 0xF5
+};
+
+// RFC 6979 A.2.5, P-256 key, SHA-256 of "sample"
+static const uint8_t benchRfcPublicKey[CERT_PUBLIC_KEY_LEN] =
+{
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C, 0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99, 0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51, 0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99
+};
+static const uint8_t benchRfcSignature[64] =
+{
+    0xEF, 0xD4, 0x8B, 0x2A, 0xAC, 0xB6, 0xA8, 0xFD, 0x11, 0x40, 0xDD, 0x9C, 0xD4, 0x5E, 0x81, 0xD6,
+    0x9D, 0x2C, 0x87, 0x7B, 0x56, 0xAA, 0xF9, 0x91, 0xC3, 0x4D, 0x0E, 0xA8, 0x4E, 0xAF, 0x37, 0x16,
+    0xF7, 0xCB, 0x1C, 0x94, 0x2D, 0x65, 0x7C, 0x41, 0xD4, 0x36, 0xC7, 0xA1, 0xB6, 0xE2, 0x9F, 0x65,
+    0xF3, 0xE9, 0x00, 0xDB, 0xB9, 0xAF, 0xF4, 0x06, 0x4D, 0xC4, 0xAB, 0x2F, 0x84, 0x3A, 0xCD, 0xA8
+};
+
+// FIPS 180-4 examples
+static const uint8_t benchShaAbc[CRYPTO_CTX_DIGEST_LEN] =
+{
+    0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA, 0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+    0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C, 0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD
+};
+static const uint8_t benchSha2Blocks[CRYPTO_CTX_DIGEST_LEN] =
+{
+    0x24, 0x8D, 0x6A, 0x61, 0xD2, 0x06, 0x38, 0xB8, 0xE5, 0xC0, 0x26, 0x93, 0x0C, 0x3E, 0x60, 0x39,
+    0xA3, 0x3C, 0xE4, 0x59, 0x64, 0xFF, 0x21, 0x67, 0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1
+};
+
+static uint8_t benchBuf[BENCH_BUF_LEN];
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Run the known answer tests, then the benchmarks
+ *
+ * @param   argc - argument count
+ * @param   argv - optional seconds per benchmark, default 1
+ *
+ * @return  0, or 1 when a known answer test failed
+ */
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    uint8_t digest[CRYPTO_CTX_DIGEST_LEN];
+    const CertView_t *pSigner = CertView_parse(benchSignerCert, sizeof(benchSignerCert));
+    const CertView_t *pDevice = CertView_parse(benchDeviceCert, sizeof(benchDeviceCert));
+    uint8_t cert[APP_CERT_LEN];
+    const CertView_t *pCert = CertView_parse(cert, sizeof(cert));
+    int failed = 0;
+
+    printf("Known answer tests\n");
+    CryptoCtx_hash((const uint8_t *)"abc", 3, digest);
+    failed += Bench_check("SHA-256 \"abc\"", memcmp(digest, benchShaAbc, sizeof(digest)) == 0);
+    CryptoCtx_hash((const uint8_t *)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, digest);
+    failed += Bench_check("SHA-256 two blocks", memcmp(digest, benchSha2Blocks, sizeof(digest)) == 0);
+
+    failed += Bench_check("ECDSA RFC 6979 P-256 / SHA-256",
+                          CryptoCtx_verifyData(benchRfcPublicKey, (const uint8_t *)"sample", 6,
+                                               benchRfcSignature) == ECDSA_STATUS_SUCCESS);
+    failed += Bench_check("ECDSA RFC 6979, other message rejected",
+                          CryptoCtx_verifyData(benchRfcPublicKey, (const uint8_t *)"test", 4,
+                                               benchRfcSignature) != ECDSA_STATUS_SUCCESS);
+
+    failed += Bench_check("Signer certificate, self-signed",
+                          CryptoCtx_verifyCert(pSigner, pSigner->publicKey) == ECDSA_STATUS_SUCCESS);
+    failed += Bench_check("Device certificate, self-signed",
+                          CryptoCtx_verifyCert(pDevice, pDevice->publicKey) == ECDSA_STATUS_SUCCESS);
+    failed += Bench_check("Device certificate, signer key rejected",
+                          CryptoCtx_verifyCert(pDevice, pSigner->publicKey) != ECDSA_STATUS_SUCCESS);
+
+    memcpy(cert, benchSignerCert, sizeof(cert));
+    cert[CERT_SIGNATURE_OFFSET + 5] ^= 0x01;
+    failed += Bench_check("Signer certificate, altered signature rejected",
+                          CryptoCtx_verifyCert(pCert, pCert->publicKey) != ECDSA_STATUS_SUCCESS);
+    memcpy(cert, benchSignerCert, sizeof(cert));
+    cert[CERT_PUBLIC_KEY_OFFSET + 40] ^= 0x01;
+    failed += Bench_check("Signer certificate, key off the curve rejected",
+                          CryptoCtx_verifyCert(pCert, pCert->publicKey) != ECDSA_STATUS_SUCCESS);
+    failed += Bench_check("Truncated certificate rejected",
+                          CertView_parse(cert, APP_CERT_LEN - 1) == NULL &&
+                          CryptoCtx_verifyCert(NULL, pSigner->publicKey) != ECDSA_STATUS_SUCCESS);
+
+    printf("\nThroughput, %.1f s each\n", seconds);
+    Bench_hash("SHA-256, public key (64 B)", CERT_PUBLIC_KEY_LEN, seconds);
+    Bench_hash("SHA-256, certificate (137 B)", APP_CERT_LEN, seconds);
+    Bench_hash("SHA-256, 4 KB", BENCH_BUF_LEN, seconds);
+    Bench_verifyCert(seconds);
+    Bench_printProfile();
+
+    return failed ? 1 : 0;
+}
+
+/*********************************************************************
+ * @fn      Bench_now
+ *
+ * @brief   Monotonic time
+ *
+ * @return  seconds
+ */
+static double Bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*********************************************************************
+ * @fn      Bench_check
+ *
+ * @brief   Print the result of a known answer test
+ *
+ * @param   pName - test name
+ * @param   ok - result
+ *
+ * @return  0 when ok, 1 otherwise
+ */
+static int Bench_check(const char *pName, int ok)
+{
+    printf("  %-48s %s\n", pName, ok ? "ok" : "FAILED");
+
+    return ok ? 0 : 1;
+}
+
+/*********************************************************************
+ * @fn      Bench_hash
+ *
+ * @brief   Hash a buffer through CryptoCtx_hash for the given time
+ *
+ * @param   pName - label
+ * @param   len - length hashed per call
+ * @param   seconds - duration
+ *
+ * @return  none
+ */
+static void Bench_hash(const char *pName, uint16_t len, double seconds)
+{
+    uint8_t digest[CRYPTO_CTX_DIGEST_LEN];
+    double start = Bench_now();
+    double elapsed;
+    unsigned long n = 0;
+
+    do
+    {
+        CryptoCtx_hash(benchBuf, len, digest);
+        benchBuf[0] = digest[0];
+        n++;
+        elapsed = Bench_now() - start;
+    } while (elapsed < seconds);
+
+    printf("  %-34s %10.0f hash/s %8.2f MB/s %8.2f us\n", pName, n / elapsed,
+           n * (double)len / elapsed / 1e6, elapsed / n * 1e6);
+}
+
+/*********************************************************************
+ * @fn      Bench_verifyCert
+ *
+ * @brief   Certificate verifications (hash and ECDSA) for the given time
+ *
+ * @param   seconds - duration
+ *
+ * @return  none
+ */
+static void Bench_verifyCert(double seconds)
+{
+    const CertView_t *pSigner = CertView_parse(benchSignerCert, sizeof(benchSignerCert));
+    double start = Bench_now();
+    double elapsed;
+    unsigned long n = 0;
+
+    do
+    {
+        if (CryptoCtx_verifyCert(pSigner, pSigner->publicKey) != ECDSA_STATUS_SUCCESS)
+        {
+            printf("  verification failed\n");
+            return;
+        }
+        n++;
+        elapsed = Bench_now() - start;
+    } while (elapsed < seconds);
+
+    printf("  %-34s %10.0f verify/s %17.2f us\n", "ECDSA P-256, certificate", n / elapsed, elapsed / n * 1e6);
+}
+
+/*********************************************************************
+ * @fn      Bench_printProfile
+ *
+ * @brief   Print the statistics of the crypto operation profiler
+ *
+ * @return  none
+ */
+static void Bench_printProfile(void)
+{
+#if APP_CRYPTO_PROF
+    const CryptoProf_stats_t *pStats;
+    uint8_t op;
+    uint8_t bucket;
+
+    printf("\nProfile of the driver calls\n");
+    for (op = 0; op < CRYPTO_PROF_NUM; op++)
+    {
+        pStats = CryptoProf_get(op);
+        if (pStats->count == 0)
+        {
+            continue;
+        }
+        printf("  %-16s %9u calls  avg %9.2f us  min %9.2f us  max %9.2f us  p50 < %u us  p90 < %u us\n",
+               CryptoProf_getName(op), (unsigned)pStats->count,
+               pStats->totalNs / 1000.0 / pStats->count, pStats->minNs / 1000.0, pStats->maxNs / 1000.0,
+               (unsigned)CryptoProf_getPercentileUs(op, 50), (unsigned)CryptoProf_getPercentileUs(op, 90));
+        for (bucket = 0; bucket < CRYPTO_PROF_BUCKETS; bucket++)
+        {
+            if (pStats->hist[bucket] != 0)
+            {
+                printf("  %16s %9u below %lu us\n", "", pStats->hist[bucket], 2UL << bucket);
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,780 @@
+/******************************************************************************
+
+@file  ecdsa_host.c
+
+@brief This file contains a software NIST P-256 ECDSA verification
+       behind the ECDSA driver interface, for host builds
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/drivers/ECDSA.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// 256-bit numbers are 8 little endian words of 32 bits
+#define P256_WORDS          8
+#define P256_BYTES          32
+#define P256_POINT_PREFIX   0x04
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+// Modulus with its Montgomery constants, R = 2^256
+typedef struct
+{
+    uint32_t m[P256_WORDS];
+    uint32_t rr[P256_WORDS];    // R^2 mod m
+    uint32_t one[P256_WORDS];   // R mod m
+    uint32_t m0inv;             // -m^-1 mod 2^32
+}P256_Mod;
+
+// Jacobian point, coordinates in the Montgomery domain of p. Z = 0 is the
+// point at infinity.
+typedef struct
+{
+    uint32_t x[P256_WORDS];
+    uint32_t y[P256_WORDS];
+    uint32_t z[P256_WORDS];
+}P256_Point;
+
+typedef struct
+{
+    bool isOpen;
+}ECDSAHost_Object;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static void P256_init(void);
+static void P256_fromBytes(uint32_t *a, const uint8_t *pBytes);
+static int P256_cmp(const uint32_t *a, const uint32_t *b);
+static uint32_t P256_add(uint32_t *r, const uint32_t *a, const uint32_t *b);
+static uint32_t P256_sub(uint32_t *r, const uint32_t *a, const uint32_t *b);
+static bool P256_isZero(const uint32_t *a);
+static void P256_modAdd(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod);
+static void P256_modSub(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod);
+static void P256_montMul(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod);
+static void P256_montInv(uint32_t *r, const uint32_t *a, const P256_Mod *pMod);
+static void P256_modSetup(P256_Mod *pMod, const uint8_t *pModBytes);
+static void P256_double(P256_Point *r, const P256_Point *a);
+static void P256_addPoints(P256_Point *r, const P256_Point *a, const P256_Point *b);
+static bool P256_isOnCurve(const uint32_t *x, const uint32_t *y);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static const uint8_t p256Prime[P256_BYTES] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+static const uint8_t p256Order[P256_BYTES] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+};
+static const uint8_t p256A[P256_BYTES] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC
+};
+static const uint8_t p256B[P256_BYTES] =
+{
+    0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7, 0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+    0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6, 0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B
+};
+static const uint8_t p256Gx[P256_BYTES] =
+{
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96
+};
+static const uint8_t p256Gy[P256_BYTES] =
+{
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5
+};
+
+const ECCParams_CurveParams ECCParams_NISTP256 =
+{
+    .curveType  = ECCParams_CURVE_TYPE_SHORT_WEIERSTRASS_AN3,
+    .length     = ECCParams_NISTP256_LENGTH,
+    .prime      = p256Prime,
+    .order      = p256Order,
+    .a          = p256A,
+    .b          = p256B,
+    .generatorX = p256Gx,
+    .generatorY = p256Gy,
+    .cofactor   = 1
+};
+
+static bool p256Ready = false;
+static P256_Mod p256P;
+static P256_Mod p256N;
+static uint32_t p256MontB[P256_WORDS];
+static P256_Point p256G;
+
+static ECDSAHost_Object ecdsaHostObject;
+static ECDSA_Config ecdsaHostConfig = {&ecdsaHostObject, NULL};
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      ECDSA_init
+ *
+ * @brief   Compute the Montgomery constants of the curve, once
+ *
+ * @return  none
+ */
+void ECDSA_init(void)
+{
+    if (!p256Ready)
+    {
+        P256_init();
+        p256Ready = true;
+    }
+}
+
+/*********************************************************************
+ * @fn      ECDSA_Params_init
+ *
+ * @brief   Default parameters, blocking
+ *
+ * @param   params - parameters to set
+ *
+ * @return  none
+ */
+void ECDSA_Params_init(ECDSA_Params *params)
+{
+    params->returnBehavior = ECDSA_RETURN_BEHAVIOR_BLOCKING;
+    params->timeout = 0xFFFFFFFF;
+    params->custom = NULL;
+}
+
+/*********************************************************************
+ * @fn      ECDSA_open
+ *
+ * @brief   Open the only instance
+ *
+ * @param   index - ignored
+ * @param   params - ignored, the operations always block
+ *
+ * @return  the handle, or NULL when it is already open
+ */
+ECDSA_Handle ECDSA_open(uint_least8_t index, const ECDSA_Params *params)
+{
+    (void)index;
+    (void)params;
+
+    if (ecdsaHostObject.isOpen)
+    {
+        return NULL;
+    }
+    ECDSA_init();
+    ecdsaHostObject.isOpen = true;
+
+    return &ecdsaHostConfig;
+}
+
+/*********************************************************************
+ * @fn      ECDSA_close
+ *
+ * @brief   Close the instance
+ *
+ * @param   handle - from ECDSA_open
+ *
+ * @return  none
+ */
+void ECDSA_close(ECDSA_Handle handle)
+{
+    ((ECDSAHost_Object *)handle->object)->isOpen = false;
+}
+
+/*********************************************************************
+ * @fn      ECDSA_OperationVerify_init
+ *
+ * @brief   Clear a verify operation
+ *
+ * @param   operation - operation to clear
+ *
+ * @return  none
+ */
+void ECDSA_OperationVerify_init(ECDSA_OperationVerify *operation)
+{
+    memset(operation, 0, sizeof(ECDSA_OperationVerify));
+}
+
+/*********************************************************************
+ * @fn      ECDSA_verify
+ *
+ * @brief   ECDSA verification on NIST P-256 (SEC 1 4.1.4): the public
+ *          key is checked to be on the curve, then u1 * G + u2 * Q is
+ *          computed with one double and add pass over both scalars.
+ *          Not constant time, there is no secret in a verification.
+ *
+ * @param   handle - from ECDSA_open
+ * @param   operation - curve, 0x04 || X || Y public key, hash, r, s
+ *
+ * @return  ECDSA_STATUS_SUCCESS, ECDSA_STATUS_ERROR for a signature
+ *          that does not match, or the error of an invalid input
+ */
+int_fast16_t ECDSA_verify(ECDSA_Handle handle, ECDSA_OperationVerify *operation)
+{
+    const CryptoKey *pKey = operation->theirPublicKey;
+    const uint8_t *pKeyBytes;
+    uint32_t r[P256_WORDS], s[P256_WORDS], e[P256_WORDS];
+    uint32_t u1[P256_WORDS], u2[P256_WORDS], w[P256_WORDS];
+    uint32_t qx[P256_WORDS], qy[P256_WORDS];
+    uint32_t x[P256_WORDS], zInv[P256_WORDS];
+    P256_Point q, gq, acc;
+    int i;
+
+    (void)handle;
+
+    if (operation->curve != &ECCParams_NISTP256)
+    {
+        return ECDSA_STATUS_ERROR;
+    }
+    if (pKey == NULL || pKey->encoding != CryptoKey_PLAINTEXT ||
+        pKey->u.plaintext.keyLength != 1 + 2 * P256_BYTES ||
+        pKey->u.plaintext.keyMaterial[0] != P256_POINT_PREFIX)
+    {
+        return ECDSA_STATUS_INVALID_KEY_SIZE;
+    }
+    pKeyBytes = &pKey->u.plaintext.keyMaterial[1];
+
+    P256_fromBytes(r, operation->r);
+    P256_fromBytes(s, operation->s);
+    if (P256_isZero(r) || P256_cmp(r, p256N.m) >= 0)
+    {
+        return ECDSA_STATUS_R_LARGER_THAN_ORDER;
+    }
+    if (P256_isZero(s) || P256_cmp(s, p256N.m) >= 0)
+    {
+        return ECDSA_STATUS_S_LARGER_THAN_ORDER;
+    }
+
+    P256_fromBytes(qx, pKeyBytes);
+    P256_fromBytes(qy, pKeyBytes + P256_BYTES);
+    if (P256_cmp(qx, p256P.m) >= 0 || P256_cmp(qy, p256P.m) >= 0)
+    {
+        return ECDSA_STATUS_PUBLIC_KEY_LARGER_THAN_PRIME;
+    }
+    P256_montMul(q.x, qx, p256P.rr, &p256P);
+    P256_montMul(q.y, qy, p256P.rr, &p256P);
+    memcpy(q.z, p256P.one, sizeof(q.z));
+    if (!P256_isOnCurve(q.x, q.y))
+    {
+        return ECDSA_STATUS_PUBLIC_KEY_NOT_ON_CURVE;
+    }
+
+    // e < 2^256 < 2n, one subtraction reduces it
+    P256_fromBytes(e, operation->hash);
+    if (P256_cmp(e, p256N.m) >= 0)
+    {
+        P256_sub(e, e, p256N.m);
+    }
+
+    // w = s^-1, u1 = e * w, u2 = r * w, all mod n. montMul(a, R^2) then
+    // montMul(., b) gives a * b without leaving the normal domain.
+    P256_montMul(w, s, p256N.rr, &p256N);
+    P256_montInv(w, w, &p256N);                 // R * s^-1
+    P256_montMul(u1, e, w, &p256N);             // e * s^-1
+    P256_montMul(u2, r, w, &p256N);             // r * s^-1
+
+    // acc = u1 * G + u2 * Q
+    P256_addPoints(&gq, &p256G, &q);
+    memset(&acc, 0, sizeof(acc));
+    for (i = 255; i >= 0; i--)
+    {
+        uint8_t b1 = (u1[i / 32] >> (i % 32)) & 1;
+        uint8_t b2 = (u2[i / 32] >> (i % 32)) & 1;
+
+        P256_double(&acc, &acc);
+        if (b1 && b2)
+        {
+            P256_addPoints(&acc, &acc, &gq);
+        }
+        else if (b1)
+        {
+            P256_addPoints(&acc, &acc, &p256G);
+        }
+        else if (b2)
+        {
+            P256_addPoints(&acc, &acc, &q);
+        }
+    }
+    if (P256_isZero(acc.z))
+    {
+        return ECDSA_STATUS_POINT_AT_INFINITY;
+    }
+
+    // Affine x = X / Z^2, back from the Montgomery domain, mod n
+    P256_montInv(zInv, acc.z, &p256P);
+    P256_montMul(zInv, zInv, zInv, &p256P);
+    P256_montMul(x, acc.x, zInv, &p256P);
+    memset(w, 0, sizeof(w));
+    w[0] = 1;
+    P256_montMul(x, x, w, &p256P);
+    if (P256_cmp(x, p256N.m) >= 0)
+    {
+        P256_sub(x, x, p256N.m);
+    }
+
+    return (P256_cmp(x, r) == 0) ? ECDSA_STATUS_SUCCESS : ECDSA_STATUS_ERROR;
+}
+
+/*********************************************************************
+ * @fn      P256_init
+ *
+ * @brief   Montgomery constants of p and n, b and G in the Montgomery
+ *          domain of p
+ *
+ * @return  none
+ */
+static void P256_init(void)
+{
+    uint32_t t[P256_WORDS];
+
+    P256_modSetup(&p256P, p256Prime);
+    P256_modSetup(&p256N, p256Order);
+
+    P256_fromBytes(t, p256B);
+    P256_montMul(p256MontB, t, p256P.rr, &p256P);
+    P256_fromBytes(t, p256Gx);
+    P256_montMul(p256G.x, t, p256P.rr, &p256P);
+    P256_fromBytes(t, p256Gy);
+    P256_montMul(p256G.y, t, p256P.rr, &p256P);
+    memcpy(p256G.z, p256P.one, sizeof(p256G.z));
+}
+
+/*********************************************************************
+ * @fn      P256_modSetup
+ *
+ * @brief   Montgomery constants of an odd modulus
+ *
+ * @param   pMod - constants to compute
+ * @param   pModBytes - big endian modulus
+ *
+ * @return  none
+ */
+static void P256_modSetup(P256_Mod *pMod, const uint8_t *pModBytes)
+{
+    uint32_t inv = 1;
+    uint8_t i;
+    uint16_t bit;
+
+    P256_fromBytes(pMod->m, pModBytes);
+
+    // Newton iteration, each step doubles the correct low bits
+    for (i = 0; i < 5; i++)
+    {
+        inv *= 2 - pMod->m[0] * inv;
+    }
+    pMod->m0inv = 0 - inv;
+
+    // R mod m = 2^256 - m, as m > 2^255
+    memset(pMod->one, 0, sizeof(pMod->one));
+    P256_sub(pMod->one, pMod->one, pMod->m);
+
+    // R^2 mod m: double R mod m 256 times
+    memcpy(pMod->rr, pMod->one, sizeof(pMod->rr));
+    for (bit = 0; bit < 256; bit++)
+    {
+        P256_modAdd(pMod->rr, pMod->rr, pMod->rr, pMod);
+    }
+}
+
+/*********************************************************************
+ * @fn      P256_fromBytes
+ *
+ * @brief   Big endian bytes to little endian words
+ *
+ * @param   a - P256_WORDS words output
+ * @param   pBytes - P256_BYTES bytes
+ *
+ * @return  none
+ */
+static void P256_fromBytes(uint32_t *a, const uint8_t *pBytes)
+{
+    uint8_t i;
+
+    for (i = 0; i < P256_WORDS; i++)
+    {
+        const uint8_t *pWord = &pBytes[P256_BYTES - 4 * (i + 1)];
+
+        a[i] = ((uint32_t)pWord[0] << 24) | ((uint32_t)pWord[1] << 16) |
+               ((uint32_t)pWord[2] << 8) | pWord[3];
+    }
+}
+
+static int P256_cmp(const uint32_t *a, const uint32_t *b)
+{
+    int i;
+
+    for (i = P256_WORDS - 1; i >= 0; i--)
+    {
+        if (a[i] != b[i])
+        {
+            return (a[i] > b[i]) ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+static bool P256_isZero(const uint32_t *a)
+{
+    uint32_t acc = 0;
+    uint8_t i;
+
+    for (i = 0; i < P256_WORDS; i++)
+    {
+        acc |= a[i];
+    }
+
+    return acc == 0;
+}
+
+// r = a + b, returns the carry
+static uint32_t P256_add(uint32_t *r, const uint32_t *a, const uint32_t *b)
+{
+    uint64_t acc = 0;
+    uint8_t i;
+
+    for (i = 0; i < P256_WORDS; i++)
+    {
+        acc += (uint64_t)a[i] + b[i];
+        r[i] = (uint32_t)acc;
+        acc >>= 32;
+    }
+
+    return (uint32_t)acc;
+}
+
+// r = a - b, returns the borrow
+static uint32_t P256_sub(uint32_t *r, const uint32_t *a, const uint32_t *b)
+{
+    int64_t acc = 0;
+    uint8_t i;
+
+    for (i = 0; i < P256_WORDS; i++)
+    {
+        acc += (int64_t)a[i] - b[i];
+        r[i] = (uint32_t)acc;
+        acc >>= 32;
+    }
+
+    return (uint32_t)(acc & 1);
+}
+
+// r = a + b mod m, for a, b < m
+static void P256_modAdd(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod)
+{
+    uint32_t carry = P256_add(r, a, b);
+
+    if (carry || P256_cmp(r, pMod->m) >= 0)
+    {
+        P256_sub(r, r, pMod->m);
+    }
+}
+
+// r = a - b mod m, for a, b < m
+static void P256_modSub(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod)
+{
+    if (P256_sub(r, a, b))
+    {
+        P256_add(r, r, pMod->m);
+    }
+}
+
+/*********************************************************************
+ * @fn      P256_montMul
+ *
+ * @brief   Montgomery product a * b * R^-1 mod m (CIOS method)
+ *
+ * @param   r - output, may alias a or b
+ * @param   a - operand < m
+ * @param   b - operand < m
+ * @param   pMod - modulus
+ *
+ * @return  none
+ */
+static void P256_montMul(uint32_t *r, const uint32_t *a, const uint32_t *b, const P256_Mod *pMod)
+{
+    uint32_t t[P256_WORDS + 2] = {0};
+    uint64_t acc;
+    uint32_t q;
+    uint8_t i, j;
+
+    for (i = 0; i < P256_WORDS; i++)
+    {
+        acc = 0;
+        for (j = 0; j < P256_WORDS; j++)
+        {
+            acc += (uint64_t)a[j] * b[i] + t[j];
+            t[j] = (uint32_t)acc;
+            acc >>= 32;
+        }
+        acc += t[P256_WORDS];
+        t[P256_WORDS] = (uint32_t)acc;
+        t[P256_WORDS + 1] = (uint32_t)(acc >> 32);
+
+        q = t[0] * pMod->m0inv;
+        acc = (uint64_t)q * pMod->m[0] + t[0];
+        acc >>= 32;
+        for (j = 1; j < P256_WORDS; j++)
+        {
+            acc += (uint64_t)q * pMod->m[j] + t[j];
+            t[j - 1] = (uint32_t)acc;
+            acc >>= 32;
+        }
+        acc += t[P256_WORDS];
+        t[P256_WORDS - 1] = (uint32_t)acc;
+        t[P256_WORDS] = t[P256_WORDS + 1] + (uint32_t)(acc >> 32);
+    }
+
+    if (t[P256_WORDS] || P256_cmp(t, pMod->m) >= 0)
+    {
+        P256_sub(t, t, pMod->m);
+    }
+    memcpy(r, t, P256_WORDS * sizeof(uint32_t));
+}
+
+/*********************************************************************
+ * @fn      P256_montInv
+ *
+ * @brief   Montgomery inverse: a^(m - 2), m is prime
+ *
+ * @param   r - output, may alias a
+ * @param   a - Montgomery form operand, not zero
+ * @param   pMod - modulus
+ *
+ * @return  none
+ */
+static void P256_montInv(uint32_t *r, const uint32_t *a, const P256_Mod *pMod)
+{
+    uint32_t e[P256_WORDS];
+    uint32_t base[P256_WORDS];
+    uint32_t acc[P256_WORDS];
+    uint32_t two[P256_WORDS] = {2};
+    int i;
+
+    P256_sub(e, pMod->m, two);
+    memcpy(base, a, sizeof(base));
+    memcpy(acc, pMod->one, sizeof(acc));
+
+    for (i = 255; i >= 0; i--)
+    {
+        P256_montMul(acc, acc, acc, pMod);
+        if ((e[i / 32] >> (i % 32)) & 1)
+        {
+            P256_montMul(acc, acc, base, pMod);
+        }
+    }
+    memcpy(r, acc, sizeof(acc));
+}
+
+/*********************************************************************
+ * @fn      P256_double
+ *
+ * @brief   r = 2a, Jacobian doubling for a = -3 (dbl-2001-b)
+ *
+ * @param   r - output, may alias a
+ * @param   a - point
+ *
+ * @return  none
+ */
+static void P256_double(P256_Point *r, const P256_Point *a)
+{
+    uint32_t delta[P256_WORDS], gamma[P256_WORDS], beta[P256_WORDS], alpha[P256_WORDS];
+    uint32_t t1[P256_WORDS], t2[P256_WORDS];
+
+    if (P256_isZero(a->z))
+    {
+        *r = *a;
+        return;
+    }
+
+    P256_montMul(delta, a->z, a->z, &p256P);
+    P256_montMul(gamma, a->y, a->y, &p256P);
+    P256_montMul(beta, a->x, gamma, &p256P);
+
+    // alpha = 3 * (X - delta) * (X + delta)
+    P256_modSub(t1, a->x, delta, &p256P);
+    P256_modAdd(t2, a->x, delta, &p256P);
+    P256_montMul(alpha, t1, t2, &p256P);
+    P256_modAdd(t1, alpha, alpha, &p256P);
+    P256_modAdd(alpha, t1, alpha, &p256P);
+
+    // Z3 = (Y + Z)^2 - gamma - delta
+    P256_modAdd(t1, a->y, a->z, &p256P);
+    P256_montMul(t1, t1, t1, &p256P);
+    P256_modSub(t1, t1, gamma, &p256P);
+    P256_modSub(r->z, t1, delta, &p256P);
+
+    // X3 = alpha^2 - 8 * beta
+    P256_modAdd(beta, beta, beta, &p256P);
+    P256_modAdd(beta, beta, beta, &p256P);      // 4 * beta
+    P256_modAdd(t2, beta, beta, &p256P);        // 8 * beta
+    P256_montMul(t1, alpha, alpha, &p256P);
+    P256_modSub(r->x, t1, t2, &p256P);
+
+    // Y3 = alpha * (4 * beta - X3) - 8 * gamma^2
+    P256_modSub(t1, beta, r->x, &p256P);
+    P256_montMul(t1, alpha, t1, &p256P);
+    P256_montMul(t2, gamma, gamma, &p256P);
+    P256_modAdd(t2, t2, t2, &p256P);
+    P256_modAdd(t2, t2, t2, &p256P);
+    P256_modAdd(t2, t2, t2, &p256P);
+    P256_modSub(r->y, t1, t2, &p256P);
+}
+
+/*********************************************************************
+ * @fn      P256_addPoints
+ *
+ * @brief   r = a + b, Jacobian addition (add-2007-bl)
+ *
+ * @param   r - output, may alias a or b
+ * @param   a - point
+ * @param   b - point
+ *
+ * @return  none
+ */
+static void P256_addPoints(P256_Point *r, const P256_Point *a, const P256_Point *b)
+{
+    uint32_t z1z1[P256_WORDS], z2z2[P256_WORDS], u1[P256_WORDS], u2[P256_WORDS];
+    uint32_t s1[P256_WORDS], s2[P256_WORDS], h[P256_WORDS], i[P256_WORDS];
+    uint32_t j[P256_WORDS], rr[P256_WORDS], v[P256_WORDS], t[P256_WORDS];
+    P256_Point out;
+
+    if (P256_isZero(a->z))
+    {
+        *r = *b;
+        return;
+    }
+    if (P256_isZero(b->z))
+    {
+        *r = *a;
+        return;
+    }
+
+    P256_montMul(z1z1, a->z, a->z, &p256P);
+    P256_montMul(z2z2, b->z, b->z, &p256P);
+    P256_montMul(u1, a->x, z2z2, &p256P);
+    P256_montMul(u2, b->x, z1z1, &p256P);
+    P256_montMul(s1, a->y, b->z, &p256P);
+    P256_montMul(s1, s1, z2z2, &p256P);
+    P256_montMul(s2, b->y, a->z, &p256P);
+    P256_montMul(s2, s2, z1z1, &p256P);
+
+    P256_modSub(h, u2, u1, &p256P);
+    P256_modSub(rr, s2, s1, &p256P);
+    if (P256_isZero(h))
+    {
+        if (P256_isZero(rr))
+        {
+            P256_double(r, a);
+        }
+        else
+        {
+            memset(r, 0, sizeof(P256_Point));
+        }
+        return;
+    }
+
+    P256_modAdd(i, h, h, &p256P);
+    P256_montMul(i, i, i, &p256P);              // I = (2H)^2
+    P256_montMul(j, h, i, &p256P);              // J = H * I
+    P256_modAdd(rr, rr, rr, &p256P);            // r = 2 * (S2 - S1)
+    P256_montMul(v, u1, i, &p256P);             // V = U1 * I
+
+    // X3 = r^2 - J - 2V
+    P256_montMul(t, rr, rr, &p256P);
+    P256_modSub(t, t, j, &p256P);
+    P256_modSub(t, t, v, &p256P);
+    P256_modSub(out.x, t, v, &p256P);
+
+    // Y3 = r * (V - X3) - 2 * S1 * J
+    P256_modSub(t, v, out.x, &p256P);
+    P256_montMul(t, rr, t, &p256P);
+    P256_montMul(s1, s1, j, &p256P);
+    P256_modAdd(s1, s1, s1, &p256P);
+    P256_modSub(out.y, t, s1, &p256P);
+
+    // Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H
+    P256_modAdd(t, a->z, b->z, &p256P);
+    P256_montMul(t, t, t, &p256P);
+    P256_modSub(t, t, z1z1, &p256P);
+    P256_modSub(t, t, z2z2, &p256P);
+    P256_montMul(out.z, t, h, &p256P);
+
+    *r = out;
+}
+
+/*********************************************************************
+ * @fn      P256_isOnCurve
+ *
+ * @brief   Check y^2 = x^3 - 3x + b
+ *
+ * @param   x - Montgomery form affine x
+ * @param   y - Montgomery form affine y
+ *
+ * @return  true when the point is on the curve
+ */
+static bool P256_isOnCurve(const uint32_t *x, const uint32_t *y)
+{
+    uint32_t lhs[P256_WORDS], rhs[P256_WORDS], t[P256_WORDS];
+
+    P256_montMul(lhs, y, y, &p256P);
+
+    P256_montMul(rhs, x, x, &p256P);
+    P256_montMul(rhs, rhs, x, &p256P);
+    P256_modAdd(t, x, x, &p256P);
+    P256_modAdd(t, t, x, &p256P);
+    P256_modSub(rhs, rhs, t, &p256P);
+    P256_modAdd(rhs, rhs, p256MontB, &p256P);
+
+    return P256_cmp(lhs, rhs) == 0;
+}
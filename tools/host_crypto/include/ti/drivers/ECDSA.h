@@ -0,0 +1,121 @@
+/******************************************************************************
+
+@file  ECDSA.h
+
+@brief Host build of the ECDSA driver interface, P-256 verify only,
+       see tools/host_crypto/ecdsa_host.c
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef ti_drivers_ECDSA__include
+#define ti_drivers_ECDSA__include
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKey.h>
+#include <ti/drivers/cryptoutils/ecc/ECCParams.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Status codes, as in the SimpleLink SDK
+#define ECDSA_STATUS_SUCCESS                    (0)
+#define ECDSA_STATUS_ERROR                      (-1)
+#define ECDSA_STATUS_RESOURCE_UNAVAILABLE       (-2)
+#define ECDSA_STATUS_R_LARGER_THAN_ORDER        (-5)
+#define ECDSA_STATUS_S_LARGER_THAN_ORDER        (-6)
+#define ECDSA_STATUS_PUBLIC_KEY_NOT_ON_CURVE    (-7)
+#define ECDSA_STATUS_PUBLIC_KEY_LARGER_THAN_PRIME (-8)
+#define ECDSA_STATUS_POINT_AT_INFINITY          (-9)
+#define ECDSA_STATUS_INVALID_KEY_SIZE           (-11)
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef enum
+{
+    ECDSA_RETURN_BEHAVIOR_CALLBACK = 1,
+    ECDSA_RETURN_BEHAVIOR_BLOCKING = 2,
+    ECDSA_RETURN_BEHAVIOR_POLLING  = 4
+}ECDSA_ReturnBehavior;
+
+typedef struct
+{
+    ECDSA_ReturnBehavior returnBehavior;
+    uint32_t timeout;
+    void *custom;
+}ECDSA_Params;
+
+typedef struct
+{
+    void *object;
+    void const *hwAttrs;
+}ECDSA_Config;
+
+typedef ECDSA_Config *ECDSA_Handle;
+
+// Public key: 0x04 || X || Y, hash: curve length bytes, r and s big endian
+typedef struct
+{
+    const ECCParams_CurveParams *curve;
+    const CryptoKey *theirPublicKey;
+    const uint8_t *hash;
+    const uint8_t *r;
+    const uint8_t *s;
+}ECDSA_OperationVerify;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+void ECDSA_init(void);
+void ECDSA_Params_init(ECDSA_Params *params);
+// One instance, NULL while it is open, as on the target
+ECDSA_Handle ECDSA_open(uint_least8_t index, const ECDSA_Params *params);
+void ECDSA_close(ECDSA_Handle handle);
+void ECDSA_OperationVerify_init(ECDSA_OperationVerify *operation);
+int_fast16_t ECDSA_verify(ECDSA_Handle handle, ECDSA_OperationVerify *operation);
+
+#endif /* ti_drivers_ECDSA__include */
@@ -0,0 +1,118 @@
+/******************************************************************************
+
+@file  SHA2.h
+
+@brief Host build of the SHA2 driver interface, SHA-256 only, see
+       tools/host_crypto/sha2_host.c
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef ti_drivers_SHA2__include
+#define ti_drivers_SHA2__include
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Status codes, as in the SimpleLink SDK
+#define SHA2_STATUS_SUCCESS             (0)
+#define SHA2_STATUS_ERROR               (-1)
+#define SHA2_STATUS_RESOURCE_UNAVAILABLE (-2)
+#define SHA2_STATUS_UNSUPPORTED         (-4)
+
+#define SHA2_DIGEST_LENGTH_BYTES_256    32
+#define SHA2_BLOCK_SIZE_BYTES_256       64
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef enum
+{
+    SHA2_HASH_TYPE_224 = 0,
+    SHA2_HASH_TYPE_256 = 1,
+    SHA2_HASH_TYPE_384 = 2,
+    SHA2_HASH_TYPE_512 = 3
+}SHA2_HashType;
+
+typedef enum
+{
+    SHA2_RETURN_BEHAVIOR_CALLBACK = 1,
+    SHA2_RETURN_BEHAVIOR_BLOCKING = 2,
+    SHA2_RETURN_BEHAVIOR_POLLING  = 4
+}SHA2_ReturnBehavior;
+
+typedef struct
+{
+    SHA2_HashType hashType;
+    SHA2_ReturnBehavior returnBehavior;
+    uint32_t timeout;
+    void *custom;
+}SHA2_Params;
+
+typedef struct
+{
+    void *object;
+    void const *hwAttrs;
+}SHA2_Config;
+
+typedef SHA2_Config *SHA2_Handle;
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+void SHA2_init(void);
+void SHA2_Params_init(SHA2_Params *params);
+// One instance, NULL while it is open, as on the target
+SHA2_Handle SHA2_open(uint_least8_t index, const SHA2_Params *params);
+void SHA2_close(SHA2_Handle handle);
+int_fast16_t SHA2_setHashType(SHA2_Handle handle, SHA2_HashType type);
+int_fast16_t SHA2_addData(SHA2_Handle handle, const void *data, size_t length);
+int_fast16_t SHA2_finalize(SHA2_Handle handle, void *digest);
+int_fast16_t SHA2_hashData(SHA2_Handle handle, const void *data, size_t dataLength, void *digest);
+void SHA2_reset(SHA2_Handle handle);
+
+#endif /* ti_drivers_SHA2__include */
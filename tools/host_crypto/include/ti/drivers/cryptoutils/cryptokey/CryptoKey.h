@@ -0,0 +1,81 @@
+/******************************************************************************
+
+@file  CryptoKey.h
+
+@brief Host build of the CryptoKey type, plaintext keys only
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef ti_drivers_cryptoutils_cryptokey_CryptoKey__include
+#define ti_drivers_cryptoutils_cryptokey_CryptoKey__include
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define CryptoKey_PLAINTEXT             0x02
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef uint8_t CryptoKey_Encoding;
+
+typedef struct
+{
+    uint8_t *keyMaterial;
+    uint32_t keyLength;
+}CryptoKey_Plaintext;
+
+typedef struct
+{
+    CryptoKey_Encoding encoding;
+    union
+    {
+        CryptoKey_Plaintext plaintext;
+    }u;
+}CryptoKey;
+
+#endif /* ti_drivers_cryptoutils_cryptokey_CryptoKey__include */
@@ -0,0 +1,89 @@
+/******************************************************************************
+
+@file  ECCParams.h
+
+@brief Host build of the curve parameters, NIST P-256 only
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+#ifndef ti_drivers_cryptoutils_ecc_ECCParams__include
+#define ti_drivers_cryptoutils_ecc_ECCParams__include
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define ECCParams_NISTP256_LENGTH       32
+
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef enum
+{
+    ECCParams_CURVE_TYPE_NONE = 0,
+    ECCParams_CURVE_TYPE_SHORT_WEIERSTRASS_AN3
+}ECCParams_CurveType;
+
+// Big endian parameters of a curve
+typedef struct
+{
+    ECCParams_CurveType curveType;
+    size_t length;
+    const uint8_t *prime;
+    const uint8_t *order;
+    const uint8_t *a;
+    const uint8_t *b;
+    const uint8_t *generatorX;
+    const uint8_t *generatorY;
+    uint8_t cofactor;
+}ECCParams_CurveParams;
+
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+extern const ECCParams_CurveParams ECCParams_NISTP256;
+
+#endif /* ti_drivers_cryptoutils_ecc_ECCParams__include */
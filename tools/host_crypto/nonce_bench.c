@@ -0,0 +1,368 @@
+/******************************************************************************
+
+@file  nonce_bench.c
+
+@brief This file contains the functional checks and the benchmark of the
+       nonce pool on a host
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+/*
+ * Functional checks, throughput and timing of the nonce pool of the
+ * application, built with its host backend:
+ *
+ *   cc -O2 -DNONCE_POOL_HOST -ICentral/app tools/host_crypto/nonce_bench.c \
+ *      Central/app/app_nonce_pool.c -o nonce_bench
+ *   ./nonce_bench [seconds per benchmark]
+ *
+ * NoncePool_consume must take the same time whether the nonce matches,
+ * shares all but the last byte of its tag with an outstanding nonce, was
+ * already used or is unknown. Each case is timed over batches of
+ * NONCE_POOL_WINDOW_SIZE calls and the fastest batch is kept, which
+ * filters out the scheduling noise of the PC.
+ *
+ * The exit status is 1 when a functional check fails.
+ */
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <app_nonce_pool.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+// Batches timed per consume case
+#define BENCH_BATCHES           20000
+
+// Cases of the consume timing
+typedef enum
+{
+    BENCH_CONSUME_MATCH,
+    BENCH_CONSUME_NEAR,
+    BENCH_CONSUME_USED,
+    BENCH_CONSUME_UNKNOWN,
+    BENCH_CONSUME_NUM
+}Bench_consumeCases;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static double Bench_now(void);
+static int Bench_check(const char *pName, int ok);
+static void Bench_get(double seconds);
+static void Bench_consume(void);
+static void Bench_issueWindow(void);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static const char * const benchConsumeNames[BENCH_CONSUME_NUM] =
+{
+    "issued nonce",
+    "tag differs in its last byte",
+    "nonce already used",
+    "unknown nonce"
+};
+
+// Nonces of the replay window, in the order they were issued
+static uint8_t benchWindow[NONCE_POOL_WINDOW_SIZE][NONCE_POOL_NONCE_LEN];
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      main
+ *
+ * @brief   Run the functional checks, then the benchmarks
+ *
+ * @param   argc - argument count
+ * @param   argv - optional seconds per benchmark, default 1
+ *
+ * @return  0, or 1 when a functional check failed
+ */
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    uint8_t nonce[NONCE_POOL_NONCE_LEN];
+    uint8_t other[NONCE_POOL_NONCE_LEN];
+    uint8_t i;
+    int ok;
+    int failed = 0;
+
+    printf("Functional checks\n");
+    failed += Bench_check("Pool filled from the random source", NoncePool_init() == NONCE_POOL_SUCCESS);
+
+    failed += Bench_check("Issued nonce accepted once",
+                          NoncePool_get(nonce) == NONCE_POOL_SUCCESS &&
+                          NoncePool_consume(nonce) == NONCE_POOL_SUCCESS);
+    failed += Bench_check("Replayed nonce rejected", NoncePool_consume(nonce) == NONCE_POOL_REPLAY);
+
+    NoncePool_get(nonce);
+    memcpy(other, nonce, sizeof(other));
+    other[NONCE_POOL_TAG_LEN - 1] ^= 0x01;
+    failed += Bench_check("Nonce with another tag rejected", NoncePool_consume(other) == NONCE_POOL_REPLAY);
+    failed += Bench_check("Nonce still accepted after a bad one", NoncePool_consume(nonce) == NONCE_POOL_SUCCESS);
+
+    // The oldest nonce leaves the window when a newer one takes its slot
+    NoncePool_get(nonce);
+    for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+    {
+        NoncePool_get(benchWindow[i]);
+    }
+    failed += Bench_check("Nonce out of the window rejected", NoncePool_consume(nonce) == NONCE_POOL_REPLAY);
+    ok = 1;
+    for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+    {
+        ok &= (NoncePool_consume(benchWindow[i]) == NONCE_POOL_SUCCESS);
+    }
+    failed += Bench_check("Every nonce of the window accepted", ok);
+
+    ok = 1;
+    for (i = 0; i < 2 * NONCE_POOL_SIZE; i++)
+    {
+        ok &= (NoncePool_get(nonce) == NONCE_POOL_SUCCESS);
+    }
+    failed += Bench_check("Empty pool falls back to the random source", ok);
+
+    printf("\nThroughput, %.1f s each\n", seconds);
+    Bench_get(seconds);
+
+    printf("\nNoncePool_consume timing, fastest of %d batches of %d calls\n", BENCH_BATCHES,
+           NONCE_POOL_WINDOW_SIZE);
+    Bench_consume();
+
+    return failed ? 1 : 0;
+}
+
+/*********************************************************************
+ * @fn      Bench_now
+ *
+ * @brief   Monotonic time
+ *
+ * @return  seconds
+ */
+static double Bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*********************************************************************
+ * @fn      Bench_check
+ *
+ * @brief   Print the result of a functional check
+ *
+ * @param   pName - check name
+ * @param   ok - result
+ *
+ * @return  0 when ok, 1 otherwise
+ */
+static int Bench_check(const char *pName, int ok)
+{
+    printf("  %-48s %s\n", pName, ok ? "ok" : "FAILED");
+
+    return ok ? 0 : 1;
+}
+
+/*********************************************************************
+ * @fn      Bench_get
+ *
+ * @brief   NoncePool_get from a full pool, refilled between batches,
+ *          then from an empty pool, then NoncePool_get followed by
+ *          NoncePool_consume
+ *
+ * @param   seconds - duration of each case
+ *
+ * @return  none
+ */
+static void Bench_get(double seconds)
+{
+    uint8_t nonce[NONCE_POOL_NONCE_LEN];
+    double start = Bench_now();
+    double elapsed = 0;
+    double batch;
+    unsigned long n = 0;
+    uint8_t i;
+
+    // The refill runs outside of the messages on the target, it is not
+    // part of the timed calls
+    do
+    {
+        NoncePool_fill();
+        batch = Bench_now();
+        for (i = 0; i < NONCE_POOL_SIZE; i++)
+        {
+            NoncePool_get(nonce);
+        }
+        elapsed += Bench_now() - batch;
+        n += NONCE_POOL_SIZE;
+    } while (Bench_now() - start < seconds);
+    printf("  %-34s %10.0f get/s %8.3f us\n", "NoncePool_get, from the pool", n / elapsed, elapsed / n * 1e6);
+
+    // Pool empty: every call reads the random source
+    start = Bench_now();
+    n = 0;
+    do
+    {
+        NoncePool_get(nonce);
+        n++;
+        elapsed = Bench_now() - start;
+    } while (elapsed < seconds);
+    printf("  %-34s %10.0f get/s %8.3f us\n", "NoncePool_get, random source", n / elapsed, elapsed / n * 1e6);
+
+    start = Bench_now();
+    n = 0;
+    do
+    {
+        NoncePool_get(nonce);
+        if (NoncePool_consume(nonce) != NONCE_POOL_SUCCESS)
+        {
+            printf("  issued nonce rejected\n");
+            return;
+        }
+        n++;
+        elapsed = Bench_now() - start;
+    } while (elapsed < seconds);
+    printf("  %-34s %10.0f pair/s %7.3f us\n", "NoncePool_get + consume", n / elapsed, elapsed / n * 1e6);
+}
+
+/*********************************************************************
+ * @fn      Bench_consume
+ *
+ * @brief   Time NoncePool_consume for each Bench_consumeCases. The
+ *          window is issued again before every batch, untimed.
+ *
+ * @return  none
+ */
+static void Bench_consume(void)
+{
+    uint8_t probe[NONCE_POOL_WINDOW_SIZE][NONCE_POOL_NONCE_LEN];
+    double best[BENCH_CONSUME_NUM];
+    double fastest;
+    double slowest;
+    double start;
+    double elapsed;
+    volatile uint8_t status;
+    uint8_t c;
+    uint8_t i;
+    int b;
+
+    for (c = 0; c < BENCH_CONSUME_NUM; c++)
+    {
+        best[c] = 1e9;
+    }
+
+    // The cases take turns, so a change of CPU frequency hits them all
+    for (b = 0; b < BENCH_BATCHES; b++)
+    {
+        for (c = 0; c < BENCH_CONSUME_NUM; c++)
+        {
+            Bench_issueWindow();
+            memcpy(probe, benchWindow, sizeof(probe));
+            for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+            {
+                if (c == BENCH_CONSUME_NEAR)
+                {
+                    probe[i][NONCE_POOL_TAG_LEN - 1] ^= 0x01;
+                }
+                else if (c == BENCH_CONSUME_USED)
+                {
+                    NoncePool_consume(probe[i]);
+                }
+                else if (c == BENCH_CONSUME_UNKNOWN)
+                {
+                    memset(probe[i], (int)i, NONCE_POOL_NONCE_LEN);
+                }
+            }
+
+            start = Bench_now();
+            for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+            {
+                status = NoncePool_consume(probe[i]);
+            }
+            elapsed = Bench_now() - start;
+            (void)status;
+
+            if (elapsed < best[c])
+            {
+                best[c] = elapsed;
+            }
+        }
+    }
+
+    fastest = best[0];
+    slowest = best[0];
+    for (c = 0; c < BENCH_CONSUME_NUM; c++)
+    {
+        printf("  %-34s %8.1f ns\n", benchConsumeNames[c], best[c] / NONCE_POOL_WINDOW_SIZE * 1e9);
+        fastest = (best[c] < fastest) ? best[c] : fastest;
+        slowest = (best[c] > slowest) ? best[c] : slowest;
+    }
+    printf("  %-34s %8.1f ns (%.0f %%)\n", "spread", (slowest - fastest) / NONCE_POOL_WINDOW_SIZE * 1e9,
+           (slowest - fastest) / fastest * 100);
+}
+
+/*********************************************************************
+ * @fn      Bench_issueWindow
+ *
+ * @brief   Issue a full window of nonces, kept in benchWindow
+ *
+ * @return  none
+ */
+static void Bench_issueWindow(void)
+{
+    uint8_t i;
+
+    NoncePool_fill();
+    for (i = 0; i < NONCE_POOL_WINDOW_SIZE; i++)
+    {
+        NoncePool_get(benchWindow[i]);
+    }
+}
@@ -0,0 +1,356 @@
+/******************************************************************************
+
+@file  sha2_host.c
+
+@brief This file contains a software SHA-256 behind the SHA2 driver
+       interface, for host builds
+
+Group: WCS, BTS
+Target Device: host
+
+******************************************************************************
+
+ Copyright (c) 2022-2024, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+******************************************************************************
+
+
+*****************************************************************************/
+
+//*****************************************************************************
+//! Includes
+//*****************************************************************************
+#include <string.h>
+#include <ti/drivers/SHA2.h>
+
+//*****************************************************************************
+//! Defines
+//*****************************************************************************
+#define ROTR(x, n)      (((x) >> (n)) | ((x) << (32 - (n))))
+//*****************************************************************************
+//! Typedefs
+//*****************************************************************************
+typedef struct
+{
+    bool isOpen;
+    uint32_t state[8];
+    uint8_t block[SHA2_BLOCK_SIZE_BYTES_256];
+    uint16_t blockLen;
+    uint64_t totalLen;
+}SHA2Host_Object;
+//*****************************************************************************
+//! Prototypes
+//*****************************************************************************
+static void SHA2Host_compress(uint32_t *state, const uint8_t *block);
+//*****************************************************************************
+//! Globals
+//*****************************************************************************
+static const uint32_t sha2HostK[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t sha2HostInit[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static SHA2Host_Object sha2HostObject;
+static SHA2_Config sha2HostConfig = {&sha2HostObject, NULL};
+
+//*****************************************************************************
+//! Functions
+//*****************************************************************************
+
+/*********************************************************************
+ * @fn      SHA2_init
+ *
+ * @brief   Nothing to set up on the host
+ *
+ * @return  none
+ */
+void SHA2_init(void)
+{
+}
+
+/*********************************************************************
+ * @fn      SHA2_Params_init
+ *
+ * @brief   Default parameters, SHA-256, blocking
+ *
+ * @param   params - parameters to set
+ *
+ * @return  none
+ */
+void SHA2_Params_init(SHA2_Params *params)
+{
+    params->hashType = SHA2_HASH_TYPE_256;
+    params->returnBehavior = SHA2_RETURN_BEHAVIOR_BLOCKING;
+    params->timeout = 0xFFFFFFFF;
+    params->custom = NULL;
+}
+
+/*********************************************************************
+ * @fn      SHA2_open
+ *
+ * @brief   Open the only instance, SHA-256 is the only hash type
+ *
+ * @param   index - ignored
+ * @param   params - NULL or SHA2_HASH_TYPE_256
+ *
+ * @return  the handle, or NULL when it is already open
+ */
+SHA2_Handle SHA2_open(uint_least8_t index, const SHA2_Params *params)
+{
+    (void)index;
+
+    if (sha2HostObject.isOpen || (params != NULL && params->hashType != SHA2_HASH_TYPE_256))
+    {
+        return NULL;
+    }
+
+    sha2HostObject.isOpen = true;
+    SHA2_reset(&sha2HostConfig);
+
+    return &sha2HostConfig;
+}
+
+/*********************************************************************
+ * @fn      SHA2_close
+ *
+ * @brief   Close the instance
+ *
+ * @param   handle - from SHA2_open
+ *
+ * @return  none
+ */
+void SHA2_close(SHA2_Handle handle)
+{
+    ((SHA2Host_Object *)handle->object)->isOpen = false;
+}
+
+/*********************************************************************
+ * @fn      SHA2_setHashType
+ *
+ * @brief   Only SHA-256 is supported
+ *
+ * @param   handle - from SHA2_open
+ * @param   type - hash type
+ *
+ * @return  SHA2_STATUS_SUCCESS or SHA2_STATUS_UNSUPPORTED
+ */
+int_fast16_t SHA2_setHashType(SHA2_Handle handle, SHA2_HashType type)
+{
+    (void)handle;
+
+    return (type == SHA2_HASH_TYPE_256) ? SHA2_STATUS_SUCCESS : SHA2_STATUS_UNSUPPORTED;
+}
+
+/*********************************************************************
+ * @fn      SHA2_reset
+ *
+ * @brief   Drop the segmented operation in progress
+ *
+ * @param   handle - from SHA2_open
+ *
+ * @return  none
+ */
+void SHA2_reset(SHA2_Handle handle)
+{
+    SHA2Host_Object *pObj = handle->object;
+
+    memcpy(pObj->state, sha2HostInit, sizeof(pObj->state));
+    pObj->blockLen = 0;
+    pObj->totalLen = 0;
+}
+
+/*********************************************************************
+ * @fn      SHA2_addData
+ *
+ * @brief   Hash more data of a segmented operation
+ *
+ * @param   handle - from SHA2_open
+ * @param   data - data to hash
+ * @param   length - length of the data
+ *
+ * @return  SHA2_STATUS_SUCCESS
+ */
+int_fast16_t SHA2_addData(SHA2_Handle handle, const void *data, size_t length)
+{
+    SHA2Host_Object *pObj = handle->object;
+    const uint8_t *pData = data;
+    size_t n;
+
+    pObj->totalLen += length;
+    while (length > 0)
+    {
+        if (pObj->blockLen == 0 && length >= SHA2_BLOCK_SIZE_BYTES_256)
+        {
+            SHA2Host_compress(pObj->state, pData);
+            pData += SHA2_BLOCK_SIZE_BYTES_256;
+            length -= SHA2_BLOCK_SIZE_BYTES_256;
+            continue;
+        }
+
+        n = SHA2_BLOCK_SIZE_BYTES_256 - pObj->blockLen;
+        if (n > length)
+        {
+            n = length;
+        }
+        memcpy(&pObj->block[pObj->blockLen], pData, n);
+        pObj->blockLen += n;
+        pData += n;
+        length -= n;
+
+        if (pObj->blockLen == SHA2_BLOCK_SIZE_BYTES_256)
+        {
+            SHA2Host_compress(pObj->state, pObj->block);
+            pObj->blockLen = 0;
+        }
+    }
+
+    return SHA2_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      SHA2_finalize
+ *
+ * @brief   Pad the segmented operation and output its digest, the
+ *          handle is then ready for a new operation
+ *
+ * @param   handle - from SHA2_open
+ * @param   digest - SHA2_DIGEST_LENGTH_BYTES_256 bytes output
+ *
+ * @return  SHA2_STATUS_SUCCESS
+ */
+int_fast16_t SHA2_finalize(SHA2_Handle handle, void *digest)
+{
+    SHA2Host_Object *pObj = handle->object;
+    uint64_t bitLen = pObj->totalLen * 8;
+    uint8_t *pDigest = digest;
+    uint8_t i;
+
+    pObj->block[pObj->blockLen++] = 0x80;
+    if (pObj->blockLen > SHA2_BLOCK_SIZE_BYTES_256 - 8)
+    {
+        memset(&pObj->block[pObj->blockLen], 0, SHA2_BLOCK_SIZE_BYTES_256 - pObj->blockLen);
+        SHA2Host_compress(pObj->state, pObj->block);
+        pObj->blockLen = 0;
+    }
+    memset(&pObj->block[pObj->blockLen], 0, SHA2_BLOCK_SIZE_BYTES_256 - 8 - pObj->blockLen);
+    for (i = 0; i < 8; i++)
+    {
+        pObj->block[SHA2_BLOCK_SIZE_BYTES_256 - 1 - i] = (uint8_t)(bitLen >> (8 * i));
+    }
+    SHA2Host_compress(pObj->state, pObj->block);
+
+    for (i = 0; i < 8; i++)
+    {
+        pDigest[4 * i]     = (uint8_t)(pObj->state[i] >> 24);
+        pDigest[4 * i + 1] = (uint8_t)(pObj->state[i] >> 16);
+        pDigest[4 * i + 2] = (uint8_t)(pObj->state[i] >> 8);
+        pDigest[4 * i + 3] = (uint8_t)pObj->state[i];
+    }
+
+    SHA2_reset(handle);
+
+    return SHA2_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      SHA2_hashData
+ *
+ * @brief   SHA-256 of a buffer in one call
+ *
+ * @param   handle - from SHA2_open
+ * @param   data - data to hash
+ * @param   dataLength - length of the data
+ * @param   digest - SHA2_DIGEST_LENGTH_BYTES_256 bytes output
+ *
+ * @return  SHA2_STATUS_SUCCESS
+ */
+int_fast16_t SHA2_hashData(SHA2_Handle handle, const void *data, size_t dataLength, void *digest)
+{
+    SHA2_reset(handle);
+    SHA2_addData(handle, data, dataLength);
+
+    return SHA2_finalize(handle, digest);
+}
+
+/*********************************************************************
+ * @fn      SHA2Host_compress
+ *
+ * @brief   SHA-256 compression of one block (FIPS 180-4)
+ *
+ * @param   state - hash state, updated
+ * @param   block - SHA2_BLOCK_SIZE_BYTES_256 bytes
+ *
+ * @return  none
+ */
+static void SHA2Host_compress(uint32_t *state, const uint8_t *block)
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t t1, t2;
+    uint8_t i;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    }
+    for (i = 16; i < 64; i++)
+    {
+        w[i] = (ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7] +
+               (ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+    }
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    for (i = 0; i < 64; i++)
+    {
+        t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha2HostK[i] + w[i];
+        t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}